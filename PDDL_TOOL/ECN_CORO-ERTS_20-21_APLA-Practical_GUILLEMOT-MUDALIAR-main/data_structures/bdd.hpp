@@ -0,0 +1,585 @@
+#ifndef BDD_HPP
+#define BDD_HPP
+
+#include <algorithm>
+#include <cassert>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_set>
+#include <vector>
+
+class bdd;
+
+/**
+ * Manager of reduced ordered binary decision diagrams over nb_vars variables, the variable 0
+ * being at the top of the diagrams.
+ * The nodes are stored in a single array and made unique by a hash table chained through the
+ * nodes, the results of the operations are memorized in a lossy direct-mapped cache.
+ * The nodes which are not reachable from a referenced root are reclaimed by a mark and sweep
+ * garbage collection, run at the beginning of an operation when the number of nodes exceeds
+ * a threshold (the threshold is doubled when a collection does not free half of the nodes).
+ * Diagrams are normally manipulated through bdd handles, which hold a reference on their root.
+*/
+class bdd_manager
+{
+	friend class bdd;
+
+	public:
+		static constexpr unsigned int zero = 0;
+		static constexpr unsigned int one = 1;
+
+		bdd_manager(unsigned int nb_vars, unsigned int cache_bits = 18, std::size_t gc_threshold = 1 << 20):
+			m_nb_vars(nb_vars), m_free(0), m_nb_free(0), m_gc_threshold(gc_threshold),
+			m_peak(2), m_gc_runs(0), m_cache(std::size_t(1) << cache_bits)
+		{
+			// The terminals are above every variable in the order
+			m_nodes.push_back({nb_vars, 0, 0, 0});
+			m_nodes.push_back({nb_vars, 1, 1, 0});
+			m_refs.assign(2, 1);
+			m_buckets.assign(1 << 12, 0);
+
+			for (cache_entry &e : m_cache)
+				e.op = none;
+		}
+
+		bdd_manager(const bdd_manager &other) = delete;
+		bdd_manager& operator=(const bdd_manager &other) = delete;
+
+		unsigned int nb_vars(void) const { return m_nb_vars; }
+
+		// Number of nodes allocated, including the dead nodes not collected yet
+		std::size_t nb_nodes(void) const { return m_nodes.size()-m_nb_free; }
+
+		// Largest number of nodes allocated at the same time
+		std::size_t peak_nodes(void) const { return m_peak; }
+
+		unsigned int gc_runs(void) const { return m_gc_runs; }
+
+		/**
+		 * Registers a renaming of the variables, which must preserve the order of the variables
+		 * of the diagrams it is applied to.
+		 * @return The identifier of the renaming, see bdd::rename().
+		*/
+		unsigned int add_renaming(const std::vector<unsigned int> &mapping)
+		{
+			assert(("A renaming maps every variable.", mapping.size() == m_nb_vars));
+			m_renamings.push_back(mapping);
+			return m_renamings.size()-1;
+		}
+
+		// Reclaims the nodes which are not reachable from a referenced root
+		void gc(void)
+		{
+			unsigned int n;
+			std::vector<bool> marked(m_nodes.size(), false);
+			std::vector<unsigned int> stack;
+
+			m_gc_runs++;
+
+			for (n = 0; n < m_nodes.size(); ++n)
+			{
+				if (m_refs[n] > 0)
+					stack.push_back(n);
+			}
+
+			while (!stack.empty())
+			{
+				n = stack.back();
+				stack.pop_back();
+
+				if (marked[n])
+					continue;
+
+				marked[n] = true;
+				if (n > one)
+				{
+					stack.push_back(m_nodes[n].low);
+					stack.push_back(m_nodes[n].high);
+				}
+			}
+
+			// Rebuilding the unique table and the free list
+			std::fill(m_buckets.begin(), m_buckets.end(), 0);
+			m_free = 0;
+			m_nb_free = 0;
+
+			for (n = m_nodes.size()-1; n > one; --n)
+			{
+				if (marked[n])
+				{
+					m_nodes[n].next = m_buckets[bucket(m_nodes[n].var, m_nodes[n].low, m_nodes[n].high)];
+					m_buckets[bucket(m_nodes[n].var, m_nodes[n].low, m_nodes[n].high)] = n;
+				}
+				else
+				{
+					m_nodes[n].var = free_var;
+					m_nodes[n].next = m_free;
+					m_free = n;
+					m_nb_free++;
+				}
+			}
+
+			for (cache_entry &e : m_cache)
+				e.op = none;
+		}
+
+	private:
+		enum operation { none, op_and, op_or, op_xor, op_exists, op_and_exists, op_rename };
+
+		static constexpr unsigned int free_var = UINT_MAX;
+
+		struct node
+		{
+			unsigned int var;
+			unsigned int low;
+			unsigned int high;
+
+			// Next node in the bucket of the unique table, or in the free list
+			unsigned int next;
+		};
+
+		struct cache_entry
+		{
+			operation op;
+			unsigned int a;
+			unsigned int b;
+			unsigned int c;
+			unsigned int result;
+		};
+
+		unsigned int m_nb_vars;
+		std::vector<node> m_nodes;
+
+		// Number of references held on each node by bdd handles
+		std::vector<unsigned int> m_refs;
+
+		std::vector<unsigned int> m_buckets;
+		unsigned int m_free;
+		std::size_t m_nb_free;
+		std::size_t m_gc_threshold;
+		std::size_t m_peak;
+		unsigned int m_gc_runs;
+		std::vector<cache_entry> m_cache;
+		std::vector<std::vector<unsigned int>> m_renamings;
+
+		void ref(unsigned int n) { m_refs[n]++; }
+
+		void deref(unsigned int n)
+		{
+			assert(("Dereferencing a node which is not referenced.", m_refs[n] > 0));
+			m_refs[n]--;
+		}
+
+		unsigned int var(unsigned int n) const { return m_nodes[n].var; }
+
+		// Final mix of splitmix64
+		static std::uint64_t mix(std::uint64_t x)
+		{
+			x = (x ^ (x >> 30))*0xbf58476d1ce4e5b9ULL;
+			x = (x ^ (x >> 27))*0x94d049bb133111ebULL;
+			return x ^ (x >> 31);
+		}
+
+		std::size_t bucket(unsigned int v, unsigned int low, unsigned int high) const
+		{
+			return mix(((std::uint64_t)v << 40) ^ ((std::uint64_t)low << 20) ^ high ^ ((std::uint64_t)low >> 44))
+			       & (m_buckets.size()-1);
+		}
+
+		std::size_t slot(operation op, unsigned int a, unsigned int b, unsigned int c) const
+		{
+			return mix(mix(((std::uint64_t)op << 32) ^ a) ^ ((std::uint64_t)b << 32) ^ c) & (m_cache.size()-1);
+		}
+
+		bool lookup(operation op, unsigned int a, unsigned int b, unsigned int c, unsigned int &result) const
+		{
+			const cache_entry &e = m_cache[slot(op, a, b, c)];
+
+			if (e.op != op || e.a != a || e.b != b || e.c != c)
+				return false;
+
+			result = e.result;
+			return true;
+		}
+
+		unsigned int store(operation op, unsigned int a, unsigned int b, unsigned int c, unsigned int result)
+		{
+			m_cache[slot(op, a, b, c)] = {op, a, b, c, result};
+			return result;
+		}
+
+		// Called before the operations on handles, when no intermediate result is unreferenced
+		void maybe_gc(void)
+		{
+			if (nb_nodes() < m_gc_threshold)
+				return;
+
+			gc();
+
+			if (nb_nodes() > m_gc_threshold/2)
+				m_gc_threshold *= 2;
+		}
+
+		void grow_buckets(void)
+		{
+			m_buckets.assign(2*m_buckets.size(), 0);
+
+			for (unsigned int n = one+1; n < m_nodes.size(); ++n)
+			{
+				if (m_nodes[n].var == free_var)
+					continue;
+
+				m_nodes[n].next = m_buckets[bucket(m_nodes[n].var, m_nodes[n].low, m_nodes[n].high)];
+				m_buckets[bucket(m_nodes[n].var, m_nodes[n].low, m_nodes[n].high)] = n;
+			}
+		}
+
+		// The unique node (v, low, high)
+		unsigned int make(unsigned int v, unsigned int low, unsigned int high)
+		{
+			unsigned int n;
+
+			if (low == high)
+				return low;
+
+			for (n = m_buckets[bucket(v, low, high)]; n != 0; n = m_nodes[n].next)
+			{
+				if (m_nodes[n].var == v && m_nodes[n].low == low && m_nodes[n].high == high)
+					return n;
+			}
+
+			if (nb_nodes() > 2*m_buckets.size())
+				grow_buckets();
+
+			if (m_free != 0)
+			{
+				n = m_free;
+				m_free = m_nodes[n].next;
+				m_nb_free--;
+				m_nodes[n] = {v, low, high, 0};
+				m_refs[n] = 0;
+			}
+			else
+			{
+				n = m_nodes.size();
+				m_nodes.push_back({v, low, high, 0});
+				m_refs.push_back(0);
+			}
+
+			m_nodes[n].next = m_buckets[bucket(v, low, high)];
+			m_buckets[bucket(v, low, high)] = n;
+			m_peak = std::max(m_peak, nb_nodes());
+
+			return n;
+		}
+
+		// Cofactors of n with respect to the variable v, which is not below the variable of n
+		unsigned int low(unsigned int n, unsigned int v) const { return var(n) == v ? m_nodes[n].low : n; }
+		unsigned int high(unsigned int n, unsigned int v) const { return var(n) == v ? m_nodes[n].high : n; }
+
+		unsigned int apply(operation op, unsigned int a, unsigned int b)
+		{
+			unsigned int v, r0, r1, result;
+
+			// Terminal cases
+			if (a <= one && b <= one)
+			{
+				if (op == op_and)
+					return a & b;
+				if (op == op_or)
+					return a | b;
+				return a ^ b;
+			}
+
+			if (op == op_and && (a == zero || b == zero))
+				return zero;
+			if (op == op_or && (a == one || b == one))
+				return one;
+			if ((op == op_and || op == op_or) && a == b)
+				return a;
+			if (op == op_xor && a == b)
+				return zero;
+			if ((op == op_and && a == one) || (op != op_and && a == zero))
+				return b;
+			if ((op == op_and && b == one) || (op != op_and && b == zero))
+				return a;
+
+			// The operations are commutative
+			if (a > b)
+				std::swap(a, b);
+
+			if (lookup(op, a, b, 0, result))
+				return result;
+
+			v = std::min(var(a), var(b));
+			r0 = apply(op, low(a, v), low(b, v));
+			r1 = apply(op, high(a, v), high(b, v));
+
+			return store(op, a, b, 0, make(v, r0, r1));
+		}
+
+		// Skips the variables of the cube which are above v
+		unsigned int skip(unsigned int cube, unsigned int v) const
+		{
+			while (cube != one && var(cube) < v)
+				cube = m_nodes[cube].high;
+
+			return cube;
+		}
+
+		unsigned int exists(unsigned int a, unsigned int cube)
+		{
+			unsigned int v, r0, r1, result;
+
+			if (a <= one)
+				return a;
+
+			cube = skip(cube, var(a));
+			if (cube == one)
+				return a;
+
+			if (lookup(op_exists, a, cube, 0, result))
+				return result;
+
+			v = var(a);
+			if (var(cube) == v)
+			{
+				r0 = exists(m_nodes[a].low, m_nodes[cube].high);
+				r1 = r0 == one ? one : exists(m_nodes[a].high, m_nodes[cube].high);
+				result = apply(op_or, r0, r1);
+			}
+			else
+			{
+				r0 = exists(m_nodes[a].low, cube);
+				r1 = exists(m_nodes[a].high, cube);
+				result = make(v, r0, r1);
+			}
+
+			return store(op_exists, a, cube, 0, result);
+		}
+
+		// Existential quantification of the variables of cube in the conjunction of a and b
+		unsigned int and_exists(unsigned int a, unsigned int b, unsigned int cube)
+		{
+			unsigned int v, r0, r1, result;
+
+			if (a == zero || b == zero)
+				return zero;
+			if (a == one && b == one)
+				return one;
+			if (a == one || a == b)
+				return exists(b, cube);
+			if (b == one)
+				return exists(a, cube);
+
+			if (a > b)
+				std::swap(a, b);
+
+			v = std::min(var(a), var(b));
+			cube = skip(cube, v);
+			if (cube == one)
+				return apply(op_and, a, b);
+
+			if (lookup(op_and_exists, a, b, cube, result))
+				return result;
+
+			if (var(cube) == v)
+			{
+				r0 = and_exists(low(a, v), low(b, v), m_nodes[cube].high);
+				r1 = r0 == one ? one : and_exists(high(a, v), high(b, v), m_nodes[cube].high);
+				result = apply(op_or, r0, r1);
+			}
+			else
+			{
+				r0 = and_exists(low(a, v), low(b, v), cube);
+				r1 = and_exists(high(a, v), high(b, v), cube);
+				result = make(v, r0, r1);
+			}
+
+			return store(op_and_exists, a, b, cube, result);
+		}
+
+		unsigned int rename(unsigned int a, unsigned int renaming)
+		{
+			unsigned int r0, r1, result;
+
+			if (a <= one)
+				return a;
+
+			if (lookup(op_rename, a, renaming, 0, result))
+				return result;
+
+			r0 = rename(m_nodes[a].low, renaming);
+			r1 = rename(m_nodes[a].high, renaming);
+
+			assert(("The renaming does not preserve the order of the variables.",
+				m_renamings[renaming][var(a)] < var(r0) && m_renamings[renaming][var(a)] < var(r1)));
+
+			return store(op_rename, a, renaming, 0, make(m_renamings[renaming][var(a)], r0, r1));
+		}
+};
+
+/**
+ * Handle on a diagram of a bdd_manager, which keeps its nodes alive.
+*/
+class bdd
+{
+	public:
+		bdd(void): m_manager(nullptr), m_root(bdd_manager::zero) {}
+
+		bdd(bdd_manager *manager, unsigned int root): m_manager(manager), m_root(root)
+		{
+			m_manager->ref(m_root);
+		}
+
+		bdd(const bdd &other): m_manager(other.m_manager), m_root(other.m_root)
+		{
+			if (m_manager)
+				m_manager->ref(m_root);
+		}
+
+		~bdd(void)
+		{
+			if (m_manager)
+				m_manager->deref(m_root);
+		}
+
+		bdd& operator=(const bdd &other)
+		{
+			if (other.m_manager)
+				other.m_manager->ref(other.m_root);
+			if (m_manager)
+				m_manager->deref(m_root);
+
+			m_manager = other.m_manager;
+			m_root = other.m_root;
+
+			return *this;
+		}
+
+		// Constant diagrams and literals
+		static bdd constant(bdd_manager &manager, bool value)
+		{
+			return bdd(&manager, value ? bdd_manager::one : bdd_manager::zero);
+		}
+
+		static bdd literal(bdd_manager &manager, unsigned int v, bool value = true)
+		{
+			manager.maybe_gc();
+			return bdd(&manager, value ? manager.make(v, bdd_manager::zero, bdd_manager::one)
+						   : manager.make(v, bdd_manager::one, bdd_manager::zero));
+		}
+
+		// Conjunction of the positive literals of the variables (sorted in increasing order)
+		static bdd cube(bdd_manager &manager, const std::vector<unsigned int> &vars)
+		{
+			unsigned int root = bdd_manager::one;
+
+			manager.maybe_gc();
+			for (unsigned int i = vars.size(); i > 0; --i)
+				root = manager.make(vars[i-1], bdd_manager::zero, root);
+
+			return bdd(&manager, root);
+		}
+
+		bool is_zero(void) const { return m_root == bdd_manager::zero; }
+		bool is_one(void) const { return m_root == bdd_manager::one; }
+
+		bool operator==(const bdd &other) const { return m_root == other.m_root; }
+		bool operator!=(const bdd &other) const { return m_root != other.m_root; }
+
+		bdd operator&(const bdd &other) const { return binary(bdd_manager::op_and, other); }
+		bdd operator|(const bdd &other) const { return binary(bdd_manager::op_or, other); }
+		bdd operator^(const bdd &other) const { return binary(bdd_manager::op_xor, other); }
+		bdd operator~(void) const { return binary(bdd_manager::op_xor, constant(*m_manager, true)); }
+
+		// Set difference
+		bdd operator-(const bdd &other) const { return *this & ~other; }
+
+		bdd& operator&=(const bdd &other) { return *this = *this & other; }
+		bdd& operator|=(const bdd &other) { return *this = *this | other; }
+
+		// Existential quantification of the variables of a cube
+		bdd exists(const bdd &cube) const
+		{
+			m_manager->maybe_gc();
+			return bdd(m_manager, m_manager->exists(m_root, cube.m_root));
+		}
+
+		// Relational product: existential quantification of cube in the conjunction
+		bdd and_exists(const bdd &other, const bdd &cube) const
+		{
+			m_manager->maybe_gc();
+			return bdd(m_manager, m_manager->and_exists(m_root, other.m_root, cube.m_root));
+		}
+
+		// Renaming registered with bdd_manager::add_renaming()
+		bdd rename(unsigned int renaming) const
+		{
+			m_manager->maybe_gc();
+			return bdd(m_manager, m_manager->rename(m_root, renaming));
+		}
+
+		// Number of nodes of the diagram, terminals included
+		unsigned int node_count(void) const
+		{
+			unsigned int n;
+			std::vector<unsigned int> stack(1, m_root);
+			std::unordered_set<unsigned int> visited;
+
+			while (!stack.empty())
+			{
+				n = stack.back();
+				stack.pop_back();
+
+				if (!visited.insert(n).second)
+					continue;
+
+				if (n > bdd_manager::one)
+				{
+					stack.push_back(m_manager->m_nodes[n].low);
+					stack.push_back(m_manager->m_nodes[n].high);
+				}
+			}
+
+			return visited.size();
+		}
+
+		/**
+		 * @return An assignment of all the variables satisfying the diagram, the variables
+		 *	   which do not appear on the chosen path are false. The diagram must not be zero.
+		*/
+		std::vector<bool> pick_one(void) const
+		{
+			unsigned int n = m_root;
+			std::vector<bool> to_return(m_manager->nb_vars(), false);
+
+			assert(("No assignment satisfies the zero diagram.", !is_zero()));
+
+			while (n > bdd_manager::one)
+			{
+				if (m_manager->m_nodes[n].low != bdd_manager::zero)
+					n = m_manager->m_nodes[n].low;
+				else
+				{
+					to_return[m_manager->var(n)] = true;
+					n = m_manager->m_nodes[n].high;
+				}
+			}
+
+			return to_return;
+		}
+
+	private:
+		bdd_manager *m_manager;
+		unsigned int m_root;
+
+		bdd binary(bdd_manager::operation op, const bdd &other) const
+		{
+			m_manager->maybe_gc();
+			return bdd(m_manager, m_manager->apply(op, m_root, other.m_root));
+		}
+};
+
+#endif // BDD_HPP
@@ -0,0 +1,53 @@
+#ifndef BIT_MATRIX_HPP
+#define BIT_MATRIX_HPP
+
+#include "bitset.hpp"
+
+#include <vector>
+
+/**
+ * Square matrix of bits, used as a symmetric binary relation over size() items (for instance
+ * the mutex pairs of a layer of a planning graph). Each row is a bitset, so the items related
+ * to an item are enumerated with bitset::next().
+*/
+class bit_matrix
+{
+	public:
+		bit_matrix(unsigned int size = 0): m_rows(size, bitset(size)) {}
+
+		unsigned int size(void) const { return m_rows.size(); }
+
+		bool test(unsigned int i, unsigned int j) const { return m_rows[i].test(j); }
+
+		const bitset& row(unsigned int i) const { return m_rows[i]; }
+
+		// Sets (i, j) and (j, i)
+		void set(unsigned int i, unsigned int j)
+		{
+			m_rows[i].set(j);
+			m_rows[j].set(i);
+		}
+
+		// Resets (i, j) and (j, i)
+		void reset(unsigned int i, unsigned int j)
+		{
+			m_rows[i].reset(j);
+			m_rows[j].reset(i);
+		}
+
+		// Number of pairs {i, j} set, with i != j
+		unsigned long long nb_pairs(void) const
+		{
+			unsigned long long to_return = 0;
+
+			for (unsigned int i = 0; i < m_rows.size(); ++i)
+				to_return += m_rows[i].count()-m_rows[i].test(i);
+
+			return to_return/2;
+		}
+
+	private:
+		std::vector<bitset> m_rows;
+};
+
+#endif // BIT_MATRIX_HPP
@@ -0,0 +1,109 @@
+#ifndef BITSET_HPP
+#define BITSET_HPP
+
+#include <cassert>
+#include <cstdint>
+#include <vector>
+
+/**
+ * Bitset whose size is given at runtime, stored in 64-bit words.
+*/
+class bitset
+{
+	public:
+		bitset(unsigned int size = 0): m_words((size+63)/64, 0), m_size(size) {}
+
+		unsigned int size(void) const { return m_size; }
+
+		bool test(unsigned int index) const { return (m_words[index/64] >> (index%64)) & 1; }
+
+		void set(unsigned int index) { m_words[index/64] |= 1ULL << (index%64); }
+
+		void reset(unsigned int index) { m_words[index/64] &= ~(1ULL << (index%64)); }
+
+		// Sets all the bits to 0
+		void clear(void)
+		{
+			for (std::uint64_t &w : m_words)
+				w = 0;
+		}
+
+		unsigned int count(void) const
+		{
+			unsigned int to_return = 0;
+
+			for (std::uint64_t w : m_words)
+				to_return += __builtin_popcountll(w);
+
+			return to_return;
+		}
+
+		// True if the two bitsets have a bit set in common
+		bool intersects(const bitset &other) const
+		{
+			assert(("Bitsets of different sizes.", m_size == other.m_size));
+
+			for (unsigned int i = 0; i < m_words.size(); ++i)
+			{
+				if (m_words[i] & other.m_words[i])
+					return true;
+			}
+
+			return false;
+		}
+
+		bitset& operator|=(const bitset &other)
+		{
+			assert(("Bitsets of different sizes.", m_size == other.m_size));
+
+			for (unsigned int i = 0; i < m_words.size(); ++i)
+				m_words[i] |= other.m_words[i];
+
+			return *this;
+		}
+
+		bitset& operator&=(const bitset &other)
+		{
+			assert(("Bitsets of different sizes.", m_size == other.m_size));
+
+			for (unsigned int i = 0; i < m_words.size(); ++i)
+				m_words[i] &= other.m_words[i];
+
+			return *this;
+		}
+
+		bool operator==(const bitset &other) const { return m_size == other.m_size && m_words == other.m_words; }
+
+		bool operator!=(const bitset &other) const { return !(*this == other); }
+
+		/**
+		 * @return The index of the first bit set at or after index, or size() if there is none.
+		 * The bits set are visited with: for (i = b.next(0); i < b.size(); i = b.next(i+1)).
+		*/
+		unsigned int next(unsigned int index) const
+		{
+			unsigned int word = index/64;
+			std::uint64_t bits;
+
+			if (index >= m_size)
+				return m_size;
+
+			bits = m_words[word] & (~0ULL << (index%64));
+
+			while (!bits)
+			{
+				if (++word == m_words.size())
+					return m_size;
+
+				bits = m_words[word];
+			}
+
+			return word*64+__builtin_ctzll(bits);
+		}
+
+	private:
+		std::vector<std::uint64_t> m_words;
+		unsigned int m_size;
+};
+
+#endif // BITSET_HPP
@@ -0,0 +1,116 @@
+#ifndef BLOOM_FILTER_HPP
+#define BLOOM_FILTER_HPP
+
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * Bloom filter over byte strings, used as a bitstate (supertrace) set of visited states.
+ * An item costs nb_hashes bits instead of a full copy: a lookup may answer that an item was
+ * inserted when it was not (false positive), but never the opposite.
+ * The nb_hashes bit positions are derived from two 64-bit hashes of the item by double hashing.
+*/
+class bloom_filter
+{
+	public:
+		bloom_filter(unsigned long long nb_bits, unsigned int nb_hashes):
+			m_bits((nb_bits+63)/64, 0), m_nb_bits(((nb_bits+63)/64)*64),
+			m_nb_hashes(nb_hashes), m_nb_inserted(0), m_nb_set(0)
+		{
+			assert(("A Bloom filter needs at least one bit and one hash.", nb_bits > 0 && nb_hashes > 0));
+		}
+
+		unsigned long long nb_bits(void) const { return m_nb_bits; }
+
+		unsigned int nb_hashes(void) const { return m_nb_hashes; }
+
+		// Number of items inserted which were not already reported as present
+		unsigned long long nb_inserted(void) const { return m_nb_inserted; }
+
+		// Proportion of the bits set to 1
+		double fill_ratio(void) const { return (double)m_nb_set/m_nb_bits; }
+
+		/**
+		 * @return The probability that a lookup of an item never inserted answers true, estimated
+		 *	   from the current fill ratio.
+		*/
+		double false_positive_rate(void) const { return std::pow(fill_ratio(), m_nb_hashes); }
+
+		bool contains(const unsigned char *data, std::size_t size) const
+		{
+			std::uint64_t h1, h2;
+
+			hashes(data, size, h1, h2);
+
+			for (unsigned int i = 0; i < m_nb_hashes; ++i)
+			{
+				if (!test((h1+i*h2)%m_nb_bits))
+					return false;
+			}
+
+			return true;
+		}
+
+		/**
+		 * Inserts an item.
+		 * @return False if the item was (possibly) already inserted.
+		*/
+		bool insert(const unsigned char *data, std::size_t size)
+		{
+			bool to_return = false;
+			std::uint64_t h1, h2, bit;
+
+			hashes(data, size, h1, h2);
+
+			for (unsigned int i = 0; i < m_nb_hashes; ++i)
+			{
+				bit = (h1+i*h2)%m_nb_bits;
+
+				if (!test(bit))
+				{
+					m_bits[bit/64] |= 1ULL << (bit%64);
+					m_nb_set++;
+					to_return = true;
+				}
+			}
+
+			if (to_return)
+				m_nb_inserted++;
+
+			return to_return;
+		}
+
+	private:
+		std::vector<std::uint64_t> m_bits;
+		unsigned long long m_nb_bits;
+		unsigned int m_nb_hashes;
+		unsigned long long m_nb_inserted;
+		unsigned long long m_nb_set;
+
+		bool test(std::uint64_t bit) const { return (m_bits[bit/64] >> (bit%64)) & 1; }
+
+		// Final mix of splitmix64
+		static std::uint64_t mix(std::uint64_t x)
+		{
+			x = (x ^ (x >> 30))*0xbf58476d1ce4e5b9ULL;
+			x = (x ^ (x >> 27))*0x94d049bb133111ebULL;
+			return x ^ (x >> 31);
+		}
+
+		// FNV-1a hash of the item, mixed twice. The second hash is made odd so that it is never 0
+		static void hashes(const unsigned char *data, std::size_t size, std::uint64_t &h1, std::uint64_t &h2)
+		{
+			std::uint64_t h = 0xcbf29ce484222325ULL;
+
+			for (std::size_t i = 0; i < size; ++i)
+				h = (h ^ data[i])*0x100000001b3ULL;
+
+			h1 = mix(h);
+			h2 = mix(h ^ 0x9e3779b97f4a7c15ULL) | 1;
+		}
+};
+
+#endif // BLOOM_FILTER_HPP
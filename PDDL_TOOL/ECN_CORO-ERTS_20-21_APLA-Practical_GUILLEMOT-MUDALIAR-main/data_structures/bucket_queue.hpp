@@ -0,0 +1,74 @@
+#ifndef BUCKET_QUEUE_HPP
+#define BUCKET_QUEUE_HPP
+
+#include <cassert>
+#include <climits>
+#include <vector>
+
+/**
+ * Dial's bucket queue: a priority queue for small unsigned integer priorities.
+ * Items with the same priority are stored in the same bucket, so that push and pop run in
+ * constant time (amortized over the scan of the empty buckets).
+ * Items of a bucket are popped in LIFO order.
+*/
+template<typename T> class bucket_queue
+{
+	public:
+		bucket_queue(void): m_size(0), m_min(0) {}
+
+		unsigned int size(void) const { return m_size; }
+
+		bool empty(void) const { return m_size == 0; }
+
+		void clear(void)
+		{
+			m_buckets.clear();
+			m_size = 0;
+			m_min = 0;
+		}
+
+		// The priority UINT_MAX is reserved, it would overflow the number of buckets
+		void push(const T &value, unsigned int priority)
+		{
+			assert(("Priority out of the bucket queue.", priority < UINT_MAX));
+
+			if (priority >= m_buckets.size())
+				m_buckets.resize(priority+1);
+
+			m_buckets[priority].push_back(value);
+
+			// A non-monotonic priority moves the scan back
+			if (priority < m_min || m_size == 0)
+				m_min = priority;
+
+			m_size++;
+		}
+
+		// Priority of the next item to be popped
+		unsigned int min_priority(void)
+		{
+			assert(("Empty bucket queue.", m_size > 0));
+
+			while (m_buckets[m_min].empty())
+				m_min++;
+
+			return m_min;
+		}
+
+		T pop(void)
+		{
+			T to_return = m_buckets[min_priority()].back();
+
+			m_buckets[m_min].pop_back();
+			m_size--;
+
+			return to_return;
+		}
+
+	private:
+		std::vector<std::vector<T>> m_buckets;
+		unsigned int m_size;
+		unsigned int m_min;
+};
+
+#endif // BUCKET_QUEUE_HPP
@@ -0,0 +1,647 @@
+#ifndef FIXED_KDT_HPP
+#define FIXED_KDT_HPP
+
+#include "frozen_kdt.hpp"
+#include "node_pool.hpp"
+
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+/**
+ * KD-tree whose values all have K components, K being known at compile time (see kdt for the
+ * version with a dimension chosen at run time). The values are stored as std::array keys in
+ * the nodes, and the loops over the components and the cycling of the splitting dimension are
+ * unrolled by the compiler.
+ * The values given to insert(), contains() and erase() may be of any type V indexable by
+ * operator[] on K components (a std::array, a tuple, ...), they are only copied in a key when
+ * a node is created.
+ * The values are ordered as in frozen_kdt: on the splitting dimension d of a node, ties being
+ * broken by the components d+1, d+2, ... (cyclically). The lower values are in the left
+ * subtree and the greater ones in the right subtree, so a lookup follows a single path.
+ *
+ * The tree is persistent: the nodes are reference counted and shared between the copies of a
+ * tree, so a copy takes constant time. A modification copies the shared nodes on the path from
+ * the root to the modified node (path copying), the rest of the tree being still shared, so
+ * it takes O(depth) time and memory. The nodes on this path which are not shared any more are
+ * modified in place. The reference counts are not atomic: the copies of a tree must be used
+ * by a single thread, as the nodes of node_pool.
+ *
+ * A tree which will not be modified any more can be frozen: its values are moved into a
+ * frozen_kdt, which is contiguous and faster to query. The first modification of a frozen tree
+ * rebuilds the nodes with the shape of the frozen tree, without any comparison.
+*/
+template<unsigned int K, typename U> class fixed_kdt
+{
+	public:
+		typedef std::array<U, K> key_type;
+
+		fixed_kdt(void): m_size(0), m_tree(nullptr), m_is_frozen(false) {}
+
+		// Copy constructor, the nodes are shared with other
+		fixed_kdt(const fixed_kdt &other): m_size(other.m_size), m_tree(acquire(other.m_tree)),
+						   m_frozen(other.m_frozen), m_is_frozen(other.m_is_frozen) {}
+
+		fixed_kdt(fixed_kdt &&other) noexcept: m_size(other.m_size), m_tree(other.m_tree),
+						       m_frozen(std::move(other.m_frozen)),
+						       m_is_frozen(other.m_is_frozen)
+		{
+			other.m_size = 0;
+			other.m_tree = nullptr;
+			other.m_frozen.clear();
+			other.m_is_frozen = false;
+		}
+
+		~fixed_kdt(void) { release(m_tree); }
+
+		fixed_kdt& operator=(const fixed_kdt &other)
+		{
+			if (this != &other)
+			{
+				release(m_tree);
+				m_size = other.m_size;
+				m_tree = acquire(other.m_tree);
+				m_frozen = other.m_frozen;
+				m_is_frozen = other.m_is_frozen;
+			}
+
+			return *this;
+		}
+
+		fixed_kdt& operator=(fixed_kdt &&other) noexcept
+		{
+			if (this != &other)
+			{
+				release(m_tree);
+				m_size = other.m_size;
+				m_tree = other.m_tree;
+				m_frozen = std::move(other.m_frozen);
+				m_is_frozen = other.m_is_frozen;
+				other.m_size = 0;
+				other.m_tree = nullptr;
+				other.m_frozen.clear();
+				other.m_is_frozen = false;
+			}
+
+			return *this;
+		}
+
+		unsigned int size(void) const { return m_size; }
+
+		bool empty(void) const { return m_size == 0; }
+
+		bool frozen(void) const { return m_is_frozen; }
+
+		void clear(void)
+		{
+			release(m_tree);
+			m_tree = nullptr;
+			m_size = 0;
+			m_frozen.clear();
+			m_is_frozen = false;
+		}
+
+		// Moves the values into a frozen_kdt
+		void freeze(void)
+		{
+			std::vector<key_type> values;
+			auto push = [&values](const key_type &key) { values.push_back(key); };
+
+			if (m_is_frozen)
+				return;
+
+			values.reserve(m_size);
+			for_each(m_tree, push);
+
+			release(m_tree);
+			m_tree = nullptr;
+			m_frozen = frozen_kdt<K, U>(std::move(values));
+			m_is_frozen = true;
+		}
+
+		// @return 0 if the value was inserted, 1 if it was already in the tree
+		template<typename V> int insert(const V &value)
+		{
+			int comparison;
+			unsigned int dimension = 0;
+			node **link;
+
+			// No node is copied for a value already in the tree
+			if (contains(value))
+				return 1;
+
+			thaw();
+			link = &m_tree;
+
+			while (*link)
+			{
+				unshare(*link);
+				(*link)->m_size++;
+
+				comparison = compare(value, (*link)->m_value, dimension);
+				link = (comparison < 0 ? &(*link)->m_left : &(*link)->m_right);
+				dimension = next(dimension);
+			}
+
+			*link = new node(value);
+			m_size++;
+
+			return 0;
+		}
+
+		template<typename V> bool contains(const V &value) const
+		{
+			int comparison;
+			unsigned int dimension = 0;
+			const node *tree = m_tree;
+
+			if (m_is_frozen)
+				return m_frozen.contains(value);
+
+			while (tree)
+			{
+				comparison = compare(value, tree->m_value, dimension);
+				if (comparison == 0)
+					return true;
+
+				tree = (comparison < 0 ? tree->m_left : tree->m_right);
+				dimension = next(dimension);
+			}
+
+			return false;
+		}
+
+		// @return 0 if the value was erased, 1 if it was not in the tree
+		template<typename V> int erase(const V &value)
+		{
+			if (!contains(value))
+				return 1;
+
+			thaw();
+			erase(m_tree, 0, value);
+			m_size--;
+
+			return 0;
+		}
+
+		// True if the root of the tree is shared with another tree
+		bool shared(void) const { return m_tree && m_tree->m_references > 1; }
+
+		/**
+		 * Value of the given rank in the order of for_each(), found in O(depth) with the
+		 * sizes of the subtrees (in constant time when the tree is frozen).
+		*/
+		const key_type& at(unsigned int rank) const
+		{
+			const node *tree = m_tree;
+
+			assert(("Rank out of the tree.", rank < m_size));
+
+			if (m_is_frozen)
+				return m_frozen.at(rank);
+
+			while (size(tree->m_left) != rank)
+			{
+				if (rank < size(tree->m_left))
+					tree = tree->m_left;
+				else
+				{
+					rank -= size(tree->m_left)+1;
+					tree = tree->m_right;
+				}
+			}
+
+			return tree->m_value;
+		}
+
+		// Calls f on each value of the tree (a key_type), in order unless the tree is frozen
+		template<typename F> void for_each(F f) const
+		{
+			if (m_is_frozen)
+				m_frozen.for_each(f);
+			else
+				for_each(m_tree, f);
+		}
+
+		/**
+		 * Calls f on each value of the tree within range (see kdt_range), in order unless
+		 * the tree is frozen. The subtrees are pruned on the bounded splitting dimensions.
+		*/
+		template<typename F> void match(const kdt_range<U> &range, F f) const
+		{
+			assert(("The range does not have the dimension of the tree.", range.dimension() == K));
+
+			if (m_is_frozen)
+				m_frozen.match(range, f);
+			else
+				match(m_tree, 0, range, f);
+		}
+
+	private:
+		struct node
+		{
+			key_type m_value;
+			node *m_left;
+			node *m_right;
+
+			// Number of nodes in the subtree of this node
+			unsigned int m_size;
+
+			// Number of trees and nodes pointing to this node
+			unsigned int m_references;
+
+			node(const key_type &value): m_value(value), m_left(nullptr), m_right(nullptr), m_size(1),
+						     m_references(1) {}
+
+			template<typename V> node(const V &value): m_left(nullptr), m_right(nullptr), m_size(1),
+								   m_references(1)
+			{
+				for (unsigned int i = 0; i < K; ++i)
+					m_value[i] = value[i];
+			}
+
+			// The nodes are allocated in the pool of the thread (see node_pool)
+			static void* operator new(std::size_t bytes) { return node_pool::local().allocate(bytes); }
+			static void operator delete(void *n, std::size_t bytes) { node_pool::local().deallocate(n, bytes); }
+		};
+
+		unsigned int m_size;
+		node *m_tree;
+
+		frozen_kdt<K, U> m_frozen;
+		bool m_is_frozen;
+
+		static unsigned int next(unsigned int dimension) { return frozen_kdt<K, U>::next(dimension); }
+
+		template<typename V> static int compare(const V &value, const key_type &key, unsigned int dimension)
+		{
+			return frozen_kdt<K, U>::compare(value, key, dimension);
+		}
+
+		// Rebuilds the nodes of a frozen tree from the subtree at position index of its array
+		node* thaw(unsigned int index) const
+		{
+			node *to_return = nullptr;
+
+			if (index < m_frozen.size())
+			{
+				to_return = new node(m_frozen.at(index));
+				to_return->m_left = thaw(2*index+1);
+				to_return->m_right = thaw(2*index+2);
+				to_return->m_size += size(to_return->m_left) + size(to_return->m_right);
+			}
+
+			return to_return;
+		}
+
+		void thaw(void)
+		{
+			if (!m_is_frozen)
+				return;
+
+			m_tree = thaw(0);
+			m_frozen.clear();
+			m_is_frozen = false;
+		}
+
+		static node* acquire(node *tree)
+		{
+			if (tree)
+				tree->m_references++;
+
+			return tree;
+		}
+
+		// Drops a reference to tree, which is destroyed with its last reference
+		static void release(node *tree)
+		{
+			while (tree && --tree->m_references == 0)
+			{
+				node *right = tree->m_right;
+
+				release(tree->m_left);
+				delete tree;
+				tree = right;
+			}
+		}
+
+		// Replaces a shared node by a copy of its own, pointing to the same children
+		static void unshare(node* &tree)
+		{
+			node *copy;
+
+			if (tree->m_references > 1)
+			{
+				copy = new node(tree->m_value);
+				copy->m_left = acquire(tree->m_left);
+				copy->m_right = acquire(tree->m_right);
+				copy->m_size = tree->m_size;
+
+				tree->m_references--;
+				tree = copy;
+			}
+		}
+
+		static unsigned int size(const node *tree) { return tree ? tree->m_size : 0; }
+
+		template<typename F> static void for_each(const node *tree, F &f)
+		{
+			while (tree)
+			{
+				for_each(tree->m_left, f);
+				f(tree->m_value);
+				tree = tree->m_right;
+			}
+		}
+
+		// The subtrees are ordered as in frozen_kdt::match()
+		template<typename F> static void match(const node *tree, unsigned int dimension, const kdt_range<U> &range, F &f)
+		{
+			while (tree)
+			{
+				if (range.above_low(dimension, tree->m_value[dimension]))
+					match(tree->m_left, next(dimension), range, f);
+
+				if (range.contains(tree->m_value))
+					f(tree->m_value);
+
+				if (!range.below_high(dimension, tree->m_value[dimension]))
+					return;
+
+				tree = tree->m_right;
+				dimension = next(dimension);
+			}
+		}
+
+		// Node holding the greatest value of tree in the order of the given dimension
+		static node* max(node *tree, unsigned int dimension, unsigned int split)
+		{
+			node *to_return = tree, *candidate;
+
+			if (tree)
+			{
+				// The left subtree only holds lower values in the order of its splitting dimension
+				if (split != dimension)
+				{
+					candidate = max(tree->m_left, dimension, next(split));
+					if (candidate && compare(candidate->m_value, to_return->m_value, dimension) > 0)
+						to_return = candidate;
+				}
+
+				candidate = max(tree->m_right, dimension, next(split));
+				if (candidate && compare(candidate->m_value, to_return->m_value, dimension) > 0)
+					to_return = candidate;
+			}
+
+			return to_return;
+		}
+
+		// Erases value, which is in tree, copying the shared nodes on its path
+		template<typename V> static void erase(node* &tree, unsigned int dimension, const V &value)
+		{
+			int comparison = compare(value, tree->m_value, dimension);
+			node *replacement;
+
+			if (comparison == 0 && !tree->m_left && !tree->m_right)
+			{
+				release(tree);
+				tree = nullptr;
+				return;
+			}
+
+			unshare(tree);
+			tree->m_size--;
+
+			if (comparison != 0)
+			{
+				erase(comparison < 0 ? tree->m_left : tree->m_right, next(dimension), value);
+				return;
+			}
+
+			/**
+			 * The value is replaced by the greatest value of the left subtree in the order of
+			 * the splitting dimension, which is then erased from it. A lone right subtree is
+			 * moved to the left so that the left subtree still holds the lower values.
+			*/
+			if (!tree->m_left)
+			{
+				tree->m_left = tree->m_right;
+				tree->m_right = nullptr;
+			}
+
+			replacement = max(tree->m_left, dimension, next(dimension));
+			tree->m_value = replacement->m_value;
+
+			erase(tree->m_left, next(dimension), tree->m_value);
+		}
+
+	public:
+		/** ITERATOR **/
+
+		/**
+		 * Forward iterator over the values in the order of for_each(). The nodes whose value
+		 * is still to visit are kept on an explicit stack (the current node and its ancestors
+		 * reached through a left child), so that an increment takes constant amortized time.
+		 * A frozen tree is iterated by rank. The tree must not be modified while iterated.
+		*/
+		class const_iterator
+		{
+			public:
+				using iterator_category = std::forward_iterator_tag;
+				using value_type = key_type;
+				using difference_type = std::ptrdiff_t;
+				using pointer = const key_type*;
+				using reference = const key_type&;
+
+				const_iterator(void): m_frozen(nullptr), m_rank(0) {}
+
+				reference operator*(void) const { return m_frozen ? m_frozen->at(m_rank) : m_stack.back()->m_value; }
+				pointer operator->(void) const { return &**this; }
+
+				const_iterator& operator++(void)
+				{
+					const node *current;
+
+					if (m_frozen)
+						m_rank++;
+					else
+					{
+						current = m_stack.back();
+						m_stack.pop_back();
+						descend(current->m_right);
+					}
+
+					return *this;
+				}
+
+				const_iterator operator++(int)
+				{
+					const_iterator tmp(*this);
+					++(*this);
+					return tmp;
+				}
+
+				bool operator==(const const_iterator &rhs) const
+				{
+					if (m_frozen)
+						return m_rank == rhs.m_rank;
+
+					return m_stack.empty() ? rhs.m_stack.empty()
+							       : !rhs.m_stack.empty() && m_stack.back() == rhs.m_stack.back();
+				}
+
+				bool operator!=(const const_iterator &rhs) const { return !(*this == rhs); }
+
+			private:
+				friend class fixed_kdt;
+
+				std::vector<const node*> m_stack;
+				const frozen_kdt<K, U> *m_frozen;
+				unsigned int m_rank;
+
+				// Pushes tree and the nodes on the path to its lowest value
+				void descend(const node *tree)
+				{
+					while (tree)
+					{
+						m_stack.push_back(tree);
+						tree = tree->m_left;
+					}
+				}
+		};
+
+		const_iterator begin(void) const
+		{
+			const_iterator to_return;
+
+			if (m_is_frozen)
+				to_return.m_frozen = &m_frozen;
+			else
+				to_return.descend(m_tree);
+
+			return to_return;
+		}
+
+		const_iterator end(void) const
+		{
+			const_iterator to_return;
+
+			if (m_is_frozen)
+			{
+				to_return.m_frozen = &m_frozen;
+				to_return.m_rank = m_size;
+			}
+
+			return to_return;
+		}
+};
+
+/**
+ * Specialization for the values without any component: the tree holds at most the empty
+ * value.
+*/
+template<typename U> class fixed_kdt<0, U>
+{
+	public:
+		typedef std::array<U, 0> key_type;
+
+		fixed_kdt(void): m_present(false) {}
+
+		unsigned int size(void) const { return m_present ? 1 : 0; }
+
+		bool empty(void) const { return !m_present; }
+
+		bool frozen(void) const { return false; }
+
+		void freeze(void) {}
+
+		void clear(void) { m_present = false; }
+
+		template<typename V> int insert(const V &)
+		{
+			if (m_present)
+				return 1;
+
+			m_present = true;
+			return 0;
+		}
+
+		template<typename V> bool contains(const V &) const { return m_present; }
+
+		template<typename V> int erase(const V &)
+		{
+			if (!m_present)
+				return 1;
+
+			m_present = false;
+			return 0;
+		}
+
+		template<typename F> void for_each(F f) const
+		{
+			if (m_present)
+				f(key_type());
+		}
+
+		template<typename F> void match(const kdt_range<U> &, F f) const { for_each(f); }
+
+		key_type at(unsigned int) const { return key_type(); }
+
+		/** ITERATOR **/
+
+		// Forward iterator over the empty value, if the tree holds it
+		class const_iterator
+		{
+			public:
+				using iterator_category = std::forward_iterator_tag;
+				using value_type = key_type;
+				using difference_type = std::ptrdiff_t;
+				using pointer = const key_type*;
+				using reference = const key_type&;
+
+				const_iterator(void): m_rank(0) {}
+
+				reference operator*(void) const { return m_key; }
+				pointer operator->(void) const { return &m_key; }
+
+				const_iterator& operator++(void)
+				{
+					m_rank++;
+					return *this;
+				}
+
+				const_iterator operator++(int)
+				{
+					const_iterator tmp(*this);
+					++(*this);
+					return tmp;
+				}
+
+				bool operator==(const const_iterator &rhs) const { return m_rank == rhs.m_rank; }
+				bool operator!=(const const_iterator &rhs) const { return !(*this == rhs); }
+
+			private:
+				friend class fixed_kdt;
+
+				key_type m_key;
+				unsigned int m_rank;
+		};
+
+		const_iterator begin(void) const { return const_iterator(); }
+
+		const_iterator end(void) const
+		{
+			const_iterator to_return;
+
+			to_return.m_rank = size();
+			return to_return;
+		}
+
+	private:
+		bool m_present;
+};
+
+#endif // FIXED_KDT_HPP
@@ -0,0 +1,257 @@
+#ifndef FROZEN_KDT_HPP
+#define FROZEN_KDT_HPP
+
+#include "kdt_range.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * Immutable KD-tree over values with K components, built in bulk and stored in a contiguous
+ * implicit array: the children of the node at position i are at positions 2i+1 and 2i+2
+ * (Eytzinger layout), so there is no pointer to follow and the tree takes exactly one key
+ * per value.
+ * The tree is balanced and left-complete: the root of each subtree is the median of its
+ * values on the splitting dimension of its depth, the left subtree getting as many values as
+ * a left-complete tree requires. The values are ordered on the splitting dimension d, ties
+ * being broken by the components d+1, d+2, ... (cyclically), so that the values are totally
+ * ordered at each depth and a lookup follows a single path.
+ * The values are visited by for_each() in the order of the array.
+ * The array is immutable and shared between the copies of the tree, so a copy takes constant
+ * time.
+*/
+template<unsigned int K, typename U> class frozen_kdt
+{
+	public:
+		typedef std::array<U, K> key_type;
+
+		frozen_kdt(void): m_data(nullptr), m_size(0) {}
+
+		// Builds the tree from values without duplicates (in any order)
+		frozen_kdt(std::vector<key_type> values): m_data(nullptr), m_size(values.size())
+		{
+			std::shared_ptr<std::vector<key_type>> nodes = std::make_shared<std::vector<key_type>>(values.size());
+
+			build(*nodes, values.begin(), values.end(), 0, 0);
+
+			m_data = nodes->data();
+			m_nodes = std::move(nodes);
+		}
+
+		// Copy constructor, the array is shared with other
+		frozen_kdt(const frozen_kdt &other) = default;
+
+		// Move constructor, other is left empty
+		frozen_kdt(frozen_kdt &&other) noexcept: m_nodes(std::move(other.m_nodes)), m_data(other.m_data),
+							 m_size(other.m_size)
+		{
+			other.m_data = nullptr;
+			other.m_size = 0;
+		}
+
+		frozen_kdt& operator=(const frozen_kdt &other) = default;
+
+		frozen_kdt& operator=(frozen_kdt &&other) noexcept
+		{
+			if (this != &other)
+			{
+				m_nodes = std::move(other.m_nodes);
+				m_data = other.m_data;
+				m_size = other.m_size;
+				other.m_data = nullptr;
+				other.m_size = 0;
+			}
+
+			return *this;
+		}
+
+		unsigned int size(void) const { return m_size; }
+
+		bool empty(void) const { return m_size == 0; }
+
+		void clear(void)
+		{
+			m_nodes.reset();
+			m_data = nullptr;
+			m_size = 0;
+		}
+
+		template<typename V> bool contains(const V &value) const
+		{
+			int comparison;
+			unsigned int node = 0, dimension = 0;
+
+			while (node < m_size)
+			{
+				comparison = compare(value, m_data[node], dimension);
+				if (comparison == 0)
+					return true;
+
+				node = 2*node + (comparison < 0 ? 1 : 2);
+				dimension = next(dimension);
+			}
+
+			return false;
+		}
+
+		// Calls f on each value of the tree (a key_type)
+		template<typename F> void for_each(F f) const
+		{
+			for (unsigned int node = 0; node < m_size; ++node)
+				f(m_data[node]);
+		}
+
+		/**
+		 * Calls f on each value of the tree within range (see kdt_range). The subtrees are
+		 * pruned on the bounded splitting dimensions.
+		*/
+		template<typename F> void match(const kdt_range<U> &range, F f) const
+		{
+			assert(("The range does not have the dimension of the tree.", range.dimension() == K));
+			match(0, 0, range, f);
+		}
+
+		/**
+		 * Value of the given rank in the order of for_each(), which is its position in the
+		 * implicit array: the children of the value at position i are at 2i+1 and 2i+2.
+		*/
+		const key_type& at(unsigned int rank) const { return m_data[rank]; }
+
+		// Splitting dimension of the children of a node of the given splitting dimension
+		static unsigned int next(unsigned int dimension) { return dimension+1 == K ? 0 : dimension+1; }
+
+		/**
+		 * Comparison of value and key from the component dimension, cyclically.
+		 * @return A negative number if value is lower, 0 if equal, a positive number if greater.
+		*/
+		template<typename V> static int compare(const V &value, const key_type &key, unsigned int dimension)
+		{
+			int to_return = 0;
+
+			for (unsigned int i = 0; i < K && to_return == 0; ++i)
+			{
+				to_return = compare_component(value[dimension], key[dimension]);
+				dimension = next(dimension);
+			}
+
+			return to_return;
+		}
+
+	private:
+		// The implicit array, with its first value and its size
+		std::shared_ptr<const std::vector<key_type>> m_nodes;
+		const key_type *m_data;
+		unsigned int m_size;
+
+		/**
+		 * In the order of the splitting dimension d, the values of the left subtree of a node
+		 * are lower or equal to it on the component d, and those of the right subtree greater
+		 * or equal.
+		*/
+		template<typename F> void match(unsigned int node, unsigned int dimension, const kdt_range<U> &range, F &f) const
+		{
+			while (node < m_size)
+			{
+				const key_type &key = m_data[node];
+
+				if (range.above_low(dimension, key[dimension]))
+					match(2*node+1, next(dimension), range, f);
+
+				if (range.contains(key))
+					f(key);
+
+				if (!range.below_high(dimension, key[dimension]))
+					return;
+
+				node = 2*node+2;
+				dimension = next(dimension);
+			}
+		}
+
+		// Strings are compared once with std::string::compare() instead of twice with <
+		static int compare_component(const std::string &c1, const std::string &c2) { return c1.compare(c2); }
+
+		template<typename T> static int compare_component(const T &c1, const T &c2)
+		{
+			return c1 < c2 ? -1 : (c2 < c1 ? 1 : 0);
+		}
+
+		// Number of nodes in the left subtree of a left-complete tree of size nodes
+		static unsigned int left_size(unsigned int size)
+		{
+			unsigned int full = 1, last_level;
+
+			// full becomes the number of nodes on the last level of a perfect tree of the same height
+			while (2*full <= size)
+				full *= 2;
+
+			if (full == 1)
+				return 0;
+
+			last_level = size - (full-1);
+
+			return (full/2 - 1) + std::min(last_level, full/2);
+		}
+
+		// Puts the values from begin to end in the subtree at position node of the array nodes
+		static void build(std::vector<key_type> &nodes, typename std::vector<key_type>::iterator begin,
+				  typename std::vector<key_type>::iterator end, unsigned int node, unsigned int dimension)
+		{
+			typename std::vector<key_type>::iterator median;
+
+			if (begin == end)
+				return;
+
+			median = begin + left_size(end-begin);
+
+			std::nth_element(begin, median, end, [dimension](const key_type &k1, const key_type &k2)
+				{
+					return compare(k1, k2, dimension) < 0;
+				});
+
+			nodes[node] = std::move(*median);
+
+			build(nodes, begin, median, 2*node+1, next(dimension));
+			build(nodes, median+1, end, 2*node+2, next(dimension));
+		}
+};
+
+/**
+ * Specialization for the values without any component: the tree holds at most the empty
+ * value.
+*/
+template<typename U> class frozen_kdt<0, U>
+{
+	public:
+		typedef std::array<U, 0> key_type;
+
+		frozen_kdt(void): m_present(false) {}
+		frozen_kdt(const std::vector<key_type> &values): m_present(!values.empty()) {}
+
+		unsigned int size(void) const { return m_present ? 1 : 0; }
+
+		bool empty(void) const { return !m_present; }
+
+		void clear(void) { m_present = false; }
+
+		template<typename V> bool contains(const V &) const { return m_present; }
+
+		template<typename F> void for_each(F f) const
+		{
+			if (m_present)
+				f(key_type());
+		}
+
+		template<typename F> void match(const kdt_range<U> &, F f) const { for_each(f); }
+
+		key_type at(unsigned int) const { return key_type(); }
+
+	private:
+		bool m_present;
+};
+
+#endif // FROZEN_KDT_HPP
@@ -0,0 +1,260 @@
+#ifndef GRAPH_AUTOMORPHISMS_HPP
+#define GRAPH_AUTOMORPHISMS_HPP
+
+#include <algorithm>
+#include <vector>
+
+/**
+ * Generators of the automorphism group of an undirected graph whose vertices are colored (an
+ * automorphism is a permutation of the vertices preserving the colors and the edges).
+ * The search is a simplified individualization-refinement (as in nauty): the coloring is
+ * refined until it is equitable, then a vertex of the first non-singleton cell is given its own
+ * color, and so on until every vertex has its own color (a leaf). The first path of the search
+ * tree gives a reference leaf. At each level of the first path, every other vertex of the cell
+ * which is not yet known to be in the orbit of the first one is individualized instead, and its
+ * subtree is searched for a leaf mapped on the reference leaf by an automorphism. The
+ * automorphisms found this way generate the whole group.
+ * The number of nodes of the search tree is bounded, the generators found are then valid but may
+ * not generate the whole group.
+*/
+class graph_automorphisms
+{
+	public:
+		graph_automorphisms(void): m_nb_nodes(0), m_max_nodes(0) {}
+
+		unsigned int nb_vertices(void) const { return m_colors.size(); }
+
+		// Number of nodes of the search tree explored by the last call to generators()
+		unsigned long long nb_nodes(void) const { return m_nb_nodes; }
+
+		// @return The index of the new vertex
+		unsigned int add_vertex(unsigned int color)
+		{
+			m_colors.push_back(color);
+			m_neighbors.push_back(std::vector<unsigned int>());
+
+			return m_colors.size()-1;
+		}
+
+		void add_edge(unsigned int v1, unsigned int v2)
+		{
+			m_neighbors[v1].push_back(v2);
+			m_neighbors[v2].push_back(v1);
+		}
+
+		/**
+		 * @arg max_nodes The maximum number of nodes of the search tree
+		 * @return Generators of the automorphism group other than the identity, the vertex v
+		 *	   being mapped on p[v] by the generator p.
+		*/
+		std::vector<std::vector<unsigned int>> generators(unsigned long long max_nodes = 100000)
+		{
+			std::vector<unsigned int> colors(m_colors);
+
+			for (std::vector<unsigned int> &n : m_neighbors)
+			{
+				std::sort(n.begin(), n.end());
+				n.erase(std::unique(n.begin(), n.end()), n.end());
+			}
+
+			m_generators.clear();
+			m_nb_nodes = 0;
+			m_max_nodes = max_nodes;
+
+			refine(colors);
+			first_path(colors);
+
+			return m_generators;
+		}
+
+	private:
+		std::vector<unsigned int> m_colors;
+		std::vector<std::vector<unsigned int>> m_neighbors;
+		std::vector<std::vector<unsigned int>> m_generators;
+		unsigned long long m_nb_nodes;
+		unsigned long long m_max_nodes;
+
+		/**
+		 * Color refinement: the vertices are recolored by their color and the multiset of the
+		 * colors of their neighbors, until the number of colors is stable. The new colors are the
+		 * ranks of the signatures, so that they do not depend on the numbering of the vertices.
+		 * @return The number of colors.
+		*/
+		unsigned int refine(std::vector<unsigned int> &colors) const
+		{
+			unsigned int v, nb_colors = 0, previous;
+			std::vector<unsigned int> order(colors.size());
+			std::vector<std::vector<unsigned int>> signatures(colors.size());
+
+			do
+			{
+				previous = nb_colors;
+
+				for (v = 0; v < colors.size(); ++v)
+				{
+					signatures[v].assign(1, colors[v]);
+					for (unsigned int n : m_neighbors[v])
+						signatures[v].push_back(colors[n]);
+					std::sort(signatures[v].begin()+1, signatures[v].end());
+					order[v] = v;
+				}
+
+				std::sort(order.begin(), order.end(), [&signatures](unsigned int v1, unsigned int v2)
+					{
+						return signatures[v1] < signatures[v2];
+					});
+
+				nb_colors = 0;
+				for (v = 0; v < order.size(); ++v)
+				{
+					if (v > 0 && signatures[order[v]] != signatures[order[v-1]])
+						nb_colors++;
+					colors[order[v]] = nb_colors;
+				}
+				nb_colors++;
+			} while (nb_colors != previous && nb_colors < colors.size());
+
+			return nb_colors;
+		}
+
+		// The vertices of the non-singleton cell with the lowest color, empty for a leaf
+		std::vector<unsigned int> target_cell(const std::vector<unsigned int> &colors) const
+		{
+			unsigned int v, target = colors.size();
+			std::vector<unsigned int> counts(colors.size(), 0), to_return;
+
+			for (v = 0; v < colors.size(); ++v)
+				counts[colors[v]]++;
+
+			for (v = 0; v < counts.size() && target == colors.size(); ++v)
+			{
+				if (counts[v] > 1)
+					target = v;
+			}
+
+			for (v = 0; v < colors.size(); ++v)
+			{
+				if (colors[v] == target)
+					to_return.push_back(v);
+			}
+
+			return to_return;
+		}
+
+		// The refined coloring where v has its own color
+		std::vector<unsigned int> individualize(const std::vector<unsigned int> &colors, unsigned int v) const
+		{
+			std::vector<unsigned int> to_return(colors);
+
+			to_return[v] = colors.size();
+			refine(to_return);
+
+			return to_return;
+		}
+
+		// True if the permutation preserves the colors and the edges of the graph
+		bool is_automorphism(const std::vector<unsigned int> &p) const
+		{
+			std::vector<unsigned int> image;
+
+			for (unsigned int v = 0; v < p.size(); ++v)
+			{
+				if (m_colors[p[v]] != m_colors[v] || m_neighbors[p[v]].size() != m_neighbors[v].size())
+					return false;
+
+				image.clear();
+				for (unsigned int n : m_neighbors[v])
+					image.push_back(p[n]);
+				std::sort(image.begin(), image.end());
+
+				if (image != m_neighbors[p[v]])
+					return false;
+			}
+
+			return true;
+		}
+
+		// True if v1 and v2 are in the same orbit of the group spanned by the generators from first
+		bool same_orbit(unsigned int v1, unsigned int v2, unsigned int first) const
+		{
+			std::vector<unsigned int> parents(m_colors.size());
+
+			for (unsigned int v = 0; v < parents.size(); ++v)
+				parents[v] = v;
+
+			auto root = [&parents](unsigned int v)
+				{
+					while (parents[v] != v)
+						v = parents[v] = parents[parents[v]];
+					return v;
+				};
+
+			for (unsigned int g = first; g < m_generators.size(); ++g)
+			{
+				for (unsigned int v = 0; v < parents.size(); ++v)
+					parents[root(v)] = root(m_generators[g][v]);
+			}
+
+			return root(v1) == root(v2);
+		}
+
+		/**
+		 * Searches the subtree of colors for a leaf mapped on the reference leaf by an
+		 * automorphism, which is then added to the generators.
+		*/
+		bool explore(const std::vector<unsigned int> &colors, const std::vector<unsigned int> &reference)
+		{
+			std::vector<unsigned int> cell, vertex_of(colors.size()), p(colors.size());
+
+			if (++m_nb_nodes > m_max_nodes)
+				return false;
+
+			cell = target_cell(colors);
+
+			if (cell.empty())
+			{
+				for (unsigned int v = 0; v < colors.size(); ++v)
+					vertex_of[colors[v]] = v;
+				for (unsigned int v = 0; v < colors.size(); ++v)
+					p[v] = vertex_of[reference[v]];
+
+				if (!is_automorphism(p))
+					return false;
+
+				m_generators.push_back(p);
+				return true;
+			}
+
+			for (unsigned int v : cell)
+			{
+				if (explore(individualize(colors, v), reference))
+					return true;
+			}
+
+			return false;
+		}
+
+		// Follows the first path from colors, @return The reference leaf
+		std::vector<unsigned int> first_path(const std::vector<unsigned int> &colors)
+		{
+			unsigned int first = m_generators.size();
+			std::vector<unsigned int> cell = target_cell(colors), reference;
+
+			m_nb_nodes++;
+
+			if (cell.empty())
+				return colors;
+
+			reference = first_path(individualize(colors, cell[0]));
+
+			for (unsigned int i = 1; i < cell.size() && m_nb_nodes <= m_max_nodes; ++i)
+			{
+				if (!same_orbit(cell[0], cell[i], first))
+					explore(individualize(colors, cell[i]), reference);
+			}
+
+			return reference;
+		}
+};
+
+#endif // GRAPH_AUTOMORPHISMS_HPP
@@ -1,8 +1,15 @@
 #ifndef KDT_HPP
 #define KDT_HPP
 
+#include "kdt_range.hpp"
+#include "node_pool.hpp"
+
+#include <cassert>
+#include <cstddef>
 #include <initializer_list>
 #include <iterator>
+#include <utility>
+#include <vector>
 
 template<template<typename> typename T, typename U> class kdt
 {
@@ -10,26 +17,99 @@ template<template<typename> typename T, typename U> class kdt
 		kdt(void): m_dimension(0), m_size(0), m_tree(nullptr) {}
 		kdt(unsigned int dimension): m_dimension(dimension), m_size(0), m_tree(nullptr) {}
 
-		unsigned int size(void) { return m_size; }
+		// Copy constructor, the nodes are cloned with the shape of the tree of other
+		kdt(const kdt &other): m_dimension(other.m_dimension), m_size(other.m_size),
+				       m_tree(clone(other.m_tree, nullptr)) {}
+
+		// Move constructor, the nodes are taken from other which is left empty
+		kdt(kdt &&other) noexcept: m_dimension(other.m_dimension), m_size(other.m_size), m_tree(other.m_tree)
+		{
+			other.m_size = 0;
+			other.m_tree = nullptr;
+		}
+
+		~kdt(void) { destroy(m_tree); }
+
+		kdt& operator=(const kdt &other)
+		{
+			if (this != &other)
+			{
+				destroy(m_tree);
+				m_dimension = other.m_dimension;
+				m_size = other.m_size;
+				m_tree = clone(other.m_tree, nullptr);
+			}
+
+			return *this;
+		}
+
+		kdt& operator=(kdt &&other) noexcept
+		{
+			if (this != &other)
+			{
+				destroy(m_tree);
+				m_dimension = other.m_dimension;
+				m_size = other.m_size;
+				m_tree = other.m_tree;
+				other.m_size = 0;
+				other.m_tree = nullptr;
+			}
+
+			return *this;
+		}
+
+		unsigned int size(void) const { return m_size; }
+
+		// Empties the tree, which must be empty to change its dimension
+		void clear(void)
+		{
+			destroy(m_tree);
+			m_tree = nullptr;
+			m_size = 0;
+		}
 
 		void set_dimension(unsigned int dimension)
 		{
+			clear();
 			m_dimension = dimension;
-			if (m_tree)
-				delete m_tree;
 		}
 
-		bool empty(void) { return !m_tree; }
+		bool empty(void) const { return !m_tree; }
 
 		int insert(const T<U> &value) { return insert(nullptr, m_tree, 0, value); }
+		int insert(T<U> &&value) { return insert(nullptr, m_tree, 0, std::move(value)); }
 		int insert(std::initializer_list<U> value) { return insert(T<U>(value)); }
 
-		bool contains(T<U> value) { return contains(m_tree, 0, value); }
-		bool contains(std::initializer_list<U> value) { return contains(T<U>(value)); }
+		bool contains(const T<U> &value) const { return contains(m_tree, 0, value); }
+		bool contains(std::initializer_list<U> value) const { return contains(T<U>(value)); }
+
+		const T<U>* query(const T<U> &value) { return query(m_tree, value); }
+
+		/**
+		 * Value of the given rank in the order of the tree, found in O(depth) with the
+		 * sizes of the subtrees.
+		*/
+		const T<U>& at(unsigned int rank) const
+		{
+			const kdtnode *tree = m_tree;
 
-		const T<U>* query(T<U> value) { return query(m_tree, value); }
+			assert(("Rank out of the tree.", rank < m_size));
 
-		int erase(T<U> value) { return erase(m_tree, 0, value); }
+			while (size(tree->m_left) != rank)
+			{
+				if (rank < size(tree->m_left))
+					tree = tree->m_left;
+				else
+				{
+					rank -= size(tree->m_left)+1;
+					tree = tree->m_right;
+				}
+			}
+
+			return tree->m_value;
+		}
+
+		int erase(const T<U> &value) { return erase(m_tree, 0, value); }
 		int erase(std::initializer_list<U> value) { return erase(T<U>(value)); }
 
 		class kdtnode
@@ -41,10 +121,21 @@ template<template<typename> typename T, typename U> class kdt
 				kdtnode *m_left;
 				kdtnode *m_right;
 
+				// Number of nodes in the subtree of this node
+				unsigned int m_size;
+
 				// Methods
 				kdtnode(kdtnode* parent, const T<U> &value):
 					m_value(value), m_parent(parent),
-					m_left(nullptr), m_right(nullptr) {}
+					m_left(nullptr), m_right(nullptr), m_size(1) {}
+
+				kdtnode(kdtnode* parent, T<U> &&value):
+					m_value(std::move(value)), m_parent(parent),
+					m_left(nullptr), m_right(nullptr), m_size(1) {}
+
+				// The nodes are allocated in the pool of the thread (see node_pool)
+				static void* operator new(std::size_t bytes) { return node_pool::local().allocate(bytes); }
+				static void operator delete(void *node, std::size_t bytes) { node_pool::local().deallocate(node, bytes); }
 		};
 
 		class iterator: public std::iterator<std::input_iterator_tag, T<U>>
@@ -92,22 +183,156 @@ template<template<typename> typename T, typename U> class kdt
 
 		iterator end(void) { return iterator(nullptr); }
 
-		T<U> operator[](unsigned int index)
+		/**
+		 * Forward iterator over the values in the order of for_each(), the nodes whose value is
+		 * still to visit being kept on an explicit stack (see fixed_kdt::const_iterator).
+		*/
+		class const_iterator
+		{
+			public:
+				using iterator_category = std::forward_iterator_tag;
+				using value_type = T<U>;
+				using difference_type = std::ptrdiff_t;
+				using pointer = const T<U>*;
+				using reference = const T<U>&;
+
+				const_iterator(void) {}
+
+				reference operator*(void) const { return m_stack.back()->m_value; }
+				pointer operator->(void) const { return &m_stack.back()->m_value; }
+
+				const_iterator& operator++(void)
+				{
+					const kdtnode *current = m_stack.back();
+
+					m_stack.pop_back();
+					descend(current->m_right);
+
+					return *this;
+				}
+
+				const_iterator operator++(int)
+				{
+					const_iterator tmp(*this);
+					++(*this);
+					return tmp;
+				}
+
+				bool operator==(const const_iterator &rhs) const
+				{
+					return m_stack.empty() ? rhs.m_stack.empty()
+							       : !rhs.m_stack.empty() && m_stack.back() == rhs.m_stack.back();
+				}
+
+				bool operator!=(const const_iterator &rhs) const { return !(*this == rhs); }
+
+			private:
+				friend class kdt;
+
+				std::vector<const kdtnode*> m_stack;
+
+				// Pushes tree and the nodes on the path to its lowest value
+				void descend(const kdtnode *tree)
+				{
+					while (tree)
+					{
+						m_stack.push_back(tree);
+						tree = tree->m_left;
+					}
+				}
+		};
+
+		const_iterator begin(void) const
 		{
-			unsigned int i;
-			iterator it = begin();
+			const_iterator to_return;
+
+			to_return.descend(m_tree);
+			return to_return;
+		}
 
-			for (i = 0; i < index; ++i)
-				++it;
+		const_iterator end(void) const { return const_iterator(); }
 
-			return *it;
+		// Calls f on each value of the tree, in order
+		template<typename F> void for_each(F f) const { for_each(m_tree, f); }
+
+		/**
+		 * Calls f on each value of the tree within range (see kdt_range), in order. The
+		 * subtrees are pruned on the bounded splitting dimensions.
+		*/
+		template<typename F> void match(const kdt_range<U> &range, F f) const
+		{
+			assert(("The range does not have the dimension of the tree.", range.dimension() == m_dimension));
+			match(m_tree, 0, range, f);
 		}
 
+		T<U> operator[](unsigned int index) { return at(index); }
+
 	private:
 		unsigned int m_dimension;
 		unsigned int m_size;
 		kdtnode *m_tree;
 
+		// Copy of tree whose root has the given parent
+		static kdtnode* clone(const kdtnode* tree, kdtnode* parent)
+		{
+			kdtnode* to_return = nullptr;
+
+			if (tree)
+			{
+				to_return = new kdtnode(parent, tree->m_value);
+				to_return->m_size = tree->m_size;
+				to_return->m_left = clone(tree->m_left, to_return);
+				to_return->m_right = clone(tree->m_right, to_return);
+			}
+
+			return to_return;
+		}
+
+		template<typename F> static void for_each(const kdtnode* tree, F &f)
+		{
+			while (tree)
+			{
+				for_each(tree->m_left, f);
+				f(tree->m_value);
+				tree = tree->m_right;
+			}
+		}
+
+		/**
+		 * The left subtree of a node only holds lower or equal values on its splitting
+		 * dimension, and the right subtree greater ones.
+		*/
+		template<typename F>
+		void match(const kdtnode* tree, unsigned int dimension, const kdt_range<U> &range, F &f) const
+		{
+			while (tree)
+			{
+				if (range.above_low(dimension, tree->m_value[dimension]))
+					match(tree->m_left, (dimension+1)%m_dimension, range, f);
+
+				if (range.contains(tree->m_value))
+					f(tree->m_value);
+
+				if (!range.below_high(dimension, tree->m_value[dimension]))
+					return;
+
+				tree = tree->m_right;
+				dimension = (dimension+1)%m_dimension;
+			}
+		}
+
+		static unsigned int size(const kdtnode* tree) { return tree ? tree->m_size : 0; }
+
+		static void destroy(kdtnode* tree)
+		{
+			if (tree)
+			{
+				destroy(tree->m_left);
+				destroy(tree->m_right);
+				delete tree;
+			}
+		}
+
 		kdtnode* min(kdtnode* tree)
 		{
 			kdtnode* return_value = tree;
@@ -121,26 +346,42 @@ template<template<typename> typename T, typename U> class kdt
 			return return_value;
 		}
 
-		kdtnode* max(kdtnode* tree)
+		/**
+		 * Node holding the greatest value on the given dimension in tree, split being
+		 * the splitting dimension of the root of tree.
+		*/
+		kdtnode* max(kdtnode* tree, unsigned int dimension, unsigned int split)
 		{
-			kdtnode* return_value = tree;
+			kdtnode *return_value = tree, *candidate;
 
-			if (return_value)
+			if (tree)
 			{
-				while(return_value->m_right != nullptr)
-					return_value = return_value->m_right;
+				// The left subtree only holds lower or equal values on its splitting dimension
+				if (split != dimension)
+				{
+					candidate = max(tree->m_left, dimension, (split+1)%m_dimension);
+					if (candidate && candidate->m_value[dimension] > return_value->m_value[dimension])
+						return_value = candidate;
+				}
+
+				candidate = max(tree->m_right, dimension, (split+1)%m_dimension);
+				if (candidate && candidate->m_value[dimension] > return_value->m_value[dimension])
+					return_value = candidate;
 			}
 
 			return return_value;
 		}
 
-		int insert(kdtnode* prev_node, kdtnode* &tree, unsigned int dimension, const T<U> &value)
+		// V is T<U> (copied in the new node) or T<U>&& (moved in the new node)
+		template<typename V>
+		int insert(kdtnode* prev_node, kdtnode* &tree, unsigned int dimension, V &&value)
 		{
 			int return_value = 1;
+			bool descended = (tree != nullptr);
 
 			if (tree == nullptr)
 			{
-				tree = new kdtnode(prev_node, value);
+				tree = new kdtnode(prev_node, std::forward<V>(value));
 				if (tree)
 				{
 					m_size++;
@@ -149,88 +390,88 @@ template<template<typename> typename T, typename U> class kdt
 			}
 			else if (value[dimension] == tree->m_value[dimension]
 				 && value != tree->m_value)
-				return_value = insert(tree, tree->m_left, ++dimension%m_dimension, value);
+				return_value = insert(tree, tree->m_left, ++dimension%m_dimension, std::forward<V>(value));
 			else if (value[dimension] < tree->m_value[dimension])
-				return_value = insert(tree, tree->m_left, ++dimension%m_dimension, value);
+				return_value = insert(tree, tree->m_left, ++dimension%m_dimension, std::forward<V>(value));
 			else if (value[dimension] > tree->m_value[dimension])
-				return_value = insert(tree, tree->m_right, ++dimension%m_dimension, value);
+				return_value = insert(tree, tree->m_right, ++dimension%m_dimension, std::forward<V>(value));
+
+			// The value was inserted in the subtree of this node
+			if (return_value == 0 && descended)
+				tree->m_size++;
 
 			return return_value;
 		}
 
-		bool contains(const kdtnode* tree, unsigned int dimension, const T<U> &value)
+		/**
+		 * Iterative descent: the whole tuples are only compared when they are equal on the
+		 * splitting dimension, the lower or equal values being in the left subtree.
+		*/
+		bool contains(const kdtnode* tree, unsigned int dimension, const T<U> &value) const
 		{
-			bool return_value = false;
-
-			if (tree)
+			while (tree)
 			{
-				if (value == tree->m_value)
-					return_value = true;
-				else if (value[dimension] <= tree->m_value[dimension])
-					return_value = contains(tree->m_left,
-								++dimension%m_dimension,
-								value);
+				if (tree->m_value[dimension] < value[dimension])
+					tree = tree->m_right;
+				else if (value[dimension] < tree->m_value[dimension] || value != tree->m_value)
+					tree = tree->m_left;
 				else
-					return_value = contains(tree->m_right,
-								++dimension%m_dimension,
-								value);
+					return true;
+
+				dimension = (dimension+1)%m_dimension;
 			}
 
-			return return_value;
+			return false;
 		}
 
 		int erase(kdtnode* &tree, unsigned int dimension, const T<U> &value)
 		{
-			kdtnode* to_remove;
+			kdtnode* replacement;
 			int return_value = 1;
 
 			if (tree != nullptr)
 			{
-				if (value[dimension] == tree->m_value[dimension]
-				    && value != tree->m_value)
-					return_value = erase(tree->m_left,
-							     ++dimension%m_dimension,
-							     value);
-				else if (value[dimension] < tree->m_value[dimension])
-					return_value = erase(tree->m_left,
-							     ++dimension%m_dimension,
-							     value);
-				else if (value[dimension] > tree->m_value[dimension])
-					return_value = erase(tree->m_right,
-							     ++dimension%m_dimension,
-							     value);
-				else
+				if (value != tree->m_value)
+				{
+					if (value[dimension] <= tree->m_value[dimension])
+						return_value = erase(tree->m_left,
+								     (dimension+1)%m_dimension,
+								     value);
+					else
+						return_value = erase(tree->m_right,
+								     (dimension+1)%m_dimension,
+								     value);
+				}
+				else if (tree->m_left == nullptr && tree->m_right == nullptr)
 				{
 					return_value = 0;
-					to_remove = tree;
 					m_size--;
+					delete tree;
+					tree = nullptr;
+				}
+				else
+				{
+					/**
+					 * The value is replaced by the greatest value on the splitting
+					 * dimension in a subtree, which is then erased from this subtree.
+					 * A lone right subtree is moved to the left so that the left
+					 * subtree still holds the lower or equal values.
+					*/
 					if (tree->m_left == nullptr)
 					{
-						tree = tree->m_right;
-						if (tree)
-							tree->m_parent = to_remove->m_parent;
+						tree->m_left = tree->m_right;
+						tree->m_right = nullptr;
 					}
-					else if (tree->m_right == nullptr)
-					{
-						tree = tree->m_left;
-						if (tree)
-							tree->m_parent = to_remove->m_parent;
-					}
-					else
-					{
-						tree = max(tree->m_left);
-						tree->m_parent->m_right = tree->m_left;
-						if (tree->m_left)
-							tree->m_left->m_parent = tree->m_parent;
-
-						tree->m_parent = to_remove->m_parent;
-						tree->m_left = to_remove->m_left;
-						tree->m_left->m_parent = tree;
-						tree->m_right = to_remove->m_right;
-						tree->m_right->m_parent = tree;
-					}
-					delete to_remove;
+
+					replacement = max(tree->m_left, dimension, (dimension+1)%m_dimension);
+					tree->m_value = replacement->m_value;
+					return_value = erase(tree->m_left, (dimension+1)%m_dimension,
+							     tree->m_value);
 				}
+
+				// A value was erased from the subtree of this node, which is still there
+				if (return_value == 0 && tree)
+					tree->m_size--;
 			}
 
 			return return_value;
@@ -0,0 +1,62 @@
+#ifndef KDT_RANGE_HPP
+#define KDT_RANGE_HPP
+
+#include <vector>
+
+/**
+ * Orthogonal range over the values of a KD-tree whose components are of type U: each
+ * component is either free or bounded by an interval [low, high], one side of which may be
+ * open. A partial-match pattern is a range whose bound components have low == high.
+ * The bounds are given by address and must outlive the range, so that building a pattern
+ * does not copy any component.
+ * The KD-trees prune a subtree as soon as the bounds on its splitting dimension exclude it.
+*/
+template<typename U> class kdt_range
+{
+	public:
+		// Range over values of the given dimension where every component is free
+		kdt_range(unsigned int dimension): m_low(dimension, nullptr), m_high(dimension, nullptr) {}
+
+		/**
+		 * Partial-match pattern: the component i is bound to *pattern[i], or free if
+		 * pattern[i] is null.
+		*/
+		kdt_range(const std::vector<const U*> &pattern): m_low(pattern), m_high(pattern) {}
+
+		unsigned int dimension(void) const { return m_low.size(); }
+
+		void bind(unsigned int i, const U &value) { m_low[i] = m_high[i] = &value; }
+
+		// A null bound leaves its side of the interval open
+		void bound(unsigned int i, const U *low, const U *high)
+		{
+			m_low[i] = low;
+			m_high[i] = high;
+		}
+
+		void free(unsigned int i) { m_low[i] = m_high[i] = nullptr; }
+
+		// True if c is not lower than the lower bound of the component i
+		bool above_low(unsigned int i, const U &c) const { return !m_low[i] || !(c < *m_low[i]); }
+
+		// True if c is not greater than the upper bound of the component i
+		bool below_high(unsigned int i, const U &c) const { return !m_high[i] || !(*m_high[i] < c); }
+
+		// True if every component of value is within its interval
+		template<typename V> bool contains(const V &value) const
+		{
+			for (unsigned int i = 0; i < m_low.size(); ++i)
+			{
+				if (!above_low(i, value[i]) || !below_high(i, value[i]))
+					return false;
+			}
+
+			return true;
+		}
+
+	private:
+		std::vector<const U*> m_low;
+		std::vector<const U*> m_high;
+};
+
+#endif // KDT_RANGE_HPP
@@ -0,0 +1,319 @@
+#ifndef NODE_POOL_HPP
+#define NODE_POOL_HPP
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+/**
+ * Statistics of a node_pool, or of the lifetime of a pool_scope.
+*/
+struct pool_statistics
+{
+	// Number of blocks served by the slabs and given back to them
+	unsigned long long allocations;
+	unsigned long long deallocations;
+
+	// Number of blocks too large for the slabs, forwarded to operator new
+	unsigned long long large_allocations;
+
+	// Number of slabs allocated and freed
+	unsigned long long slabs_allocated;
+	unsigned long long slabs_freed;
+
+	// Bytes of the blocks in use, currently and at most
+	std::size_t bytes_in_use;
+	std::size_t peak_bytes_in_use;
+
+	// Bytes of the slabs held by the pool, currently and at most (its high-water mark)
+	std::size_t slab_bytes;
+	std::size_t peak_slab_bytes;
+};
+
+/**
+ * Slab allocator for the small blocks allocated in great numbers by the states: the nodes of
+ * the KD-trees and the values of the long tuples.
+ * The blocks are rounded up to a multiple of 16 bytes, and each size class is served by its
+ * own slabs of 64 KiB. A slab is carved sequentially, the blocks given back being chained in a
+ * free list of their slab and reused first. The slabs are aligned on their size, so the slab
+ * of a block is found by masking its address. When the last block of a slab is given back,
+ * the slab is freed at once, unless it is the last slab of its class with free room, which is
+ * kept until release() to avoid freeing and allocating a slab over and over. The nodes of a
+ * search are then given back to the system in whole slabs when the search ends.
+ *
+ * There is one pool per thread (see local()). A block must be given back by the thread which
+ * allocated it: each slab records the pool which carved it, checked by deallocate().
+*/
+class node_pool
+{
+	public:
+		static const std::size_t slab_size = 1 << 16;
+		static const std::size_t granularity = 16;
+		static const unsigned int nb_classes = 16;
+
+		// Largest block served by the slabs
+		static const std::size_t max_block = nb_classes*granularity;
+
+		// The pool of the calling thread
+		static node_pool& local(void)
+		{
+			static thread_local node_pool pool;
+			return pool;
+		}
+
+		node_pool(void): m_stats()
+		{
+			m_available.fill(nullptr);
+		}
+
+		node_pool(const node_pool &) = delete;
+		node_pool& operator=(const node_pool &) = delete;
+
+		/**
+		 * Only the empty slabs are freed, the slabs still holding blocks are left to the
+		 * owners of the blocks.
+		*/
+		~node_pool(void) { release(); }
+
+		void* allocate(std::size_t bytes)
+		{
+			unsigned int size_class;
+			std::size_t size;
+			slab *s;
+			void *block;
+
+			if (bytes > max_block)
+			{
+				m_stats.large_allocations++;
+				return ::operator new(bytes);
+			}
+
+			size_class = (bytes == 0 ? 0 : (bytes-1)/granularity);
+			size = (size_class+1)*granularity;
+
+			s = m_available[size_class];
+			if (!s)
+				s = new_slab(size_class);
+
+			if (s->m_free)
+			{
+				block = s->m_free;
+				s->m_free = *static_cast<void**>(block);
+			}
+			else
+			{
+				block = s->m_unused;
+				s->m_unused += size;
+			}
+
+			s->m_live++;
+
+			// A full slab leaves the list of its class until a block is given back
+			if (!s->m_free && s->m_unused+size > reinterpret_cast<char*>(s)+slab_size)
+				unlink(s);
+
+			m_stats.allocations++;
+			m_stats.bytes_in_use += size;
+			m_stats.peak_bytes_in_use = std::max(m_stats.peak_bytes_in_use, m_stats.bytes_in_use);
+
+			return block;
+		}
+
+		// bytes must be the size given to allocate() for this block
+		void deallocate(void *block, std::size_t bytes)
+		{
+			slab *s;
+
+			if (bytes > max_block)
+			{
+				::operator delete(block);
+				return;
+			}
+
+			s = reinterpret_cast<slab*>(reinterpret_cast<std::uintptr_t>(block) & ~(std::uintptr_t)(slab_size-1));
+			assert(("A block must be given back to the pool of the thread which allocated it.", s->m_owner == this));
+
+			*static_cast<void**>(block) = s->m_free;
+			s->m_free = block;
+			s->m_live--;
+
+			m_stats.deallocations++;
+			m_stats.bytes_in_use -= (s->m_class+1)*granularity;
+
+			if (!s->m_listed)
+				link(s);
+
+			if (s->m_live == 0 && (s->m_previous || s->m_next))
+				free_slab(s);
+		}
+
+		// Frees the empty slabs kept for reuse
+		void release(void)
+		{
+			slab *s;
+
+			for (unsigned int c = 0; c < nb_classes; ++c)
+			{
+				s = m_available[c];
+				while (s)
+				{
+					slab *next = s->m_next;
+					if (s->m_live == 0)
+						free_slab(s);
+					s = next;
+				}
+			}
+		}
+
+		const pool_statistics& statistics(void) const { return m_stats; }
+
+	private:
+		friend class pool_scope;
+
+		// Header at the beginning of each slab
+		struct slab
+		{
+			// Pool which allocated the slab
+			node_pool *m_owner;
+
+			// Neighbors in the list of the slabs of the class with free room
+			slab *m_previous;
+			slab *m_next;
+			bool m_listed;
+
+			// Blocks given back, chained through their first bytes
+			void *m_free;
+
+			// First block never served
+			char *m_unused;
+
+			// Number of blocks in use and size class of the blocks
+			unsigned int m_live;
+			unsigned int m_class;
+		};
+
+		static const std::size_t header_size = (sizeof(slab)+granularity-1)/granularity*granularity;
+
+		// For each class, the slabs with free room
+		std::array<slab*, nb_classes> m_available;
+
+		pool_statistics m_stats;
+
+		slab* new_slab(unsigned int size_class)
+		{
+			slab *s = static_cast<slab*>(std::aligned_alloc(slab_size, slab_size));
+
+			if (!s)
+				throw std::bad_alloc();
+
+			s->m_owner = this;
+			s->m_previous = s->m_next = nullptr;
+			s->m_listed = false;
+			s->m_free = nullptr;
+			s->m_unused = reinterpret_cast<char*>(s)+header_size;
+			s->m_live = 0;
+			s->m_class = size_class;
+			link(s);
+
+			m_stats.slabs_allocated++;
+			m_stats.slab_bytes += slab_size;
+			m_stats.peak_slab_bytes = std::max(m_stats.peak_slab_bytes, m_stats.slab_bytes);
+
+			return s;
+		}
+
+		void free_slab(slab *s)
+		{
+			unlink(s);
+			std::free(s);
+
+			m_stats.slabs_freed++;
+			m_stats.slab_bytes -= slab_size;
+		}
+
+		// Puts s at the head of the list of its class, where the next blocks are taken
+		void link(slab *s)
+		{
+			s->m_previous = nullptr;
+			s->m_next = m_available[s->m_class];
+			if (s->m_next)
+				s->m_next->m_previous = s;
+			m_available[s->m_class] = s;
+			s->m_listed = true;
+		}
+
+		void unlink(slab *s)
+		{
+			if (!s->m_listed)
+				return;
+
+			if (s->m_previous)
+				s->m_previous->m_next = s->m_next;
+			else
+				m_available[s->m_class] = s->m_next;
+			if (s->m_next)
+				s->m_next->m_previous = s->m_previous;
+
+			s->m_previous = s->m_next = nullptr;
+			s->m_listed = false;
+		}
+};
+
+/**
+ * Measures the use of the pool of the calling thread over the lifetime of the scope, e.g. a
+ * search. When the scope ends:
+ *	- stats (if not null) is filled with the numbers of allocations and slabs of the scope,
+ *	  the bytes still in use, and the peaks reached during the scope,
+ *	- the empty slabs kept by the pool are freed.
+ * Scopes may be nested, the peaks of the outer scope still account for the inner one.
+*/
+class pool_scope
+{
+	public:
+		pool_scope(pool_statistics *stats = nullptr): m_stats(stats), m_start(node_pool::local().m_stats)
+		{
+			pool_statistics &current = node_pool::local().m_stats;
+
+			current.peak_bytes_in_use = current.bytes_in_use;
+			current.peak_slab_bytes = current.slab_bytes;
+		}
+
+		pool_scope(const pool_scope &) = delete;
+		pool_scope& operator=(const pool_scope &) = delete;
+
+		~pool_scope(void)
+		{
+			node_pool &pool = node_pool::local();
+			pool_statistics &current = pool.m_stats;
+
+			pool.release();
+
+			if (m_stats)
+			{
+				m_stats->allocations = current.allocations - m_start.allocations;
+				m_stats->deallocations = current.deallocations - m_start.deallocations;
+				m_stats->large_allocations = current.large_allocations - m_start.large_allocations;
+				m_stats->slabs_allocated = current.slabs_allocated - m_start.slabs_allocated;
+				m_stats->slabs_freed = current.slabs_freed - m_start.slabs_freed;
+				m_stats->bytes_in_use = current.bytes_in_use;
+				m_stats->peak_bytes_in_use = current.peak_bytes_in_use;
+				m_stats->slab_bytes = current.slab_bytes;
+				m_stats->peak_slab_bytes = current.peak_slab_bytes;
+			}
+
+			current.peak_bytes_in_use = std::max(current.peak_bytes_in_use, m_start.peak_bytes_in_use);
+			current.peak_slab_bytes = std::max(current.peak_slab_bytes, m_start.peak_slab_bytes);
+		}
+
+	private:
+		pool_statistics *m_stats;
+
+		// Statistics of the pool when the scope began
+		pool_statistics m_start;
+};
+
+#endif // NODE_POOL_HPP
@@ -0,0 +1,83 @@
+#ifndef NOVELTY_TABLE_HPP
+#define NOVELTY_TABLE_HPP
+
+#include <cassert>
+#include <cstdint>
+#include <vector>
+
+/**
+ * Novelty table of width 1 or 2 over the facts of a task, indexed by fact indexes.
+ * The facts and the pairs of facts already seen are marked in bitsets: nb_facts bits for the
+ * facts, and nb_facts*(nb_facts-1)/2 bits for the pairs when the width is 2.
+ * The novelty of a state is the size of the smallest tuple of its facts which was never seen
+ * before, or width+1 if there is none.
+*/
+class novelty_table
+{
+	public:
+		novelty_table(unsigned int nb_facts, unsigned int width):
+			m_nb_facts(nb_facts), m_width(width),
+			m_facts((nb_facts+63)/64, 0),
+			m_pairs(width >= 2 ? ((unsigned long long)nb_facts*(nb_facts-1)/2+63)/64 : 0, 0)
+		{
+			assert(("Novelty tables only support the widths 1 and 2.", width == 1 || width == 2));
+		}
+
+		unsigned int width(void) const { return m_width; }
+
+		/**
+		 * Marks the facts (sorted in increasing order) of a state, and the pairs of them when
+		 * the width is 2, as seen.
+		 * @return The novelty of the state before it was inserted.
+		*/
+		unsigned int insert(const std::vector<unsigned int> &facts)
+		{
+			unsigned int novelty = m_width+1;
+
+			for (unsigned int f : facts)
+			{
+				if (set(m_facts, f))
+					novelty = 1;
+			}
+
+			if (m_width < 2)
+				return novelty;
+
+			for (unsigned int i = 0; i < facts.size(); ++i)
+			{
+				for (unsigned int j = i+1; j < facts.size(); ++j)
+				{
+					if (set(m_pairs, pair_index(facts[i], facts[j])) && novelty > 2)
+						novelty = 2;
+				}
+			}
+
+			return novelty;
+		}
+
+	private:
+		unsigned int m_nb_facts;
+		unsigned int m_width;
+		std::vector<std::uint64_t> m_facts;
+		std::vector<std::uint64_t> m_pairs;
+
+		// Index of the pair of facts f1 < f2 in the triangular bit matrix
+		unsigned long long pair_index(unsigned long long f1, unsigned long long f2) const
+		{
+			return f1*(2*m_nb_facts-f1-1)/2+(f2-f1-1);
+		}
+
+		// Sets a bit, returns true if it was not set before
+		static bool set(std::vector<std::uint64_t> &bits, unsigned long long index)
+		{
+			std::uint64_t mask = 1ULL << (index%64);
+
+			if (bits[index/64] & mask)
+				return false;
+
+			bits[index/64] |= mask;
+			return true;
+		}
+};
+
+#endif // NOVELTY_TABLE_HPP
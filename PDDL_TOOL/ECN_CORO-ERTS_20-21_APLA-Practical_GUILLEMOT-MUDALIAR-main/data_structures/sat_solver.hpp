@@ -0,0 +1,612 @@
+#ifndef SAT_SOLVER_HPP
+#define SAT_SOLVER_HPP
+
+#include <algorithm>
+#include <cassert>
+#include <climits>
+#include <cstddef>
+#include <vector>
+
+/**
+ * Incremental CDCL SAT solver.
+ * The literals of the variable v are 2v (positive) and 2v+1 (negative), see literal().
+ * The solver uses two watched literals, first-UIP conflict analysis with the minimization of
+ * the learned clauses, VSIDS decisions with phase saving and Luby restarts. The least active
+ * half of the learned clauses is dropped when there are too many of them.
+ * Clauses and variables may be added between the calls to solve(), which may also be given
+ * assumptions (literals which must hold for this call only): the learned clauses are kept
+ * from one call to the next, since they are implied by the clauses, which only grow.
+*/
+class sat_solver
+{
+	public:
+		sat_solver(void): m_ok(true), m_qhead(0), m_var_inc(1.0), m_clause_inc(1.0), m_max_learned(2000),
+				  m_nb_learned(0), m_conflicts(0), m_decisions(0), m_propagations(0), m_restarts(0) {}
+
+		static unsigned int literal(unsigned int v, bool positive = true) { return 2*v+(positive ? 0 : 1); }
+
+		static unsigned int negation(unsigned int lit) { return lit ^ 1; }
+
+		unsigned int nb_vars(void) const { return m_values.size(); }
+
+		unsigned int new_var(void)
+		{
+			unsigned int v = m_values.size();
+
+			m_values.push_back(unassigned);
+			m_levels.push_back(0);
+			m_reasons.push_back(no_reason);
+			m_activities.push_back(0.0);
+			m_phases.push_back(false);
+			m_seen.push_back(false);
+			m_heap_positions.push_back(UINT_MAX);
+			m_watches.resize(2*m_values.size());
+			heap_insert(v);
+
+			return v;
+		}
+
+		/**
+		 * Adds a clause, which is simplified with the assignments of the decision level 0.
+		 * @return False if the clauses became unsatisfiable.
+		*/
+		bool add_clause(std::vector<unsigned int> lits)
+		{
+			unsigned int i, j;
+
+			assert(("Clauses are added between the calls to solve().", m_trail_limits.empty()));
+
+			if (!m_ok)
+				return false;
+
+			std::sort(lits.begin(), lits.end());
+
+			// Removing the false and duplicated literals, satisfied clauses are dropped
+			for (i = j = 0; i < lits.size(); ++i)
+			{
+				if (value(lits[i]) == true_value || (i > 0 && lits[i] == negation(lits[i-1])))
+					return true;
+
+				if (value(lits[i]) != false_value && (j == 0 || lits[i] != lits[j-1]))
+					lits[j++] = lits[i];
+			}
+			lits.resize(j);
+
+			if (lits.empty())
+				return m_ok = false;
+
+			if (lits.size() == 1)
+			{
+				enqueue(lits[0], no_reason);
+				return m_ok = (propagate() == no_reason);
+			}
+
+			attach(lits, false);
+
+			return true;
+		}
+
+		/**
+		 * @return True if the clauses and the assumptions are satisfiable, the model is then
+		 *	   available through model_value().
+		*/
+		bool solve(const std::vector<unsigned int> &assumptions = std::vector<unsigned int>())
+		{
+			int status = 0;
+			unsigned int restart = 0;
+
+			m_model.clear();
+
+			if (!m_ok)
+				return false;
+
+			while (status == 0)
+			{
+				status = search(100*luby(restart++), assumptions);
+				if (status == 0)
+					m_restarts++;
+			}
+
+			backtrack(0);
+
+			return status > 0;
+		}
+
+		// Value of a variable in the last model found
+		bool model_value(unsigned int v) const { return m_model[v]; }
+
+		// Statistics
+		unsigned long long conflicts(void) const { return m_conflicts; }
+		unsigned long long decisions(void) const { return m_decisions; }
+		unsigned long long propagations(void) const { return m_propagations; }
+		unsigned long long restarts(void) const { return m_restarts; }
+		unsigned int nb_learned(void) const { return m_nb_learned; }
+
+	private:
+		static constexpr char true_value = 1;
+		static constexpr char false_value = 0;
+		static constexpr char unassigned = 2;
+		static constexpr unsigned int no_reason = UINT_MAX;
+
+		struct clause
+		{
+			std::vector<unsigned int> lits;
+			bool learned;
+			bool deleted;
+			double activity;
+		};
+
+		bool m_ok;
+
+		// Assignment of each variable, with its decision level and the clause which implied it
+		std::vector<char> m_values;
+		std::vector<unsigned int> m_levels;
+		std::vector<unsigned int> m_reasons;
+
+		std::vector<clause> m_clauses;
+
+		/**
+		 * Clauses watching each literal, with a blocker: another literal of the clause, which
+		 * satisfies it when true without reading the clause.
+		*/
+		struct watcher
+		{
+			unsigned int clause;
+			unsigned int blocker;
+		};
+
+		std::vector<std::vector<watcher>> m_watches;
+
+		std::vector<unsigned int> m_trail;
+		std::vector<unsigned int> m_trail_limits;
+		unsigned int m_qhead;
+
+		// VSIDS order: binary heap of the variables by decreasing activity
+		std::vector<double> m_activities;
+		std::vector<unsigned int> m_heap;
+		std::vector<unsigned int> m_heap_positions;
+		double m_var_inc;
+		double m_clause_inc;
+
+		std::vector<bool> m_phases;
+		std::vector<bool> m_seen;
+		std::vector<bool> m_model;
+
+		unsigned int m_max_learned;
+		unsigned int m_nb_learned;
+		unsigned long long m_conflicts;
+		unsigned long long m_decisions;
+		unsigned long long m_propagations;
+		unsigned long long m_restarts;
+
+		char value(unsigned int lit) const
+		{
+			char v = m_values[lit >> 1];
+			return v == unassigned ? unassigned : v ^ (char)(lit & 1);
+		}
+
+		unsigned int level(void) const { return m_trail_limits.size(); }
+
+		// The i-th term of the Luby sequence 1 1 2 1 1 2 4 ...
+		static unsigned int luby(unsigned int i)
+		{
+			unsigned int size = 1, seq = 0;
+
+			while (size < i+1)
+			{
+				seq++;
+				size = 2*size+1;
+			}
+
+			while (size-1 != i)
+			{
+				size = (size-1) >> 1;
+				seq--;
+				i = i % size;
+			}
+
+			return 1u << seq;
+		}
+
+		void enqueue(unsigned int lit, unsigned int reason)
+		{
+			m_values[lit >> 1] = (lit & 1) ? false_value : true_value;
+			m_levels[lit >> 1] = level();
+			m_reasons[lit >> 1] = reason;
+			m_trail.push_back(lit);
+		}
+
+		unsigned int attach(const std::vector<unsigned int> &lits, bool learned)
+		{
+			m_clauses.push_back({lits, learned, false, 0.0});
+			m_watches[lits[0]].push_back({(unsigned int)m_clauses.size()-1, lits[1]});
+			m_watches[lits[1]].push_back({(unsigned int)m_clauses.size()-1, lits[0]});
+
+			return m_clauses.size()-1;
+		}
+
+		// @return The index of a conflicting clause, or no_reason
+		unsigned int propagate(void)
+		{
+			unsigned int false_lit, c, i, j, k;
+
+			while (m_qhead < m_trail.size())
+			{
+				false_lit = negation(m_trail[m_qhead++]);
+				std::vector<watcher> &watches = m_watches[false_lit];
+				m_propagations++;
+
+				for (i = j = 0; i < watches.size(); ++i)
+				{
+					if (value(watches[i].blocker) == true_value)
+					{
+						watches[j++] = watches[i];
+						continue;
+					}
+
+					c = watches[i].clause;
+					std::vector<unsigned int> &lits = m_clauses[c].lits;
+
+					// The watchers of the deleted clauses are dropped lazily
+					if (m_clauses[c].deleted)
+						continue;
+
+					if (lits[0] == false_lit)
+						std::swap(lits[0], lits[1]);
+
+					if (value(lits[0]) == true_value)
+					{
+						watches[j++] = {c, lits[0]};
+						continue;
+					}
+
+					// Looking for a new literal to watch
+					for (k = 2; k < lits.size() && value(lits[k]) == false_value; ++k);
+
+					if (k < lits.size())
+					{
+						std::swap(lits[1], lits[k]);
+						m_watches[lits[1]].push_back({c, lits[0]});
+						continue;
+					}
+
+					watches[j++] = {c, lits[0]};
+
+					if (value(lits[0]) == false_value)
+					{
+						// Conflict, the remaining watchers are kept
+						for (++i; i < watches.size(); ++i)
+							watches[j++] = watches[i];
+						watches.resize(j);
+						m_qhead = m_trail.size();
+						return c;
+					}
+
+					enqueue(lits[0], c);
+				}
+
+				watches.resize(j);
+			}
+
+			return no_reason;
+		}
+
+		void backtrack(unsigned int target)
+		{
+			unsigned int v;
+
+			if (level() <= target)
+				return;
+
+			for (unsigned int i = m_trail.size(); i > m_trail_limits[target]; --i)
+			{
+				v = m_trail[i-1] >> 1;
+				m_phases[v] = (m_values[v] == true_value);
+				m_values[v] = unassigned;
+				m_reasons[v] = no_reason;
+				heap_insert(v);
+			}
+
+			m_trail.resize(m_trail_limits[target]);
+			m_trail_limits.resize(target);
+			m_qhead = m_trail.size();
+		}
+
+		void bump_variable(unsigned int v)
+		{
+			if ((m_activities[v] += m_var_inc) > 1e100)
+			{
+				for (double &a : m_activities)
+					a *= 1e-100;
+				m_var_inc *= 1e-100;
+			}
+
+			if (m_heap_positions[v] != UINT_MAX)
+				heap_up(m_heap_positions[v]);
+		}
+
+		void bump_clause(unsigned int c)
+		{
+			if ((m_clauses[c].activity += m_clause_inc) > 1e20)
+			{
+				for (clause &cl : m_clauses)
+					cl.activity *= 1e-20;
+				m_clause_inc *= 1e-20;
+			}
+		}
+
+		// A literal is redundant in a learned clause if its reason only has seen literals
+		bool redundant(unsigned int lit) const
+		{
+			unsigned int reason = m_reasons[lit >> 1];
+
+			if (reason == no_reason)
+				return false;
+
+			for (unsigned int l : m_clauses[reason].lits)
+			{
+				if ((l >> 1) != (lit >> 1) && !m_seen[l >> 1] && m_levels[l >> 1] > 0)
+					return false;
+			}
+
+			return true;
+		}
+
+		/**
+		 * First-UIP conflict analysis.
+		 * @return The learned clause, the asserting literal first and a literal of the
+		 *	   backtrack level second.
+		*/
+		std::vector<unsigned int> analyze(unsigned int conflict)
+		{
+			unsigned int counter = 0, lit = UINT_MAX, index = m_trail.size(), i, j, max_i;
+			std::vector<unsigned int> learned(1, 0);
+
+			do
+			{
+				bump_clause(conflict);
+
+				for (unsigned int l : m_clauses[conflict].lits)
+				{
+					if (lit != UINT_MAX && l == lit)
+						continue;
+
+					if (!m_seen[l >> 1] && m_levels[l >> 1] > 0)
+					{
+						m_seen[l >> 1] = true;
+						bump_variable(l >> 1);
+
+						if (m_levels[l >> 1] >= level())
+							counter++;
+						else
+							learned.push_back(l);
+					}
+				}
+
+				// Next literal of the trail to resolve on
+				while (!m_seen[m_trail[--index] >> 1]);
+				lit = m_trail[index];
+				conflict = m_reasons[lit >> 1];
+				m_seen[lit >> 1] = false;
+				counter--;
+			}
+			while (counter > 0);
+
+			learned[0] = negation(lit);
+
+			// Minimization
+			std::vector<unsigned int> original = learned;
+
+			for (i = j = 1; i < learned.size(); ++i)
+			{
+				if (!redundant(learned[i]))
+					learned[j++] = learned[i];
+			}
+			learned.resize(j);
+
+			for (i = 1; i < original.size(); ++i)
+				m_seen[original[i] >> 1] = false;
+
+			// The literal with the highest level goes second
+			max_i = 1;
+			for (i = 2; i < learned.size(); ++i)
+			{
+				if (m_levels[learned[i] >> 1] > m_levels[learned[max_i] >> 1])
+					max_i = i;
+			}
+			if (learned.size() > 1)
+				std::swap(learned[1], learned[max_i]);
+
+			m_var_inc /= 0.95;
+			m_clause_inc /= 0.999;
+
+			return learned;
+		}
+
+		// Drops the least active half of the learned clauses which are not reasons
+		void reduce_learned(void)
+		{
+			unsigned int c;
+			std::vector<unsigned int> learned;
+
+			for (c = 0; c < m_clauses.size(); ++c)
+			{
+				if (m_clauses[c].learned && !m_clauses[c].deleted && m_clauses[c].lits.size() > 2)
+					learned.push_back(c);
+			}
+
+			std::sort(learned.begin(), learned.end(), [this](unsigned int c1, unsigned int c2)
+				{
+					return m_clauses[c1].activity < m_clauses[c2].activity;
+				});
+
+			for (c = 0; c < learned.size()/2; ++c)
+			{
+				clause &cl = m_clauses[learned[c]];
+
+				if (value(cl.lits[0]) == true_value && m_reasons[cl.lits[0] >> 1] == learned[c])
+					continue;
+
+				cl.deleted = true;
+				cl.lits.clear();
+				cl.lits.shrink_to_fit();
+				m_nb_learned--;
+			}
+		}
+
+		/**
+		 * CDCL search until a model is found (1), the clauses and assumptions are proved
+		 * unsatisfiable (-1) or max_conflicts conflicts occurred (0).
+		*/
+		int search(unsigned int max_conflicts, const std::vector<unsigned int> &assumptions)
+		{
+			unsigned int conflict, nb_conflicts = 0, next = UINT_MAX, v;
+			std::vector<unsigned int> learned;
+
+			while (true)
+			{
+				conflict = propagate();
+
+				if (conflict != no_reason)
+				{
+					m_conflicts++;
+					nb_conflicts++;
+
+					if (level() == 0)
+					{
+						m_ok = false;
+						return -1;
+					}
+
+					learned = analyze(conflict);
+					backtrack(learned.size() > 1 ? m_levels[learned[1] >> 1] : 0);
+
+					if (learned.size() == 1)
+						enqueue(learned[0], no_reason);
+					else
+					{
+						enqueue(learned[0], attach(learned, true));
+						bump_clause(m_clauses.size()-1);
+						m_nb_learned++;
+					}
+
+					continue;
+				}
+
+				if (nb_conflicts >= max_conflicts)
+				{
+					backtrack(0);
+					return 0;
+				}
+
+				if (m_nb_learned >= m_max_learned+m_trail.size())
+				{
+					reduce_learned();
+					m_max_learned += m_max_learned/10;
+				}
+
+				// The assumptions are the first decisions
+				next = UINT_MAX;
+				while (level() < assumptions.size())
+				{
+					if (value(assumptions[level()]) == true_value)
+						m_trail_limits.push_back(m_trail.size());
+					else if (value(assumptions[level()]) == false_value)
+						return -1;
+					else
+					{
+						next = assumptions[level()];
+						break;
+					}
+				}
+
+				if (next == UINT_MAX)
+				{
+					// VSIDS decision
+					do
+					{
+						if (m_heap.empty())
+						{
+							m_model.resize(m_values.size());
+							for (v = 0; v < m_values.size(); ++v)
+								m_model[v] = (m_values[v] == true_value);
+							return 1;
+						}
+
+						v = heap_pop();
+					}
+					while (m_values[v] != unassigned);
+
+					next = literal(v, m_phases[v]);
+					m_decisions++;
+				}
+
+				m_trail_limits.push_back(m_trail.size());
+				enqueue(next, no_reason);
+			}
+		}
+
+		bool heap_less(unsigned int v1, unsigned int v2) const { return m_activities[v1] > m_activities[v2]; }
+
+		void heap_up(unsigned int i)
+		{
+			unsigned int v = m_heap[i];
+
+			while (i > 0 && heap_less(v, m_heap[(i-1)/2]))
+			{
+				m_heap[i] = m_heap[(i-1)/2];
+				m_heap_positions[m_heap[i]] = i;
+				i = (i-1)/2;
+			}
+
+			m_heap[i] = v;
+			m_heap_positions[v] = i;
+		}
+
+		void heap_down(unsigned int i)
+		{
+			unsigned int v = m_heap[i], child;
+
+			while (2*i+1 < m_heap.size())
+			{
+				child = 2*i+1;
+				if (child+1 < m_heap.size() && heap_less(m_heap[child+1], m_heap[child]))
+					child++;
+				if (!heap_less(m_heap[child], v))
+					break;
+
+				m_heap[i] = m_heap[child];
+				m_heap_positions[m_heap[i]] = i;
+				i = child;
+			}
+
+			m_heap[i] = v;
+			m_heap_positions[v] = i;
+		}
+
+		void heap_insert(unsigned int v)
+		{
+			if (m_heap_positions[v] != UINT_MAX)
+				return;
+
+			m_heap.push_back(v);
+			heap_up(m_heap.size()-1);
+		}
+
+		unsigned int heap_pop(void)
+		{
+			unsigned int v = m_heap[0];
+
+			m_heap[0] = m_heap.back();
+			m_heap_positions[m_heap[0]] = 0;
+			m_heap.pop_back();
+			m_heap_positions[v] = UINT_MAX;
+
+			if (!m_heap.empty())
+				heap_down(0);
+
+			return v;
+		}
+};
+
+#endif // SAT_SOLVER_HPP
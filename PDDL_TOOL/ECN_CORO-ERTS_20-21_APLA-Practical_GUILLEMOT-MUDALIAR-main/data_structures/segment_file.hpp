@@ -0,0 +1,168 @@
+#ifndef SEGMENT_FILE_HPP
+#define SEGMENT_FILE_HPP
+
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+/**
+ * Append-only file of fixed-size records, read back through a read-only memory mapping so
+ * that only the pages being scanned stay resident.
+ * The file is created (or truncated) by the constructor and kept on disk by the destructor,
+ * remove() deletes it.
+*/
+class segment_file
+{
+	public:
+		segment_file(const std::string &path, unsigned int record_size):
+			m_path(path), m_record_size(record_size), m_size(0),
+			m_map(nullptr), m_mapped_size(0)
+		{
+			m_fd = open(m_path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+			if (m_fd < 0)
+				throw std::runtime_error("Cannot create segment file " + m_path);
+		}
+
+		segment_file(const segment_file &other) = delete;
+		segment_file& operator=(const segment_file &other) = delete;
+
+		~segment_file(void)
+		{
+			unmap();
+			if (m_fd >= 0)
+				close(m_fd);
+		}
+
+		// Number of records
+		std::size_t size(void) const { return m_size; }
+
+		unsigned int record_size(void) const { return m_record_size; }
+
+		const std::string& path(void) const { return m_path; }
+
+		void append(const unsigned char *records, std::size_t count)
+		{
+			std::size_t to_write = count*m_record_size;
+			ssize_t written;
+
+			while (to_write > 0)
+			{
+				written = write(m_fd, records, to_write);
+				if (written < 0)
+					throw std::runtime_error("Cannot write segment file " + m_path);
+
+				records += written;
+				to_write -= written;
+			}
+
+			m_size += count;
+		}
+
+		// Maps the whole file, the mapping is refreshed if records were appended since
+		const unsigned char* map(void)
+		{
+			void* address;
+
+			if (m_map && m_mapped_size == m_size*m_record_size)
+				return m_map;
+
+			unmap();
+
+			if (m_size == 0)
+				return nullptr;
+
+			m_mapped_size = m_size*m_record_size;
+			address = mmap(nullptr, m_mapped_size, PROT_READ, MAP_SHARED, m_fd, 0);
+			if (address == MAP_FAILED)
+				throw std::runtime_error("Cannot map segment file " + m_path);
+
+			madvise(address, m_mapped_size, MADV_SEQUENTIAL);
+			m_map = static_cast<const unsigned char*>(address);
+
+			return m_map;
+		}
+
+		const unsigned char* record(std::size_t index) { return map()+index*m_record_size; }
+
+		void unmap(void)
+		{
+			if (m_map)
+				munmap(const_cast<unsigned char*>(m_map), m_mapped_size);
+
+			m_map = nullptr;
+			m_mapped_size = 0;
+		}
+
+		void remove(void)
+		{
+			unmap();
+			if (m_fd >= 0)
+				close(m_fd);
+
+			m_fd = -1;
+			unlink(m_path.c_str());
+		}
+
+	private:
+		std::string m_path;
+		unsigned int m_record_size;
+		std::size_t m_size;
+		int m_fd;
+		const unsigned char* m_map;
+		std::size_t m_mapped_size;
+};
+
+/**
+ * Directory with a unique name, created in a parent directory to hold the segment files of a
+ * search. The destructor deletes the files left in it, then the directory itself, so that
+ * nothing is left behind when the search returns or throws. The segment files must be
+ * destroyed (or removed) before it.
+*/
+class scratch_directory
+{
+	public:
+		scratch_directory(const std::string &parent, const std::string &prefix)
+		{
+			std::string pattern = parent + "/" + prefix + "_XXXXXX";
+
+			if (!mkdtemp(&pattern[0]))
+				throw std::runtime_error("Cannot create a directory in " + parent);
+
+			m_path = pattern;
+		}
+
+		scratch_directory(const scratch_directory &other) = delete;
+		scratch_directory& operator=(const scratch_directory &other) = delete;
+
+		~scratch_directory(void)
+		{
+			DIR* dir = opendir(m_path.c_str());
+			struct dirent* entry;
+			std::string name;
+
+			if (dir)
+			{
+				while ((entry = readdir(dir)) != nullptr)
+				{
+					name = entry->d_name;
+					if (name != "." && name != "..")
+						unlink((m_path + "/" + name).c_str());
+				}
+				closedir(dir);
+			}
+
+			rmdir(m_path.c_str());
+		}
+
+		const std::string& path(void) const { return m_path; }
+
+	private:
+		std::string m_path;
+};
+
+#endif // SEGMENT_FILE_HPP
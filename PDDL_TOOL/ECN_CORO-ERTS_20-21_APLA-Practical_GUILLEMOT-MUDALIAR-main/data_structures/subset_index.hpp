@@ -0,0 +1,139 @@
+#ifndef SUBSET_INDEX_HPP
+#define SUBSET_INDEX_HPP
+
+#include <algorithm>
+#include <vector>
+
+/**
+ * Index over sets of unsigned integers (e.g. sets of fact indexes) answering subsumption
+ * queries: finding a stored set included in, or including, a given set.
+ * Every element has the list of the stored sets containing it, so that a query only visits
+ * the sets sharing elements with it.
+ * The sets must be sorted in increasing order.
+*/
+class subset_index
+{
+	public:
+		subset_index(void) {}
+
+		unsigned int size(void) const { return m_sets.size(); }
+
+		const std::vector<unsigned int>& operator[](unsigned int index) const { return m_sets[index]; }
+
+		unsigned int insert(const std::vector<unsigned int> &set)
+		{
+			unsigned int index = m_sets.size();
+
+			m_sets.push_back(set);
+			m_counts.push_back(0);
+
+			if (set.empty())
+				m_empty_sets.push_back(index);
+
+			for (unsigned int elt : set)
+			{
+				if (elt >= m_postings.size())
+					m_postings.resize(elt+1);
+				m_postings[elt].push_back(index);
+			}
+
+			return index;
+		}
+
+		/**
+		 * @arg query A sorted set
+		 * @arg accept Predicate called on the index of every candidate set, to check
+		 *	       additional conditions
+		 * @return The index of a stored set included in query and accepted, or -1.
+		*/
+		template<typename F> int find_subset(const std::vector<unsigned int> &query, F accept)
+		{
+			int found = -1;
+
+			for (unsigned int index : m_empty_sets)
+			{
+				if (accept(index))
+					return index;
+			}
+
+			// Counting the elements of query in each stored set
+			for (unsigned int elt : query)
+			{
+				if (elt >= m_postings.size())
+					continue;
+
+				for (unsigned int index : m_postings[elt])
+				{
+					if (m_counts[index]++ == 0)
+						m_touched.push_back(index);
+
+					if (found < 0 && m_counts[index] == m_sets[index].size() && accept(index))
+						found = index;
+				}
+
+				if (found >= 0)
+					break;
+			}
+
+			for (unsigned int index : m_touched)
+				m_counts[index] = 0;
+			m_touched.clear();
+
+			return found;
+		}
+
+		/**
+		 * @arg query A sorted set
+		 * @arg accept Predicate called on the index of every candidate set, to check
+		 *	       additional conditions
+		 * @return The index of a stored set including query and accepted, or -1.
+		*/
+		template<typename F> int find_superset(const std::vector<unsigned int> &query, F accept)
+		{
+			unsigned int index;
+			const std::vector<unsigned int> *shortest = nullptr;
+
+			if (query.empty())
+			{
+				for (index = 0; index < m_sets.size(); ++index)
+				{
+					if (accept(index))
+						return index;
+				}
+				return -1;
+			}
+
+			// Only the sets containing the rarest element of query are candidates
+			for (unsigned int elt : query)
+			{
+				if (elt >= m_postings.size())
+					return -1;
+				if (!shortest || m_postings[elt].size() < shortest->size())
+					shortest = &m_postings[elt];
+			}
+
+			for (unsigned int candidate : *shortest)
+			{
+				if (std::includes(m_sets[candidate].begin(), m_sets[candidate].end(),
+						  query.begin(), query.end())
+				    && accept(candidate))
+					return candidate;
+			}
+
+			return -1;
+		}
+
+	private:
+		std::vector<std::vector<unsigned int>> m_sets;
+
+		// Indexes of the stored sets containing each element
+		std::vector<std::vector<unsigned int>> m_postings;
+
+		std::vector<unsigned int> m_empty_sets;
+
+		// Counters used by find_subset
+		std::vector<unsigned int> m_counts;
+		std::vector<unsigned int> m_touched;
+};
+
+#endif // SUBSET_INDEX_HPP
@@ -1,48 +1,119 @@
 #ifndef TUPLE_HPP
 #define TUPLE_HPP
 
+#include "node_pool.hpp"
+
 #include <algorithm>
+#include <array>
+#include <cstddef>
 #include <initializer_list>
 #include <iterator>
+#include <memory>
 #include <vector>
 
-template<typename T> class tuple
+/**
+ * Fixed-size sequence of values. Up to N values are stored inline in the tuple, so that the
+ * tuples of the usual arities (the grounded predicates) need no allocation and lie in the
+ * memory of their owner (e.g. a KD-tree node). Longer tuples store their values in a block of
+ * the pool of the thread (see node_pool).
+*/
+template<typename T, unsigned int N = 4> class tuple
 {
 	public:
 		/** METHODS **/
 
 		// Constructors
-		tuple(void): m_dimension(0), m_values(nullptr) {}
+		tuple(void): m_dimension(0), m_values(m_buffer) {}
 
-		tuple(std::initializer_list<T> values): m_dimension(values.size())
+		tuple(std::initializer_list<T> values)
 		{
-			m_values = new T[m_dimension];
+			allocate(values.size());
 			std::copy(values.begin(), values.end(), m_values);
 		}
 
-		tuple(std::vector<T> values): m_dimension(values.size())
+		tuple(const std::vector<T> &values)
 		{
-			m_values = new T[m_dimension];
+			allocate(values.size());
 			std::copy(values.begin(), values.end(), m_values);
 		}
 
+		tuple(std::vector<T> &&values)
+		{
+			allocate(values.size());
+			std::move(values.begin(), values.end(), m_values);
+		}
+
+		template<std::size_t M> tuple(const std::array<T, M> &values)
+		{
+			allocate(M);
+			std::copy(values.begin(), values.end(), m_values);
+		}
+
+		// Copy constructor, the values are copied
+		tuple(const tuple &other)
+		{
+			allocate(other.m_dimension);
+			std::copy(other.m_values, other.m_values+m_dimension, m_values);
+		}
+
+		/**
+		 * Move constructor, the values are taken from other (moved one by one when they
+		 * are stored inline) which is left empty
+		*/
+		tuple(tuple &&other) noexcept: m_dimension(other.m_dimension)
+		{
+			take(other);
+		}
+
+		// Destructor
+		~tuple(void) { release(); }
+
 		// Getter
 		unsigned int size(void) const { return m_dimension; }
 
+		// True if the values are stored inline
+		bool is_inline(void) const { return m_values == m_buffer; }
+
 		// Operators
-		tuple operator=(std::initializer_list<T> values)
+		tuple& operator=(std::initializer_list<T> values)
 		{
-			if (m_values)
-				delete[] m_values;
-
-			m_dimension = values.size();
-			m_values = new T[m_dimension];
+			release();
+			allocate(values.size());
 			std::copy(values.begin(), values.end(), m_values);
 
 			return *this;
 		}
 
-		const T operator[](unsigned int index) const { return m_values[index]; }
+		tuple& operator=(const tuple &other)
+		{
+			if (this != &other)
+			{
+				// The block of the pool is reused when the dimensions match
+				if (m_dimension != other.m_dimension)
+				{
+					release();
+					allocate(other.m_dimension);
+				}
+
+				std::copy(other.m_values, other.m_values+m_dimension, m_values);
+			}
+
+			return *this;
+		}
+
+		tuple& operator=(tuple &&other) noexcept
+		{
+			if (this != &other)
+			{
+				release();
+				m_dimension = other.m_dimension;
+				take(other);
+			}
+
+			return *this;
+		}
+
+		const T& operator[](unsigned int index) const { return m_values[index]; }
 
 		bool operator==(const tuple &t) const
 		{
@@ -80,7 +151,7 @@ template<typename T> class tuple
 				inline iterator& operator--(void) { --m_ptr; return *this; }
 				inline iterator operator++(int) const { iterator tmp(*this); ++m_ptr; return tmp; }
 				inline iterator operator--(int) const { iterator tmp(*this); --m_ptr; return tmp; }
-				inline difference_type operator-(const iterator& rhs) const { return iterator(m_ptr-rhs.ptr); }
+				inline difference_type operator-(const iterator& rhs) const { return m_ptr-rhs.m_ptr; }
 				inline iterator operator+(difference_type rhs) const { return iterator(m_ptr+rhs); }
 				inline iterator operator-(difference_type rhs) const { return iterator(m_ptr-rhs); }
 				friend inline iterator operator+(difference_type lhs, const iterator& rhs) { return iterator(lhs+rhs.m_ptr); }
@@ -103,7 +174,49 @@ template<typename T> class tuple
 	private:
 		/** ATTRIBUTES **/
 		unsigned int m_dimension;
+
+		// The values, pointing either to m_buffer or to a block of the pool
 		T* m_values;
+		T m_buffer[N];
+
+		/** METHODS **/
+		void allocate(unsigned int dimension)
+		{
+			m_dimension = dimension;
+			m_values = m_buffer;
+
+			if (dimension > N)
+			{
+				m_values = static_cast<T*>(node_pool::local().allocate(dimension*sizeof(T)));
+				std::uninitialized_value_construct_n(m_values, dimension);
+			}
+		}
+
+		// Destroys the values stored in the pool, m_dimension being still their number
+		void release(void)
+		{
+			if (m_values != m_buffer)
+			{
+				std::destroy_n(m_values, m_dimension);
+				node_pool::local().deallocate(m_values, m_dimension*sizeof(T));
+			}
+			m_values = m_buffer;
+		}
+
+		// Takes the values of other, m_dimension being already set to its dimension
+		void take(tuple &other) noexcept
+		{
+			if (other.m_values == other.m_buffer)
+			{
+				m_values = m_buffer;
+				std::move(other.m_buffer, other.m_buffer+m_dimension, m_buffer);
+			}
+			else
+				m_values = other.m_values;
+
+			other.m_dimension = 0;
+			other.m_values = other.m_buffer;
+		}
 };
 
 #endif // TUPLE_HPP
@@ -8,6 +8,16 @@ unsigned int action::nbparams(void) { return m_nbparams; }
 
 unsigned int action::cost(void) { return m_cost; }
 
+const std::vector<triplet<int, bool, std::vector<int>>>& action::preconds(void) const { return m_preconds; }
+
+const std::vector<triplet<int, bool, std::vector<int>>>& action::effects(void) const { return m_effects; }
+
+const std::vector<std::pair<std::vector<triplet<int, bool, std::vector<int>>>,
+			    std::vector<triplet<int, bool, std::vector<int>>>>>& action::cond_effects(void) const
+{
+	return m_cond_effects;
+}
+
 void action::set_cost(unsigned int cost) { m_cost = cost; }
 
 void action::add_param(const symbol &param_name)
@@ -69,15 +79,154 @@ void action::add_conditional_effect(const std::vector<triplet<int, bool, std::ve
 	m_cond_effects.push_back(std::make_pair(gd_preconds, gd_effects));
 }
 
-state action::apply(const state &target, std::vector<symbol> act_params)
+/**
+ * Grounds a list of pre-conditions or effects with the parameters of the action.
+*/
+static std::vector<triplet<int, bool, tuple<symbol>>> ground_literals(
+	const std::vector<triplet<int, bool, std::vector<int>>> &literals,
+	const std::vector<symbol> &act_params)
+{
+	std::vector<triplet<int, bool, tuple<symbol>>> grounded;
+	std::vector<symbol> predic_params;
+
+	for (triplet<int, bool, std::vector<int>> literal : literals)
+	{
+		for (int i : std::get<2>(literal))
+			predic_params.push_back(act_params[i]);
+
+		grounded.push_back(triplet<int, bool, tuple<symbol>>(std::get<0>(literal),
+				   std::get<1>(literal), predic_params));
+
+		predic_params.clear();
+	}
+
+	return grounded;
+}
+
+std::vector<triplet<int, bool, tuple<symbol>>> action::ground_preconds(const std::vector<symbol> &act_params)
+{
+	assert(("Incorrect number of parameters.", act_params.size() == m_nbparams));
+	return ground_literals(m_preconds, act_params);
+}
+
+std::vector<triplet<int, bool, tuple<symbol>>> action::ground_effects(const std::vector<symbol> &act_params)
+{
+	assert(("Incorrect number of parameters.", act_params.size() == m_nbparams));
+	return ground_literals(m_effects, act_params);
+}
+
+std::vector<std::pair<std::vector<triplet<int, bool, tuple<symbol>>>,
+		      std::vector<triplet<int, bool, tuple<symbol>>>>>
+	action::ground_cond_effects(const std::vector<symbol> &act_params)
+{
+	std::vector<std::pair<std::vector<triplet<int, bool, tuple<symbol>>>,
+			      std::vector<triplet<int, bool, tuple<symbol>>>>> grounded;
+
+	assert(("Incorrect number of parameters.", act_params.size() == m_nbparams));
+
+	for (std::pair<std::vector<triplet<int, bool, std::vector<int>>>,
+		       std::vector<triplet<int, bool, std::vector<int>>>> cond_eff : m_cond_effects)
+		grounded.push_back(std::make_pair(ground_literals(cond_eff.first, act_params),
+						  ground_literals(cond_eff.second, act_params)));
+
+	return grounded;
+}
+
+/**
+ * Extends the partial binding of the parameters so that the positive pre-conditions from the
+ * given one hold in target, and adds the complete bindings to params. The bound parameters
+ * point to the components of the grounded predicates of target or to objects.
+*/
+static void extend_binding(const std::vector<const triplet<int, bool, std::vector<int>>*> &preconds,
+			   unsigned int precond, const state &target, const std::vector<symbol> &objects,
+			   std::vector<const symbol*> &binding, std::vector<std::vector<symbol>> &params)
+{
+	unsigned int i;
+
+	if (precond == preconds.size())
+	{
+		// The parameters in no positive pre-condition range over the objects
+		for (i = 0; i < binding.size() && binding[i]; ++i);
+
+		if (i < binding.size())
+		{
+			for (const symbol &obj : objects)
+			{
+				binding[i] = &obj;
+				extend_binding(preconds, precond, target, objects, binding, params);
+			}
+			binding[i] = nullptr;
+		}
+		else
+		{
+			params.emplace_back();
+			for (const symbol *s : binding)
+				params.back().push_back(*s);
+		}
+
+		return;
+	}
+
+	const std::vector<int> &precond_params = std::get<2>(*preconds[precond]);
+	kdt_range<symbol> pattern(precond_params.size());
+
+	for (i = 0; i < precond_params.size(); ++i)
+	{
+		if (binding[precond_params[i]])
+			pattern.bind(i, *binding[precond_params[i]]);
+	}
+
+	target.match(std::get<0>(*preconds[precond]), pattern, [&](const auto &value)
+		{
+			bool consistent = true;
+			unsigned int j;
+			std::vector<int> bound;
+
+			// A parameter may appear twice in the pre-condition
+			for (j = 0; j < precond_params.size() && consistent; ++j)
+			{
+				if (!binding[precond_params[j]])
+				{
+					binding[precond_params[j]] = &value[j];
+					bound.push_back(precond_params[j]);
+				}
+				else
+					consistent = (*binding[precond_params[j]] == value[j]);
+			}
+
+			if (consistent)
+				extend_binding(preconds, precond+1, target, objects, binding, params);
+
+			for (int p : bound)
+				binding[p] = nullptr;
+		});
+}
+
+std::vector<std::vector<symbol>> action::matching_params(const state &target, const std::vector<symbol> &objects)
+{
+	std::vector<const triplet<int, bool, std::vector<int>>*> positive;
+	std::vector<const symbol*> binding(m_nbparams, nullptr);
+	std::vector<std::vector<symbol>> to_return;
+
+	for (const triplet<int, bool, std::vector<int>> &precond : m_preconds)
+	{
+		if (!std::get<1>(precond))
+			positive.push_back(&precond);
+	}
+
+	extend_binding(positive, 0, target, objects, binding, to_return);
+
+	return to_return;
+}
+
+state action::apply(const state &target, const std::vector<symbol> &act_params)
 {
 	assert(("Incorrect number of parameters.", act_params.size() == m_nbparams));
 
 	bool fullfil_preconds = true;
-	state obtained;
 	std::vector<symbol> predic_params;
 
-	for (triplet<int, bool, std::vector<int>> precond : m_preconds)
+	for (const triplet<int, bool, std::vector<int>> &precond : m_preconds)
 	{
 		for (int i : std::get<2>(precond))
 			predic_params.push_back(act_params[i]);
@@ -90,54 +239,56 @@ state action::apply(const state &target, std::vector<symbol> act_params)
 		predic_params.clear();
 	}
 
-	if (fullfil_preconds)
+	// The invalid state
+	if (!fullfil_preconds)
+		return state();
+
+	// Shares the KD-trees of target, the effects only copying the paths they modify
+	state obtained(target);
+
+	for (const triplet<int, bool, std::vector<int>> &effect : m_effects)
+	{
+		for (int i : std::get<2>(effect))
+			predic_params.push_back(act_params[i]);
+
+		if (std::get<1>(effect))
+			obtained.erase(std::get<0>(effect), predic_params);
+		else
+			obtained.add(std::get<0>(effect), predic_params);
+
+		predic_params.clear();
+	}
+
+	for (const std::pair<std::vector<triplet<int, bool, std::vector<int>>>,
+			     std::vector<triplet<int, bool, std::vector<int>>>> &cond_eff : m_cond_effects)
 	{
-		obtained = target;
+		fullfil_preconds = true;
 
-		for (triplet<int, bool, std::vector<int>> effect : m_effects)
+		for (const triplet<int, bool, std::vector<int>> &precond : cond_eff.first)
 		{
-			for (int i : std::get<2>(effect))
+			for (int i : std::get<2>(precond))
 				predic_params.push_back(act_params[i]);
 
-			if (std::get<1>(effect))
-				obtained.erase(std::get<0>(effect), predic_params);
+			if (std::get<1>(precond))
+				fullfil_preconds &= !target.contains(std::get<0>(precond), predic_params);
 			else
-				obtained.add(std::get<0>(effect), predic_params);
+				fullfil_preconds &= target.contains(std::get<0>(precond), predic_params);
 
 			predic_params.clear();
-		}
 
-		for (std::pair<std::vector<triplet<int, bool, std::vector<int>>>,
-			       std::vector<triplet<int, bool, std::vector<int>>>> cond_eff : m_cond_effects)
-		{
-			fullfil_preconds = true;
-
-			for (triplet<int, bool, std::vector<int>> precond : cond_eff.first)
+			if (fullfil_preconds)
 			{
-				for (int i : std::get<2>(precond))
-					predic_params.push_back(act_params[i]);
-
-				if (std::get<1>(precond))
-					fullfil_preconds &= !target.contains(std::get<0>(precond), predic_params);
-				else
-					fullfil_preconds &= target.contains(std::get<0>(precond), predic_params);
+				for (const triplet<int, bool, std::vector<int>> &effect : cond_eff.second)
+				{
+					for (int i : std::get<2>(effect))
+						predic_params.push_back(act_params[i]);
 
-				predic_params.clear();
+					if (std::get<1>(effect))
+						obtained.erase(std::get<0>(effect), predic_params);
+					else
+						obtained.add(std::get<0>(effect), predic_params);
 
-				if (fullfil_preconds)
-				{
-					for (triplet<int, bool, std::vector<int>> effect : cond_eff.second)
-					{
-						for (int i : std::get<2>(effect))
-							predic_params.push_back(act_params[i]);
-
-						if (std::get<1>(effect))
-							obtained.erase(std::get<0>(effect), predic_params);
-						else
-							obtained.add(std::get<0>(effect), predic_params);
-
-						predic_params.clear();
-					}
+					predic_params.clear();
 				}
 			}
 		}
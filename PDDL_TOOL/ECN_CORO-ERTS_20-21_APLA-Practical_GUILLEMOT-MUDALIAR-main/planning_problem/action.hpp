@@ -44,6 +44,18 @@ class action
 		unsigned int nbparams(void);
 		unsigned int cost(void);
 
+		/**
+		 * Pre-conditions, effects and conditional effects of the schema. The items in a
+		 * triplet correspond to:
+		 *	- the index of the predicate's KD-tree in a state,
+		 *	- true if the pre-condition or effect is negative,
+		 *	- the indexes of the parameters of the action given to the predicate.
+		*/
+		const std::vector<triplet<int, bool, std::vector<int>>>& preconds(void) const;
+		const std::vector<triplet<int, bool, std::vector<int>>>& effects(void) const;
+		const std::vector<std::pair<std::vector<triplet<int, bool, std::vector<int>>>,
+					    std::vector<triplet<int, bool, std::vector<int>>>>>& cond_effects(void) const;
+
 		// Setter
 		void set_cost(unsigned int cost);
 
@@ -56,8 +68,29 @@ class action
 		void add_conditional_effect(const std::vector<triplet<int, bool, std::vector<symbol>>> &cond_eff_preconds,
 					    const std::vector<triplet<int, bool, std::vector<symbol>>> &cond_eff_eff);
 
+		/**
+		 * Grounded pre-conditions and effects. The items in a triplet correspond to:
+		 *	- the index of the predicate's KD-tree in a state,
+		 *	- true if the pre-condition or effect is negative,
+		 *	- the grounded parameters of the predicate.
+		*/
+		std::vector<triplet<int, bool, tuple<symbol>>> ground_preconds(const std::vector<symbol> &act_params);
+		std::vector<triplet<int, bool, tuple<symbol>>> ground_effects(const std::vector<symbol> &act_params);
+		std::vector<std::pair<std::vector<triplet<int, bool, tuple<symbol>>>,
+				      std::vector<triplet<int, bool, tuple<symbol>>>>>
+			ground_cond_effects(const std::vector<symbol> &act_params);
+
+		/**
+		 * The parameters of the action for which its positive pre-conditions hold in target,
+		 * in no particular order. They are found by partial-match queries on the KD-trees of
+		 * target, the parameters bound by the previous pre-conditions being fixed in the
+		 * pattern of the next one. The parameters in no positive pre-condition range over
+		 * objects. The other pre-conditions are left to apply().
+		*/
+		std::vector<std::vector<symbol>> matching_params(const state &target, const std::vector<symbol> &objects);
+
 		// Others
-		state apply(const state &target, std::vector<symbol> act_params);
+		state apply(const state &target, const std::vector<symbol> &act_params);
 		action delete_relax(void);
 };
 
@@ -0,0 +1,168 @@
+#include "delta_store.hpp"
+
+delta_store::delta_store(unsigned int checkpoint_interval, unsigned int cache_size):
+	m_checkpoint_interval(checkpoint_interval), m_cache_size(cache_size), m_checkpoints(0),
+	m_delta_atoms(0), m_cache_hits(0), m_cache_misses(0), m_applied_deltas(0) {}
+
+unsigned int delta_store::size(void) const { return m_entries.size(); }
+
+unsigned int delta_store::checkpoint_interval(void) const { return m_checkpoint_interval; }
+
+unsigned int delta_store::cache_size(void) const { return m_cache_size; }
+
+unsigned int delta_store::nb_checkpoints(void) const { return m_checkpoints; }
+
+unsigned long long delta_store::nb_delta_atoms(void) const { return m_delta_atoms; }
+
+unsigned long long delta_store::nb_cache_hits(void) const { return m_cache_hits; }
+
+unsigned long long delta_store::nb_cache_misses(void) const { return m_cache_misses; }
+
+unsigned long long delta_store::nb_applied_deltas(void) const { return m_applied_deltas; }
+
+void delta_store::remember(unsigned int index, const state &s)
+{
+	std::unordered_map<unsigned int, std::list<std::pair<unsigned int, state>>::iterator>::iterator it;
+
+	if (m_cache_size == 0)
+		return;
+
+	it = m_cached.find(index);
+	if (it != m_cached.end())
+	{
+		m_cache.splice(m_cache.begin(), m_cache, it->second);
+		return;
+	}
+
+	// The copy shares the KD-trees of s, so caching a state costs little memory
+	m_cache.emplace_front(index, s);
+	m_cached.insert({index, m_cache.begin()});
+
+	if (m_cache.size() > m_cache_size)
+	{
+		m_cached.erase(m_cache.back().first);
+		m_cache.pop_back();
+	}
+}
+
+unsigned int delta_store::insert(const state &s)
+{
+	unsigned int index = m_entries.size();
+
+	m_entries.push_back({index, 0, std::unique_ptr<state>(new state(s)), {}, {}});
+	m_indexes.insert({s.hash(), index});
+	m_checkpoints++;
+	remember(index, s);
+
+	return index;
+}
+
+unsigned int delta_store::insert(const state &s, unsigned int base)
+{
+	unsigned int index = m_entries.size();
+	entry e;
+	state base_state;
+
+	assert(("Base state out of the store.", base < m_entries.size()));
+
+	e.base = base;
+	e.depth = m_entries[base].depth+1;
+
+	if (e.depth >= m_checkpoint_interval)
+		return insert(s);
+
+	base_state = get(base);
+
+	// The predicates are only copied in the delta
+	for (const std::pair<unsigned int, params_view> &a : s)
+	{
+		if (!base_state.contains(a.first, a.second))
+			e.added.push_back({a.first, a.second});
+	}
+
+	for (const std::pair<unsigned int, params_view> &a : base_state)
+	{
+		if (!s.contains(a.first, a.second))
+			e.deleted.push_back({a.first, a.second});
+	}
+
+	e.added.shrink_to_fit();
+	e.deleted.shrink_to_fit();
+	m_delta_atoms += e.added.size()+e.deleted.size();
+
+	m_entries.push_back(std::move(e));
+	m_indexes.insert({s.hash(), index});
+	remember(index, s);
+
+	return index;
+}
+
+int delta_store::find(const state &s)
+{
+	auto range = m_indexes.equal_range(s.hash());
+
+	for (auto it = range.first; it != range.second; ++it)
+	{
+		if (get(it->second) == s)
+			return it->second;
+	}
+
+	return -1;
+}
+
+state delta_store::get(unsigned int index)
+{
+	unsigned int node = index;
+	std::vector<unsigned int> chain;
+	std::unordered_map<unsigned int, std::list<std::pair<unsigned int, state>>::iterator>::iterator it;
+	state to_return;
+
+	assert(("Index out of the store.", index < m_entries.size()));
+
+	// Walking the deltas back to a cached state or to a checkpoint
+	for (it = m_cached.find(node); it == m_cached.end() && !m_entries[node].full; it = m_cached.find(node))
+	{
+		chain.push_back(node);
+		node = m_entries[node].base;
+	}
+
+	if (it != m_cached.end())
+	{
+		to_return = it->second->second;
+		if (node == index)
+			m_cache_hits++;
+		else
+			m_cache_misses++;
+	}
+	else
+	{
+		to_return = *m_entries[node].full;
+		m_cache_misses++;
+	}
+
+	for (auto c = chain.rbegin(); c != chain.rend(); ++c)
+	{
+		for (const atom &a : m_entries[*c].deleted)
+			to_return.erase(a.first, a.second);
+		for (const atom &a : m_entries[*c].added)
+			to_return.add(a.first, a.second);
+	}
+	m_applied_deltas += chain.size();
+
+	remember(index, to_return);
+
+	return to_return;
+}
+
+void delta_store::clear(void)
+{
+	m_entries.clear();
+	m_indexes.clear();
+	m_cache.clear();
+	m_cached.clear();
+	m_checkpoints = 0;
+	m_delta_atoms = 0;
+	m_cache_hits = 0;
+	m_cache_misses = 0;
+	m_applied_deltas = 0;
+}
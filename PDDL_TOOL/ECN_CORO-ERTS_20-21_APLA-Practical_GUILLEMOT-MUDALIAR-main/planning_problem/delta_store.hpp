@@ -0,0 +1,127 @@
+#ifndef DELTA_STORE_HPP
+#define DELTA_STORE_HPP
+
+#include "state.hpp"
+#include "../data_structures/tuple.hpp"
+
+#include <cstddef>
+#include <list>
+#include <memory>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#ifndef SYMBOL
+#define SYMBOL
+	typedef std::string symbol;
+#endif
+
+/**
+ * Closed list storing the states as deltas. A state is stored as the index of a base state
+ * (usually the state it was generated from) and the grounded predicates it adds to and
+ * deletes from the base, so a stored state costs memory in proportion to the effects of the
+ * action rather than to the size of the state. To bound the cost of rebuilding a state, a
+ * complete copy (a checkpoint) is stored instead when the chain of deltas from the last
+ * checkpoint reaches checkpoint_interval states.
+ *
+ * A state is rebuilt by applying the deltas from the nearest checkpoint, or from the nearest
+ * state of the chain found in a small LRU cache of rebuilt states. The cache keeps the states
+ * just inserted and retrieved, so the expansion of a state, the duplicate checks of its
+ * successors and the extraction of a plan rarely walk more than a few deltas.
+ * The stored states are found by their hash, a state with the same hash being rebuilt to be
+ * compared.
+*/
+class delta_store
+{
+	private:
+		/** ATTRIBUTES **/
+
+		// A grounded predicate, with the index of its KD-tree
+		typedef std::pair<unsigned int, tuple<symbol>> atom;
+
+		/**
+		 * A stored state, either a checkpoint (full is not null) or a delta from the
+		 * state of index base.
+		 * depth is the number of deltas from the last checkpoint, 0 for a checkpoint.
+		*/
+		struct entry
+		{
+			unsigned int base;
+			unsigned int depth;
+			std::unique_ptr<state> full;
+			std::vector<atom> added;
+			std::vector<atom> deleted;
+		};
+
+		std::vector<entry> m_entries;
+
+		// The indexes of the stored states, by hash
+		std::unordered_multimap<std::size_t, unsigned int> m_indexes;
+
+		unsigned int m_checkpoint_interval;
+
+		/**
+		 * LRU cache of the rebuilt states, the most recently used first, and the position
+		 * of each cached state in the list.
+		*/
+		unsigned int m_cache_size;
+		std::list<std::pair<unsigned int, state>> m_cache;
+		std::unordered_map<unsigned int, std::list<std::pair<unsigned int, state>>::iterator> m_cached;
+
+		unsigned int m_checkpoints;
+		unsigned long long m_delta_atoms;
+		unsigned long long m_cache_hits;
+		unsigned long long m_cache_misses;
+		unsigned long long m_applied_deltas;
+
+		/** METHODS **/
+
+		// Puts s at the head of the cache as the state of the given index
+		void remember(unsigned int index, const state &s);
+
+	public:
+		/** METHODS **/
+
+		// Constructor, a checkpoint_interval of 0 or 1 stores every state as a checkpoint
+		delta_store(unsigned int checkpoint_interval = 16, unsigned int cache_size = 64);
+
+		// Getters
+		unsigned int size(void) const;
+		unsigned int checkpoint_interval(void) const;
+		unsigned int cache_size(void) const;
+
+		// Number of checkpoints, and of grounded predicates in all the deltas
+		unsigned int nb_checkpoints(void) const;
+		unsigned long long nb_delta_atoms(void) const;
+
+		// Number of states retrieved from the cache and rebuilt, and of deltas applied
+		unsigned long long nb_cache_hits(void) const;
+		unsigned long long nb_cache_misses(void) const;
+		unsigned long long nb_applied_deltas(void) const;
+
+		/**
+		 * Stores s as a checkpoint.
+		 * @return The index of s in the store.
+		*/
+		unsigned int insert(const state &s);
+
+		/**
+		 * Stores s as a delta from the state of index base, or as a checkpoint if the chain
+		 * of deltas is long enough. s is not checked against the stored states (see find()).
+		 * @return The index of s in the store.
+		*/
+		unsigned int insert(const state &s, unsigned int base);
+
+		/**
+		 * @return The index of the stored state equal to s, or -1 if s has not been stored.
+		*/
+		int find(const state &s);
+
+		// The stored state of the given index, rebuilt from its checkpoint if not cached
+		state get(unsigned int index);
+
+		// Empties the store and the cache
+		void clear(void);
+};
+
+#endif // DELTA_STORE_HPP
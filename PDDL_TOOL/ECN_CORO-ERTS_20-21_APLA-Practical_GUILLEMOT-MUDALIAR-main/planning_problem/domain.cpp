@@ -1,8 +1,17 @@
 #include "domain.hpp"
 
-domain::domain(void) {}
+#include <atomic>
 
-domain::domain(const symbol &name) : m_name(name)
+unsigned long long new_revision(void)
+{
+	static std::atomic<unsigned long long> last(0);
+
+	return ++last;
+}
+
+domain::domain(void) : m_revision(new_revision()) {}
+
+domain::domain(const symbol &name) : m_name(name), m_revision(new_revision())
 {
 	m_symbols.insert(m_name);
 	m_statedims.push_back(1);
@@ -16,6 +25,8 @@ std::vector<symbol> domain::constants(void) { return m_constants; }
 
 std::vector<unsigned int> domain::state_dimensions(void) { return m_statedims; }
 
+unsigned long long domain::revision(void) const { return m_revision; }
+
 unsigned int domain::pred_index(const symbol &predic_name, unsigned int predic_nbparams)
 {
 	std::map<symbol, std::pair<int, int>>::iterator predic = m_predicates.find(predic_name);
@@ -34,12 +45,16 @@ void domain::add_symbol(const symbol &symb)
 {
 	assert(("Symbol already exists.", m_symbols.find(symb) == m_symbols.end()));
 	m_symbols.insert(symb);
+
+	m_revision = new_revision();
 }
 
 void domain::add_constant(const symbol &constant)
 {
 	assert(("Symbol already exists.", m_symbols.find(constant) == m_symbols.end()));
 	m_constants.push_back(constant);
+
+	m_revision = new_revision();
 }
 
 void domain::add_predicate(const symbol &predic_name, unsigned int nbparams)
@@ -57,6 +72,8 @@ void domain::add_predicate(const symbol &predic_name, unsigned int nbparams)
 	else
 		m_predicates.insert(std::pair<symbol, std::pair<int, int>>
 			(predic_name, std::pair<int, int>(nbparams, 0)));
+
+	m_revision = new_revision();
 }
 
 void domain::add_action(const symbol &act_name)
@@ -64,6 +81,8 @@ void domain::add_action(const symbol &act_name)
 	assert(("Symbol already exists.", m_symbols.find(act_name) == m_symbols.end()));
 	m_symbols.insert(act_name);
 	m_actions.insert(std::pair<symbol, action>(act_name, action(act_name)));
+
+	m_revision = new_revision();
 }
 
 void domain::set_action_cost(const symbol &act_name, unsigned int cost)
@@ -71,6 +90,8 @@ void domain::set_action_cost(const symbol &act_name, unsigned int cost)
 	std::map<symbol, action>::iterator act = m_actions.find(act_name);
 	assert(("No such action exists.", act != m_actions.end()));
 	act->second.set_cost(cost);
+
+	m_revision = new_revision();
 }
 
 void domain::add_action_param(const symbol &act_name, const symbol &param_name)
@@ -78,6 +99,8 @@ void domain::add_action_param(const symbol &act_name, const symbol &param_name)
 	std::map<symbol, action>::iterator act = m_actions.find(act_name);
 	assert(("No such action exists.", act != m_actions.end()));
 	act->second.add_param(param_name);
+
+	m_revision = new_revision();
 }
 
 void domain::add_action_precond(const symbol &act_name, const symbol &precond_name,
@@ -90,6 +113,8 @@ void domain::add_action_precond(const symbol &act_name, const symbol &precond_na
 	assert(("Wrong number of parameters for this predicate.",
 		param_names.size() == pred->second.first));
 	act->second.add_precond(pred->second.second, neg_precond, param_names);
+
+	m_revision = new_revision();
 }
 
 void domain::add_action_effect(const symbol &act_name, const symbol &effect_name,
@@ -102,6 +127,8 @@ void domain::add_action_effect(const symbol &act_name, const symbol &effect_name
 	assert(("Wrong number of parameters for this predicate.",
 		param_names.size() == pred->second.first));
 	act->second.add_effect(pred->second.second, neg_effect, param_names);
+
+	m_revision = new_revision();
 }
 
 void domain::add_action_cond_effect(const symbol &act_name,
@@ -136,6 +163,8 @@ void domain::add_action_cond_effect(const symbol &act_name,
 	}
 
 	act->second.add_conditional_effect(preconds, effects);
+
+	m_revision = new_revision();
 }
 
 void domain::delete_relax(const domain &dom)
@@ -148,4 +177,6 @@ void domain::delete_relax(const domain &dom)
 		m_actions.insert(std::make_pair(p.first, p.second.delete_relax()));
 
 	m_statedims = dom.m_statedims;
+
+	m_revision = new_revision();
 }
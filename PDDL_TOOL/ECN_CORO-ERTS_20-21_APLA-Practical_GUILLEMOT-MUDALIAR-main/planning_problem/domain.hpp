@@ -16,6 +16,12 @@
 	typedef std::string symbol;
 #endif
 
+/**
+ * @return A number never returned before, which identifies a revision of a domain or of a
+ *	   problem (see domain::revision()).
+*/
+unsigned long long new_revision(void);
+
 class domain
 {
 	private:
@@ -49,6 +55,9 @@ class domain
 		*/
 		std::vector<unsigned int> m_statedims;
 
+		// Revision of the domain, renewed by each modifier
+		unsigned long long m_revision;
+
 	public:
 		/** METHODS **/
 
@@ -66,6 +75,13 @@ class domain
 		unsigned int pred_index(const symbol &predic_name, unsigned int predic_nbparams);
 		bool is_symbol(const symbol &symb);
 
+		/**
+		 * @return The revision of the domain. Two domains with the same revision are copies of
+		 *	   each other, unless an action was modified through an iterator: the revision only
+		 *	   changes with the modifiers below.
+		*/
+		unsigned long long revision(void) const;
+
 		// Modifiers
 		void add_symbol(const symbol &symb);
 		void add_constant(const symbol &constant);
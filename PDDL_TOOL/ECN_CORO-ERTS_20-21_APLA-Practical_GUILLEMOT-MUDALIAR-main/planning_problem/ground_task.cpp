@@ -0,0 +1,493 @@
+#include "ground_task.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include <unordered_set>
+
+/**
+ * A ground action which has not been instantiated yet. The items in a tuple correspond to:
+ *	- the ground action (its name followed by its parameters),
+ *	- its cost,
+ *	- its pre-conditions,
+ *	- its effects,
+ *	- its conditional effects.
+*/
+typedef std::tuple<std::vector<symbol>, unsigned int,
+		   std::vector<triplet<int, bool, tuple<symbol>>>,
+		   std::vector<triplet<int, bool, tuple<symbol>>>,
+		   std::vector<std::pair<std::vector<triplet<int, bool, tuple<symbol>>>,
+					 std::vector<triplet<int, bool, tuple<symbol>>>>>> candidate_action;
+
+static inline bool test_bit(const unsigned char *buffer, unsigned int index)
+{
+	return buffer[index >> 3] & (1 << (index & 7));
+}
+
+static inline void set_bit(unsigned char *buffer, unsigned int index, bool value)
+{
+	if (value)
+		buffer[index >> 3] |= (1 << (index & 7));
+	else
+		buffer[index >> 3] &= ~(1 << (index & 7));
+}
+
+static inline bool all_set(const unsigned char *buffer, const std::vector<unsigned int> &facts)
+{
+	for (unsigned int f : facts)
+	{
+		if (!test_bit(buffer, f))
+			return false;
+	}
+	return true;
+}
+
+static inline bool none_set(const unsigned char *buffer, const std::vector<unsigned int> &facts)
+{
+	for (unsigned int f : facts)
+	{
+		if (test_bit(buffer, f))
+			return false;
+	}
+	return true;
+}
+
+/**
+ * Computes the net effects of a list of effects applied in order, the last effect on a fact
+ * being the one which is kept.
+*/
+static void net_effects(const std::vector<unsigned int> &effects, const std::vector<bool> &negative,
+			std::vector<unsigned int> &add, std::vector<unsigned int> &del)
+{
+	unsigned int i;
+	std::map<unsigned int, bool> last_effect;
+
+	for (i = 0; i < effects.size(); ++i)
+		last_effect[effects[i]] = negative[i];
+
+	for (std::pair<unsigned int, bool> eff : last_effect)
+	{
+		if (eff.second)
+			del.push_back(eff.first);
+		else
+			add.push_back(eff.first);
+	}
+}
+
+ground_task::ground_task(const problem &prob)
+{
+	bool enabled, changed = true;
+	int i;
+	unsigned int j;
+
+	domain &dom = prob.get_domain();
+	const std::vector<symbol> &objects = prob.get_objects();
+	std::vector<symbol> params;
+	std::vector<unsigned int> obj_indexes, effects, cond_pos, cond_neg, cond_add, cond_del;
+	std::vector<bool> negative;
+	std::unordered_set<std::string> reached;
+	std::vector<candidate_action> candidates;
+	std::vector<bool> instantiated;
+	ground_action gd_action;
+
+	m_dimensions = dom.state_dimensions();
+
+	for (const std::pair<unsigned int, tuple<symbol>> &atom : prob.init_state().atoms())
+	{
+		m_init.push_back(add_fact(atom.first, atom.second));
+		reached.insert(fact_key(atom.first, atom.second));
+	}
+
+	for (const std::pair<unsigned int, tuple<symbol>> &atom : prob.final_state().atoms())
+		m_goal.push_back(add_fact(atom.first, atom.second));
+
+	std::sort(m_init.begin(), m_init.end());
+	std::sort(m_goal.begin(), m_goal.end());
+
+	// Enumerating every combination of objects for every action
+	for (action a : dom)
+	{
+		if (a.nbparams() > 0 && objects.empty())
+			continue;
+
+		obj_indexes.assign(a.nbparams(), 0);
+
+		do
+		{
+			params.clear();
+			for (j = 0; j < a.nbparams(); ++j)
+				params.push_back(objects[obj_indexes[j]]);
+
+			candidates.push_back(candidate_action(params, a.cost(), a.ground_preconds(params),
+							      a.ground_effects(params),
+							      a.ground_cond_effects(params)));
+			std::get<0>(candidates.back()).insert(std::get<0>(candidates.back()).begin(),
+							      a.name());
+
+			// Next combination, the last parameter changing first
+			for (i = a.nbparams()-1; i >= 0; --i)
+			{
+				obj_indexes[i] = (obj_indexes[i]+1)%objects.size();
+				if (obj_indexes[i] != 0)
+					break;
+			}
+		}
+		while (i >= 0);
+	}
+
+	/**
+	 * Delete relaxation fixpoint: a candidate is instantiated once all its positive
+	 * pre-conditions are reached, and all its positive effects become reached.
+	*/
+	instantiated.assign(candidates.size(), false);
+
+	while (changed)
+	{
+		changed = false;
+
+		for (j = 0; j < candidates.size(); ++j)
+		{
+			if (instantiated[j])
+				continue;
+
+			enabled = true;
+			for (triplet<int, bool, tuple<symbol>> precond : std::get<2>(candidates[j]))
+			{
+				if (!std::get<1>(precond)
+				    && reached.find(fact_key(std::get<0>(precond), std::get<2>(precond))) == reached.end())
+				{
+					enabled = false;
+					break;
+				}
+			}
+
+			if (!enabled)
+				continue;
+
+			instantiated[j] = true;
+			changed = true;
+
+			for (triplet<int, bool, tuple<symbol>> effect : std::get<3>(candidates[j]))
+			{
+				if (!std::get<1>(effect))
+					reached.insert(fact_key(std::get<0>(effect), std::get<2>(effect)));
+			}
+
+			for (std::pair<std::vector<triplet<int, bool, tuple<symbol>>>,
+				       std::vector<triplet<int, bool, tuple<symbol>>>> cond_eff : std::get<4>(candidates[j]))
+			{
+				for (triplet<int, bool, tuple<symbol>> effect : cond_eff.second)
+				{
+					if (!std::get<1>(effect))
+						reached.insert(fact_key(std::get<0>(effect), std::get<2>(effect)));
+				}
+			}
+		}
+	}
+
+	// Building the ground actions
+	for (j = 0; j < candidates.size(); ++j)
+	{
+		if (!instantiated[j])
+			continue;
+
+		gd_action = ground_action();
+		gd_action.name = std::get<0>(candidates[j]);
+		gd_action.cost = std::get<1>(candidates[j]);
+
+		for (triplet<int, bool, tuple<symbol>> precond : std::get<2>(candidates[j]))
+		{
+			if (std::get<1>(precond))
+				gd_action.pre_neg.push_back(add_fact(std::get<0>(precond), std::get<2>(precond)));
+			else
+				gd_action.pre_pos.push_back(add_fact(std::get<0>(precond), std::get<2>(precond)));
+		}
+
+		effects.clear();
+		negative.clear();
+		for (triplet<int, bool, tuple<symbol>> effect : std::get<3>(candidates[j]))
+		{
+			effects.push_back(add_fact(std::get<0>(effect), std::get<2>(effect)));
+			negative.push_back(std::get<1>(effect));
+		}
+		net_effects(effects, negative, gd_action.add, gd_action.del);
+
+		for (std::pair<std::vector<triplet<int, bool, tuple<symbol>>>,
+			       std::vector<triplet<int, bool, tuple<symbol>>>> cond_eff : std::get<4>(candidates[j]))
+		{
+			cond_pos.clear();
+			cond_neg.clear();
+			cond_add.clear();
+			cond_del.clear();
+
+			for (triplet<int, bool, tuple<symbol>> precond : cond_eff.first)
+			{
+				if (std::get<1>(precond))
+					cond_neg.push_back(add_fact(std::get<0>(precond), std::get<2>(precond)));
+				else
+					cond_pos.push_back(add_fact(std::get<0>(precond), std::get<2>(precond)));
+			}
+
+			effects.clear();
+			negative.clear();
+			for (triplet<int, bool, tuple<symbol>> effect : cond_eff.second)
+			{
+				effects.push_back(add_fact(std::get<0>(effect), std::get<2>(effect)));
+				negative.push_back(std::get<1>(effect));
+			}
+			net_effects(effects, negative, cond_add, cond_del);
+
+			std::sort(cond_pos.begin(), cond_pos.end());
+			std::sort(cond_neg.begin(), cond_neg.end());
+			gd_action.cond_effects.push_back(std::make_tuple(cond_pos, cond_neg, cond_add, cond_del));
+		}
+
+		std::sort(gd_action.pre_pos.begin(), gd_action.pre_pos.end());
+		gd_action.pre_pos.erase(std::unique(gd_action.pre_pos.begin(), gd_action.pre_pos.end()),
+					gd_action.pre_pos.end());
+		std::sort(gd_action.pre_neg.begin(), gd_action.pre_neg.end());
+		gd_action.pre_neg.erase(std::unique(gd_action.pre_neg.begin(), gd_action.pre_neg.end()),
+					gd_action.pre_neg.end());
+
+		m_actions.push_back(gd_action);
+	}
+
+	// Indexing the actions by the facts they add and delete
+	m_achievers.resize(m_facts.size());
+	m_deleters.resize(m_facts.size());
+
+	for (j = 0; j < m_actions.size(); ++j)
+	{
+		m_action_indexes.insert(std::make_pair(action_key(m_actions[j].name), j));
+
+		for (unsigned int f : m_actions[j].add)
+			m_achievers[f].push_back(j);
+		for (unsigned int f : m_actions[j].del)
+			m_deleters[f].push_back(j);
+	}
+}
+
+std::string ground_task::fact_key(unsigned int pred_index, const tuple<symbol> &params)
+{
+	unsigned int i;
+	std::string key = std::to_string(pred_index);
+
+	for (i = 0; i < params.size(); ++i)
+		key += " " + params[i];
+
+	return key;
+}
+
+std::string ground_task::action_key(const std::vector<symbol> &name)
+{
+	std::string key;
+
+	for (const symbol &s : name)
+		key += s + " ";
+
+	return key;
+}
+
+unsigned int ground_task::add_fact(unsigned int pred_index, const tuple<symbol> &params)
+{
+	std::string key = fact_key(pred_index, params);
+	std::unordered_map<std::string, unsigned int>::iterator it = m_fact_indexes.find(key);
+
+	if (it != m_fact_indexes.end())
+		return it->second;
+
+	m_facts.push_back(std::make_pair(pred_index, params));
+	m_fact_indexes.insert(std::make_pair(key, m_facts.size()-1));
+
+	return m_facts.size()-1;
+}
+
+unsigned int ground_task::nb_facts(void) const { return m_facts.size(); }
+
+unsigned int ground_task::nb_actions(void) const { return m_actions.size(); }
+
+const std::pair<unsigned int, tuple<symbol>>& ground_task::fact(unsigned int index) const
+{
+	return m_facts[index];
+}
+
+const ground_action& ground_task::get_action(unsigned int index) const { return m_actions[index]; }
+
+const std::vector<unsigned int>& ground_task::achievers(unsigned int fact) const
+{
+	return m_achievers[fact];
+}
+
+const std::vector<unsigned int>& ground_task::deleters(unsigned int fact) const
+{
+	return m_deleters[fact];
+}
+
+const std::vector<unsigned int>& ground_task::init(void) const { return m_init; }
+
+const std::vector<unsigned int>& ground_task::goal(void) const { return m_goal; }
+
+int ground_task::fact_index(unsigned int pred_index, const tuple<symbol> &params) const
+{
+	std::unordered_map<std::string, unsigned int>::const_iterator it =
+		m_fact_indexes.find(fact_key(pred_index, params));
+
+	return it == m_fact_indexes.end() ? -1 : it->second;
+}
+
+int ground_task::action_index(const std::vector<symbol> &name) const
+{
+	std::unordered_map<std::string, unsigned int>::const_iterator it =
+		m_action_indexes.find(action_key(name));
+
+	return it == m_action_indexes.end() ? -1 : it->second;
+}
+
+std::vector<unsigned int> ground_task::facts(const state &s) const
+{
+	int index;
+	std::vector<unsigned int> to_return;
+
+	for (std::pair<unsigned int, tuple<symbol>> atom : s.atoms())
+	{
+		index = fact_index(atom.first, atom.second);
+		if (index >= 0)
+			to_return.push_back(index);
+	}
+
+	std::sort(to_return.begin(), to_return.end());
+
+	return to_return;
+}
+
+state ground_task::to_state(const std::vector<unsigned int> &facts) const
+{
+	state s(m_dimensions);
+
+	for (unsigned int f : facts)
+		s.add(m_facts[f].first, m_facts[f].second);
+
+	return s;
+}
+
+unsigned int ground_task::state_bytes(void) const { return (m_facts.size()+7)/8; }
+
+void ground_task::encode(const std::vector<unsigned int> &facts, unsigned char *buffer) const
+{
+	std::memset(buffer, 0, state_bytes());
+
+	for (unsigned int f : facts)
+		set_bit(buffer, f, true);
+}
+
+std::vector<unsigned int> ground_task::decode(const unsigned char *buffer) const
+{
+	unsigned int f;
+	std::vector<unsigned int> to_return;
+
+	for (f = 0; f < m_facts.size(); ++f)
+	{
+		if (test_bit(buffer, f))
+			to_return.push_back(f);
+	}
+
+	return to_return;
+}
+
+bool ground_task::is_goal(const unsigned char *buffer) const { return all_set(buffer, m_goal); }
+
+bool ground_task::holds(unsigned int fact, const unsigned char *buffer) const { return test_bit(buffer, fact); }
+
+unsigned int ground_task::nb_unsatisfied_goals(const unsigned char *buffer) const
+{
+	unsigned int to_return = 0;
+
+	for (unsigned int f : m_goal)
+	{
+		if (!test_bit(buffer, f))
+			to_return++;
+	}
+
+	return to_return;
+}
+
+bool ground_task::applicable(unsigned int action, const unsigned char *buffer) const
+{
+	return all_set(buffer, m_actions[action].pre_pos) && none_set(buffer, m_actions[action].pre_neg);
+}
+
+bool ground_task::apply(unsigned int action, const unsigned char *source, unsigned char *target) const
+{
+	unsigned int i;
+	unsigned long long mask = 0;
+	std::vector<bool> fired;
+	const ground_action &a = m_actions[action];
+
+	if (!applicable(action, source))
+		return false;
+
+	// The fired effects are kept in a mask, unless the action has too many of them
+	if (a.cond_effects.size() > 64)
+		fired.resize(a.cond_effects.size(), false);
+
+	// The conditions are evaluated on the source state before it may be modified
+	for (i = 0; i < a.cond_effects.size(); ++i)
+	{
+		if (all_set(source, std::get<0>(a.cond_effects[i]))
+		    && none_set(source, std::get<1>(a.cond_effects[i])))
+		{
+			if (fired.empty())
+				mask |= 1ULL << i;
+			else
+				fired[i] = true;
+		}
+	}
+
+	if (target != source)
+		std::memcpy(target, source, state_bytes());
+
+	for (unsigned int f : a.del)
+		set_bit(target, f, false);
+	for (unsigned int f : a.add)
+		set_bit(target, f, true);
+
+	for (i = 0; i < a.cond_effects.size(); ++i)
+	{
+		if (fired.empty() ? (mask & (1ULL << i)) != 0 : fired[i])
+		{
+			for (unsigned int f : std::get<3>(a.cond_effects[i]))
+				set_bit(target, f, false);
+			for (unsigned int f : std::get<2>(a.cond_effects[i]))
+				set_bit(target, f, true);
+		}
+	}
+
+	return true;
+}
+
+bool ground_task::apply_relaxed(unsigned int action, const unsigned char *source, unsigned char *target) const
+{
+	const ground_action &a = m_actions[action];
+
+	assert(("The relaxed successor must be built in another buffer.", target != source));
+
+	if (!applicable(action, source))
+		return false;
+
+	std::memcpy(target, source, state_bytes());
+
+	for (unsigned int f : a.add)
+		set_bit(target, f, true);
+
+	// The conditions are evaluated on source, which is left unchanged
+	for (const auto &c : a.cond_effects)
+	{
+		if (all_set(source, std::get<0>(c)) && none_set(source, std::get<1>(c)))
+		{
+			for (unsigned int f : std::get<2>(c))
+				set_bit(target, f, true);
+		}
+	}
+
+	return true;
+}
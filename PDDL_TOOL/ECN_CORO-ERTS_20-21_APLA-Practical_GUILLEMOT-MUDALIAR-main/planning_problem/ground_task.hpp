@@ -0,0 +1,152 @@
+#ifndef GROUND_TASK_HPP
+#define GROUND_TASK_HPP
+
+#include "../data_structures/tuple.hpp"
+#include "problem.hpp"
+#include "state.hpp"
+
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#ifndef SYMBOL
+#define SYMBOL
+	typedef std::string symbol;
+#endif
+
+/**
+ * A ground action of the task. The pre-conditions and effects are lists of fact indexes
+ * sorted in increasing order.
+*/
+struct ground_action
+{
+	// Name of the action followed by its parameters
+	std::vector<symbol> name;
+	unsigned int cost;
+
+	std::vector<unsigned int> pre_pos;
+	std::vector<unsigned int> pre_neg;
+	std::vector<unsigned int> add;
+	std::vector<unsigned int> del;
+
+	/**
+	 * Conditional effects. The items in a tuple correspond to:
+	 *	- the positive conditions,
+	 *	- the negative conditions,
+	 *	- the added facts,
+	 *	- the deleted facts.
+	*/
+	std::vector<std::tuple<std::vector<unsigned int>, std::vector<unsigned int>,
+			       std::vector<unsigned int>, std::vector<unsigned int>>> cond_effects;
+};
+
+/**
+ * Grounded version of a problem.
+ * Every grounded predicate which may appear during the search is given a fact index, and the
+ * actions are instantiated with every combination of objects whose positive pre-conditions
+ * are reachable in the delete relaxation of the problem.
+*/
+class ground_task
+{
+	private:
+		/** ATTRIBUTES **/
+
+		// Dimensions of the KD-trees of the states of the problem
+		std::vector<unsigned int> m_dimensions;
+
+		/**
+		 * The facts. The items in a pair correspond to:
+		 *	- the index of the predicate's KD-tree in a state,
+		 *	- the grounded parameters of the predicate.
+		*/
+		std::vector<std::pair<unsigned int, tuple<symbol>>> m_facts;
+
+		// Index of a fact from its key (see fact_key)
+		std::unordered_map<std::string, unsigned int> m_fact_indexes;
+
+		std::vector<ground_action> m_actions;
+
+		// Index of a ground action from its key (see action_key)
+		std::unordered_map<std::string, unsigned int> m_action_indexes;
+
+		// Indexes of the actions adding and deleting each fact
+		std::vector<std::vector<unsigned int>> m_achievers;
+		std::vector<std::vector<unsigned int>> m_deleters;
+
+		std::vector<unsigned int> m_init;
+		std::vector<unsigned int> m_goal;
+
+		/** METHODS **/
+		static std::string fact_key(unsigned int pred_index, const tuple<symbol> &params);
+		static std::string action_key(const std::vector<symbol> &name);
+		unsigned int add_fact(unsigned int pred_index, const tuple<symbol> &params);
+
+	public:
+		/** METHODS **/
+
+		// Constructor
+		ground_task(const problem &prob);
+
+		// Getters
+		unsigned int nb_facts(void) const;
+		unsigned int nb_actions(void) const;
+		const std::pair<unsigned int, tuple<symbol>>& fact(unsigned int index) const;
+		const ground_action& get_action(unsigned int index) const;
+		const std::vector<unsigned int>& achievers(unsigned int fact) const;
+		const std::vector<unsigned int>& deleters(unsigned int fact) const;
+		const std::vector<unsigned int>& init(void) const;
+		const std::vector<unsigned int>& goal(void) const;
+
+		/**
+		 * @return The index of the fact, or -1 if the grounded predicate never appears
+		 *	   in the task.
+		*/
+		int fact_index(unsigned int pred_index, const tuple<symbol> &params) const;
+
+		/**
+		 * @return The index of the ground action (its name followed by its parameters), or -1
+		 *	   if it is not in the task.
+		*/
+		int action_index(const std::vector<symbol> &name) const;
+
+		// Conversions between states and sorted lists of fact indexes
+		std::vector<unsigned int> facts(const state &s) const;
+		state to_state(const std::vector<unsigned int> &facts) const;
+
+		/**
+		 * Compact encoding of a state: a bitset over the fact indexes, stored in
+		 * state_bytes() bytes.
+		*/
+		unsigned int state_bytes(void) const;
+		void encode(const std::vector<unsigned int> &facts, unsigned char *buffer) const;
+		std::vector<unsigned int> decode(const unsigned char *buffer) const;
+		bool is_goal(const unsigned char *buffer) const;
+
+		// True if the fact holds in an encoded state
+		bool holds(unsigned int fact, const unsigned char *buffer) const;
+
+		// Number of facts of the goal which are false in an encoded state
+		unsigned int nb_unsatisfied_goals(const unsigned char *buffer) const;
+
+		// True if the pre-conditions of a ground action hold in an encoded state
+		bool applicable(unsigned int action, const unsigned char *buffer) const;
+
+		/**
+		 * Applies a ground action on an encoded state, without any allocation unless the
+		 * action has more than 64 conditional effects. target may be the same buffer as source.
+		 * @return False if the action is not applicable, target is then left unchanged.
+		*/
+		bool apply(unsigned int action, const unsigned char *source, unsigned char *target) const;
+
+		/**
+		 * Applies a ground action of the delete relaxation of the task on an encoded state:
+		 * the deleted facts are kept, and the negative pre-conditions and conditions are still
+		 * required, as in problem::delete_relax(). target must be another buffer than source.
+		 * @return False if the action is not applicable, target is then left unchanged.
+		*/
+		bool apply_relaxed(unsigned int action, const unsigned char *source, unsigned char *target) const;
+};
+
+#endif // GROUND_TASK_HPP
@@ -0,0 +1,476 @@
+#include "planning_graph.hpp"
+
+#include <algorithm>
+#include <climits>
+#include <iterator>
+
+planning_graph::planning_graph(const ground_task &task, const std::vector<unsigned int> &init, bool mutexes):
+	m_task(task), m_mutexes(mutexes), m_leveled_off(false)
+{
+	unsigned int a, l, n;
+	std::vector<unsigned int> remaining, cond_written;
+
+	m_pre.resize(nb_nodes());
+	m_eff.resize(nb_nodes());
+	m_cond_eff.resize(nb_nodes());
+	m_supporters.resize(nb_literals());
+	m_cond_supporters.resize(nb_literals());
+
+	// The ground actions, a fact both deleted and added ends up true (see ground_task::apply())
+	for (a = 0; a < task.nb_actions(); ++a)
+	{
+		const ground_action &act = task.get_action(a);
+
+		m_pre[a] = act.pre_pos;
+		for (unsigned int p : act.pre_neg)
+			m_pre[a].push_back(literal(p, false));
+
+		cond_written.clear();
+
+		for (const auto &cond_eff : act.cond_effects)
+		{
+			m_cond_eff[a].push_back({std::get<0>(cond_eff), std::get<2>(cond_eff)});
+
+			for (unsigned int c : std::get<1>(cond_eff))
+				m_cond_eff[a].back().first.push_back(literal(c, false));
+
+			remaining.clear();
+			std::set_difference(std::get<3>(cond_eff).begin(), std::get<3>(cond_eff).end(),
+					    std::get<2>(cond_eff).begin(), std::get<2>(cond_eff).end(),
+					    std::back_inserter(remaining));
+			for (unsigned int d : remaining)
+				m_cond_eff[a].back().second.push_back(literal(d, false));
+
+			cond_written.insert(cond_written.end(), m_cond_eff[a].back().second.begin(),
+					    m_cond_eff[a].back().second.end());
+		}
+
+		std::sort(cond_written.begin(), cond_written.end());
+
+		// The unconditional effects which a conditional effect may overwrite are not certain
+		remaining.clear();
+		std::set_difference(act.del.begin(), act.del.end(), act.add.begin(), act.add.end(),
+				    std::back_inserter(remaining));
+		for (unsigned int e : act.add)
+		{
+			if (!std::binary_search(cond_written.begin(), cond_written.end(), literal(e, false)))
+				m_eff[a].push_back(e);
+		}
+
+		for (unsigned int d : remaining)
+		{
+			if (!std::binary_search(cond_written.begin(), cond_written.end(), d))
+				m_eff[a].push_back(literal(d, false));
+		}
+	}
+
+	// The no-ops
+	for (l = 0; l < nb_literals(); ++l)
+	{
+		m_pre[task.nb_actions()+l] = {l};
+		m_eff[task.nb_actions()+l] = {l};
+	}
+
+	for (n = 0; n < nb_nodes(); ++n)
+	{
+		for (unsigned int e : m_eff[n])
+			m_supporters[e].push_back(n);
+
+		for (unsigned int i = 0; i < m_cond_eff[n].size(); ++i)
+		{
+			for (unsigned int e : m_cond_eff[n][i].second)
+				m_cond_supporters[e].push_back({n, i});
+		}
+	}
+
+	/**
+	 * Two nodes interfere if one of them writes a literal whose negation the other one reads
+	 * or writes. The conditions of the conditional effects are read in both values, since a
+	 * change of their value changes the effects.
+	*/
+	if (m_mutexes)
+	{
+		std::vector<std::vector<unsigned int>> writers(nb_literals()), readers(nb_literals());
+
+		m_interference = bit_matrix(nb_nodes());
+
+		for (n = 0; n < nb_nodes(); ++n)
+		{
+			for (unsigned int p : m_pre[n])
+				readers[p].push_back(n);
+
+			for (unsigned int e : m_eff[n])
+				writers[e].push_back(n);
+
+			for (const auto &cond_eff : m_cond_eff[n])
+			{
+				for (unsigned int c : cond_eff.first)
+				{
+					readers[c].push_back(n);
+					readers[negation(c)].push_back(n);
+				}
+
+				for (unsigned int e : cond_eff.second)
+					writers[e].push_back(n);
+			}
+		}
+
+		for (l = 0; l < nb_literals(); ++l)
+		{
+			for (unsigned int w : writers[l])
+			{
+				for (unsigned int r : readers[negation(l)])
+				{
+					if (r != w)
+						m_interference.set(w, r);
+				}
+
+				for (unsigned int r : writers[negation(l)])
+				{
+					if (r != w)
+						m_interference.set(w, r);
+				}
+			}
+		}
+	}
+
+	reset(init);
+}
+
+void planning_graph::reset(const std::vector<unsigned int> &init)
+{
+	unsigned int f, l;
+	std::vector<bool> in_init(m_task.nb_facts(), false);
+
+	m_leveled_off = false;
+	m_fact_layers.clear();
+	m_action_layers.clear();
+	m_fact_mutexes.clear();
+	m_literal_levels.assign(nb_literals(), UINT_MAX);
+	m_node_levels.assign(nb_nodes(), UINT_MAX);
+
+	// The fact layer 0
+	for (unsigned int i : init)
+		in_init[i] = true;
+
+	m_fact_layers.push_back(bitset(nb_literals()));
+	for (f = 0; f < m_task.nb_facts(); ++f)
+	{
+		l = literal(f, in_init[f]);
+		m_fact_layers[0].set(l);
+		m_literal_levels[l] = 0;
+	}
+
+	// A fact and its negation are always mutex
+	if (m_mutexes)
+	{
+		m_fact_mutexes.push_back(bit_matrix(nb_literals()));
+		for (f = 0; f < m_task.nb_facts(); ++f)
+			m_fact_mutexes[0].set(literal(f), literal(f, false));
+
+		m_action_mutexes = bit_matrix(nb_nodes());
+	}
+}
+
+const ground_task& planning_graph::task(void) const { return m_task; }
+
+unsigned int planning_graph::nb_literals(void) const { return 2*m_task.nb_facts(); }
+
+unsigned int planning_graph::nb_nodes(void) const { return m_task.nb_actions()+nb_literals(); }
+
+bool planning_graph::is_noop(unsigned int node) const { return node >= m_task.nb_actions(); }
+
+const std::vector<unsigned int>& planning_graph::preconditions(unsigned int node) const
+{
+	return m_pre[node];
+}
+
+const std::vector<unsigned int>& planning_graph::effects(unsigned int node) const
+{
+	return m_eff[node];
+}
+
+const std::vector<std::pair<std::vector<unsigned int>, std::vector<unsigned int>>>&
+	planning_graph::cond_effects(unsigned int node) const
+{
+	return m_cond_eff[node];
+}
+
+const std::vector<unsigned int>& planning_graph::supporters(unsigned int literal) const
+{
+	return m_supporters[literal];
+}
+
+const std::vector<std::pair<unsigned int, unsigned int>>& planning_graph::cond_supporters(unsigned int literal) const
+{
+	return m_cond_supporters[literal];
+}
+
+unsigned int planning_graph::literal(unsigned int fact, bool positive) const
+{
+	return positive ? fact : fact+m_task.nb_facts();
+}
+
+unsigned int planning_graph::negation(unsigned int literal) const
+{
+	return literal < m_task.nb_facts() ? literal+m_task.nb_facts() : literal-m_task.nb_facts();
+}
+
+unsigned int planning_graph::nb_layers(void) const { return m_fact_layers.size(); }
+
+const bitset& planning_graph::facts(unsigned int layer) const { return m_fact_layers[layer]; }
+
+const bitset& planning_graph::actions(unsigned int layer) const { return m_action_layers[layer]; }
+
+bool planning_graph::leveled_off(void) const { return m_leveled_off; }
+
+unsigned int planning_graph::level(unsigned int literal) const { return m_literal_levels[literal]; }
+
+unsigned int planning_graph::node_level(unsigned int node) const { return m_node_levels[node]; }
+
+bool planning_graph::facts_mutex(unsigned int layer, unsigned int l1, unsigned int l2) const
+{
+	return m_mutexes && m_fact_mutexes[layer].test(l1, l2);
+}
+
+bool planning_graph::actions_mutex(unsigned int layer, unsigned int n1, unsigned int n2) const
+{
+	return m_mutexes && n1 != n2 && (interfere(n1, n2) || competing_needs(layer, n1, n2));
+}
+
+unsigned long long planning_graph::nb_mutexes(unsigned int layer) const
+{
+	return m_mutexes ? m_fact_mutexes[layer].nb_pairs() : 0;
+}
+
+unsigned int planning_graph::goal_level(const std::vector<unsigned int> &literals) const
+{
+	for (unsigned int layer = 0; layer < nb_layers(); ++layer)
+	{
+		if (!all_in_layer(layer, literals))
+			continue;
+
+		bool mutex = false;
+
+		for (unsigned int i = 0; i < literals.size() && !mutex; ++i)
+		{
+			for (unsigned int j = i+1; j < literals.size() && !mutex; ++j)
+				mutex = facts_mutex(layer, literals[i], literals[j]);
+		}
+
+		if (!mutex)
+			return layer;
+	}
+
+	return UINT_MAX;
+}
+
+bool planning_graph::interfere(unsigned int n1, unsigned int n2) const
+{
+	return m_interference.test(n1, n2);
+}
+
+// True if two pre-conditions of the nodes are mutex in the fact layer
+bool planning_graph::competing_needs(unsigned int layer, unsigned int n1, unsigned int n2) const
+{
+	for (unsigned int p1 : m_pre[n1])
+	{
+		for (unsigned int p2 : m_pre[n2])
+		{
+			if (m_fact_mutexes[layer].test(p1, p2))
+				return true;
+		}
+	}
+
+	return false;
+}
+
+bool planning_graph::all_in_layer(unsigned int layer, const std::vector<unsigned int> &literals) const
+{
+	for (unsigned int l : literals)
+	{
+		if (!m_fact_layers[layer].test(l))
+			return false;
+	}
+
+	return true;
+}
+
+/**
+ * @return True if all the pairs of nodes of the last action layer producing the two literals
+ *	   are mutex.
+*/
+bool planning_graph::produced_mutex(unsigned int l1, unsigned int l2) const
+{
+	unsigned int layer = m_action_layers.size()-1;
+	std::vector<unsigned int> producers1, producers2;
+
+	if (l1 == negation(l2))
+		return true;
+
+	for (std::pair<unsigned int, std::vector<unsigned int> *> p : {std::make_pair(l1, &producers1),
+								      std::make_pair(l2, &producers2)})
+	{
+		for (unsigned int n : m_supporters[p.first])
+		{
+			if (m_action_layers[layer].test(n))
+				p.second->push_back(n);
+		}
+
+		for (const std::pair<unsigned int, unsigned int> &c : m_cond_supporters[p.first])
+		{
+			if (m_action_layers[layer].test(c.first) && all_in_layer(layer, m_cond_eff[c.first][c.second].first))
+				p.second->push_back(c.first);
+		}
+	}
+
+	for (unsigned int n1 : producers1)
+	{
+		for (unsigned int n2 : producers2)
+		{
+			if (n1 == n2 || !m_action_mutexes.test(n1, n2))
+				return false;
+		}
+	}
+
+	return true;
+}
+
+bool planning_graph::expand(void)
+{
+	bool changed;
+	unsigned int n, n2, l, l2, layer = m_fact_layers.size()-1;
+	std::vector<unsigned int> new_nodes, new_literals;
+
+	const bitset &facts = m_fact_layers[layer];
+	bitset actions = layer > 0 ? m_action_layers[layer-1] : bitset(nb_nodes());
+	bitset next(facts);
+
+	// The nodes applicable in the last fact layer, they stay applicable in the next layers
+	for (n = 0; n < nb_nodes(); ++n)
+	{
+		if (actions.test(n) || !all_in_layer(layer, m_pre[n]))
+			continue;
+
+		if (m_mutexes && competing_needs(layer, n, n))
+			continue;
+
+		actions.set(n);
+		new_nodes.push_back(n);
+		m_node_levels[n] = layer;
+	}
+
+	/**
+	 * The mutexes of the action layer. The nodes of the previous layer which were not mutex
+	 * are still not mutex, only the pairs which were mutex and the new nodes are checked.
+	*/
+	if (m_mutexes)
+	{
+		bitset needs(nb_literals());
+
+		if (layer > 0)
+		{
+			const bitset &previous = m_action_layers[layer-1];
+
+			for (n = previous.next(0); n < previous.size(); n = previous.next(n+1))
+			{
+				for (n2 = m_action_mutexes.row(n).next(n+1); n2 < nb_nodes(); n2 = m_action_mutexes.row(n).next(n2+1))
+				{
+					if (previous.test(n2) && !interfere(n, n2) && !competing_needs(layer, n, n2))
+						m_action_mutexes.reset(n, n2);
+				}
+			}
+		}
+
+		// The literals mutex with a pre-condition of the new node
+		for (unsigned int n1 : new_nodes)
+		{
+			needs.clear();
+			for (unsigned int p : m_pre[n1])
+				needs |= m_fact_mutexes[layer].row(p);
+
+			for (n = actions.next(0); n < actions.size(); n = actions.next(n+1))
+			{
+				if (n == n1 || (m_node_levels[n] == layer && n < n1))
+					continue;
+
+				bool mutex = interfere(n1, n);
+
+				for (unsigned int i = 0; i < m_pre[n].size() && !mutex; ++i)
+					mutex = needs.test(m_pre[n][i]);
+
+				if (mutex)
+					m_action_mutexes.set(n1, n);
+			}
+		}
+	}
+
+	m_action_layers.push_back(actions);
+
+	// The literals produced by the nodes
+	for (n = actions.next(0); n < actions.size(); n = actions.next(n+1))
+	{
+		for (unsigned int e : m_eff[n])
+			next.set(e);
+
+		for (const auto &cond_eff : m_cond_eff[n])
+		{
+			if (!all_in_layer(layer, cond_eff.first))
+				continue;
+
+			for (unsigned int e : cond_eff.second)
+				next.set(e);
+		}
+	}
+
+	for (l = next.next(0); l < next.size(); l = next.next(l+1))
+	{
+		if (!facts.test(l))
+		{
+			new_literals.push_back(l);
+			m_literal_levels[l] = layer+1;
+		}
+	}
+
+	changed = !new_literals.empty();
+
+	/**
+	 * The mutexes of the next fact layer, with the same incremental update as the action
+	 * layer.
+	*/
+	if (m_mutexes)
+	{
+		bit_matrix mutexes(m_fact_mutexes[layer]);
+
+		for (l = facts.next(0); l < facts.size(); l = facts.next(l+1))
+		{
+			for (l2 = mutexes.row(l).next(l+1); l2 < nb_literals(); l2 = mutexes.row(l).next(l2+1))
+			{
+				if (facts.test(l2) && !produced_mutex(l, l2))
+				{
+					mutexes.reset(l, l2);
+					changed = true;
+				}
+			}
+		}
+
+		for (unsigned int l1 : new_literals)
+		{
+			for (l = next.next(0); l < next.size(); l = next.next(l+1))
+			{
+				if (l == l1 || (m_literal_levels[l] == layer+1 && l < l1))
+					continue;
+
+				if (produced_mutex(l1, l))
+					mutexes.set(l1, l);
+			}
+		}
+
+		m_fact_mutexes.push_back(mutexes);
+	}
+
+	m_fact_layers.push_back(next);
+	m_leveled_off = !changed;
+
+	return changed;
+}
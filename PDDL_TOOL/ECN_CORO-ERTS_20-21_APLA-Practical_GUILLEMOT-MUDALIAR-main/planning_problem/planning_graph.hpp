@@ -0,0 +1,146 @@
+#ifndef PLANNING_GRAPH_HPP
+#define PLANNING_GRAPH_HPP
+
+#include "../data_structures/bit_matrix.hpp"
+#include "../data_structures/bitset.hpp"
+#include "ground_task.hpp"
+
+#include <utility>
+#include <vector>
+
+/**
+ * Planning graph of a ground task (as in Graphplan), built layer by layer from a state.
+ * The graph alternates fact layers and action layers: the action layer k holds the nodes
+ * applicable in the fact layer k, and the fact layer k+1 holds the literals they may produce.
+ * The literals are the facts (index f) and their negations (index f+nb_facts), so that
+ * negative pre-conditions are handled as any other pre-condition. The nodes are the ground
+ * actions (index a) followed by one no-op per literal (index nb_actions+l), which carries the
+ * literal to the next layer.
+ * The layers are bitsets over the literals and the nodes.
+ *
+ * When the mutexes are enabled, two literals (resp. nodes) of a layer are mutex if they cannot
+ * hold together (resp. be part of the same step):
+ *	- two nodes are mutex if they interfere (one of them writes a literal whose negation the
+ *	  other requires or writes), or if two of their pre-conditions are mutex,
+ *	- two literals are mutex if all the pairs of nodes producing them are mutex.
+ * The mutexes of each fact layer are stored in a bit matrix, and only the pairs which were
+ * mutex in the previous layer, or involve a new literal, are checked again since the mutexes
+ * of the persisting items can only disappear.
+ * A conditional effect may produce its literals when its conditions are in the layer, it makes
+ * its action interfere with any node reading or writing its conditions or effects.
+ *
+ * Without the mutexes, the graph is the relaxed planning graph of the task (the delete
+ * relaxation), whose levels give the reachability of the literals and nodes.
+*/
+class planning_graph
+{
+	private:
+		/** ATTRIBUTES **/
+		const ground_task &m_task;
+		bool m_mutexes;
+		bool m_leveled_off;
+
+		// Pre-conditions and unconditional effects of the nodes, as sorted lists of literals
+		std::vector<std::vector<unsigned int>> m_pre;
+		std::vector<std::vector<unsigned int>> m_eff;
+
+		/**
+		 * Conditional effects of the nodes. The items in a pair correspond to:
+		 *	- the literals of the conditions,
+		 *	- the literals which may be produced.
+		*/
+		std::vector<std::vector<std::pair<std::vector<unsigned int>, std::vector<unsigned int>>>> m_cond_eff;
+
+		// Nodes producing each literal with an unconditional effect, and with a conditional one
+		std::vector<std::vector<unsigned int>> m_supporters;
+		std::vector<std::vector<std::pair<unsigned int, unsigned int>>> m_cond_supporters;
+
+		// Pairs of interfering nodes, independently of the layers
+		bit_matrix m_interference;
+
+		std::vector<bitset> m_fact_layers;
+		std::vector<bitset> m_action_layers;
+		std::vector<bit_matrix> m_fact_mutexes;
+
+		// Mutexes of the last action layer
+		bit_matrix m_action_mutexes;
+
+		// First layer of each literal and node, UINT_MAX if it was not reached
+		std::vector<unsigned int> m_literal_levels;
+		std::vector<unsigned int> m_node_levels;
+
+		/** METHODS **/
+		bool interfere(unsigned int n1, unsigned int n2) const;
+		bool competing_needs(unsigned int layer, unsigned int n1, unsigned int n2) const;
+		bool all_in_layer(unsigned int layer, const std::vector<unsigned int> &literals) const;
+		bool produced_mutex(unsigned int l1, unsigned int l2) const;
+
+	public:
+		/** METHODS **/
+
+		// Constructor, the graph holds the fact layer 0, made of the literals of init
+		planning_graph(const ground_task &task, const std::vector<unsigned int> &init, bool mutexes = true);
+
+		/**
+		 * Restarts the graph from the fact layer 0 made of the literals of init. The nodes,
+		 * their supporters and interferences do not depend on init and are kept, so that a
+		 * graph can be built once per task and reset for each state.
+		*/
+		void reset(const std::vector<unsigned int> &init);
+
+		// Getters
+		const ground_task& task(void) const;
+		unsigned int nb_literals(void) const;
+		unsigned int nb_nodes(void) const;
+		bool is_noop(unsigned int node) const;
+		const std::vector<unsigned int>& preconditions(unsigned int node) const;
+		const std::vector<unsigned int>& effects(unsigned int node) const;
+
+		const std::vector<std::pair<std::vector<unsigned int>, std::vector<unsigned int>>>&
+			cond_effects(unsigned int node) const;
+
+		// Nodes producing a literal with an unconditional effect (including its no-op)
+		const std::vector<unsigned int>& supporters(unsigned int literal) const;
+
+		/**
+		 * Conditional effects producing a literal. The items in a pair correspond to:
+		 *	- the node,
+		 *	- the index of the conditional effect in cond_effects().
+		*/
+		const std::vector<std::pair<unsigned int, unsigned int>>& cond_supporters(unsigned int literal) const;
+
+		// Literal of a fact, true if positive, false otherwise
+		unsigned int literal(unsigned int fact, bool positive = true) const;
+		unsigned int negation(unsigned int literal) const;
+
+		// Number of fact layers, the action layers are numbered from 0 to nb_layers()-2
+		unsigned int nb_layers(void) const;
+		const bitset& facts(unsigned int layer) const;
+		const bitset& actions(unsigned int layer) const;
+
+		// True if the last expansion left the graph unchanged
+		bool leveled_off(void) const;
+
+		// First layer of a literal or a node, UINT_MAX if it is not in the graph
+		unsigned int level(unsigned int literal) const;
+		unsigned int node_level(unsigned int node) const;
+
+		bool facts_mutex(unsigned int layer, unsigned int l1, unsigned int l2) const;
+		bool actions_mutex(unsigned int layer, unsigned int n1, unsigned int n2) const;
+		unsigned long long nb_mutexes(unsigned int layer) const;
+
+		/**
+		 * @return The first fact layer holding the literals, without any mutex pair between
+		 *	   them, or UINT_MAX if there is none yet.
+		*/
+		unsigned int goal_level(const std::vector<unsigned int> &literals) const;
+
+		/**
+		 * Adds an action layer and the next fact layer.
+		 * @return False if the new fact layer (and its mutexes) is the same as the previous
+		 *	   one, the graph leveled off.
+		*/
+		bool expand(void);
+};
+
+#endif // PLANNING_GRAPH_HPP
@@ -1,32 +1,77 @@
 #include "problem.hpp"
 
-problem::problem(void) : m_domain(nullptr) {}
+problem::problem(void) : m_domain(nullptr), m_revision(new_revision()) {}
 
 problem::problem(domain* dom) : m_domain(dom),
 				m_objects(m_domain->constants()),
 				m_init_state(m_domain->state_dimensions()),
-				m_final_state(m_domain->state_dimensions()) {}
+				m_final_state(m_domain->state_dimensions()),
+				m_revision(new_revision()) {}
 
 problem::problem(const problem &prob) : m_domain(prob.m_domain), m_objects(prob.m_objects),
 					m_init_state(prob.m_init_state),
-					m_final_state(prob.m_final_state) {}
+					m_final_state(prob.m_final_state),
+					m_revision(prob.m_revision) {}
+
+// The problem moved from is left with a new revision, its content being unspecified
+problem::problem(problem &&prob) noexcept : m_domain(prob.m_domain), m_objects(std::move(prob.m_objects)),
+					    m_init_state(std::move(prob.m_init_state)),
+					    m_final_state(std::move(prob.m_final_state)),
+					    m_revision(prob.m_revision)
+{
+	prob.m_revision = new_revision();
+}
 
-domain problem::get_domain(void) const { return *m_domain; }
+problem& problem::operator=(const problem &prob)
+{
+	m_domain = prob.m_domain;
+	m_objects = prob.m_objects;
+	m_init_state = prob.m_init_state;
+	m_final_state = prob.m_final_state;
+	m_revision = prob.m_revision;
 
-const std::vector<symbol> problem::get_objects(void) const { return m_objects; }
+	return *this;
+}
 
-const state problem::init_state(void) const { return m_init_state; }
+problem& problem::operator=(problem &&prob) noexcept
+{
+	m_domain = prob.m_domain;
+	m_objects = std::move(prob.m_objects);
+	m_init_state = std::move(prob.m_init_state);
+	m_final_state = std::move(prob.m_final_state);
+	m_revision = prob.m_revision;
+	prob.m_revision = new_revision();
+
+	return *this;
+}
 
-const state problem::final_state(void) const { return m_final_state; }
+domain& problem::get_domain(void) const { return *m_domain; }
 
-void problem::set_initial(const state &other) { m_init_state = other; }
+const std::vector<symbol>& problem::get_objects(void) const { return m_objects; }
 
-void problem::set_final(const state &other) { m_final_state = other; }
+const state& problem::init_state(void) const { return m_init_state; }
+
+const state& problem::final_state(void) const { return m_final_state; }
+
+unsigned long long problem::revision(void) const { return m_revision; }
+
+void problem::set_initial(state other)
+{
+	m_init_state = std::move(other);
+	m_revision = new_revision();
+}
+
+void problem::set_final(state other)
+{
+	m_final_state = std::move(other);
+	m_revision = new_revision();
+}
 
 void problem::add_object (const symbol &obj)
 {
 	m_domain->add_symbol(obj);
 	m_objects.push_back(obj);
+	m_revision = new_revision();
 }
 
 void problem::ground_init (const symbol &pred, tuple<symbol> objs)
@@ -34,7 +79,7 @@ void problem::ground_init (const symbol &pred, tuple<symbol> objs)
 	bool exists;
 	unsigned int pred_index = m_domain->pred_index(pred, objs.size());
 
-	for (symbol s : objs)
+	for (const symbol &s : objs)
 	{
 		exists = false;
 		for (std::vector<symbol>::iterator it = m_objects.begin(); it < m_objects.end() && !exists; ++it)
@@ -42,7 +87,8 @@ void problem::ground_init (const symbol &pred, tuple<symbol> objs)
 		assert(("No such object exists.", exists));
 	}
 
-	m_init_state.add(pred_index, objs);
+	m_init_state.add(pred_index, std::move(objs));
+	m_revision = new_revision();
 }
 
 void problem::ground_final (const symbol &pred, tuple<symbol> objs)
@@ -50,7 +96,7 @@ void problem::ground_final (const symbol &pred, tuple<symbol> objs)
 	bool exists;
 	unsigned int pred_index = m_domain->pred_index(pred, objs.size());
 
-	for (symbol s : objs)
+	for (const symbol &s : objs)
 	{
 		exists = false;
 		for (std::vector<symbol>::iterator it = m_objects.begin(); it < m_objects.end() && !exists; ++it)
@@ -58,7 +104,8 @@ void problem::ground_final (const symbol &pred, tuple<symbol> objs)
 		assert(("No such object exists.", exists));
 	}
 
-	m_final_state.add(pred_index, objs);
+	m_final_state.add(pred_index, std::move(objs));
+	m_revision = new_revision();
 }
 
 void problem::delete_relax(const problem &prob)
@@ -70,9 +117,11 @@ void problem::delete_relax(const problem &prob)
 	m_objects = prob.m_objects;
 	m_init_state = prob.m_init_state;
 	m_final_state = prob.m_final_state;
+	m_revision = new_revision();
 }
 
 void problem::delete_domain(void)
 {
 	delete m_domain;
+	m_revision = new_revision();
 }
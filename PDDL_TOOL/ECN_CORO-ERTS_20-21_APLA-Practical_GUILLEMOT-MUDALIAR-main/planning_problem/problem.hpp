@@ -7,6 +7,7 @@
 
 #include <cassert>
 #include <string>
+#include <utility>
 #include <vector>
 
 #ifndef SYMBOL
@@ -31,6 +32,9 @@ class problem
 		// The final state
 		state m_final_state;
 
+		// Revision of the problem, renewed by each setter and modifier (see new_revision())
+		unsigned long long m_revision;
+
 	public:
 
 		/** METHODS **/
@@ -39,16 +43,27 @@ class problem
 		problem(void);
 		problem(domain* dom);
 		problem(const problem &prob);
+		problem(problem &&prob) noexcept;
+
+		// Assignments, the domain is shared and not copied
+		problem& operator=(const problem &prob);
+		problem& operator=(problem &&prob) noexcept;
 
 		// Getters
-		domain get_domain(void) const;
-		const std::vector<symbol> get_objects(void) const;
-		const state init_state(void) const;
-		const state final_state(void) const;
-
-		// Setter
-		void set_initial(const state &other);
-		void set_final(const state &other);
+		domain& get_domain(void) const;
+		const std::vector<symbol>& get_objects(void) const;
+		const state& init_state(void) const;
+		const state& final_state(void) const;
+
+		/**
+		 * @return The revision of the problem. Two problems with the same revision are copies
+		 *	   of each other, the revision of their domain telling whether it was modified.
+		*/
+		unsigned long long revision(void) const;
+
+		// Setter, the state is moved in the problem when given as a temporary
+		void set_initial(state other);
+		void set_final(state other);
 
 		// Modifiers
 		void add_object(const symbol &obj);
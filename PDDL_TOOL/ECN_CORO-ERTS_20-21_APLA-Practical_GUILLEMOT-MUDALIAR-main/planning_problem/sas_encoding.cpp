@@ -0,0 +1,528 @@
+#include "sas_encoding.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <deque>
+#include <set>
+#include <string>
+#include <unordered_map>
+
+typedef triplet<int, bool, std::vector<int>> literal;
+
+/**
+ * @return The part of the invariant on the given predicate, or null if the predicate is not
+ *	   in the invariant.
+*/
+static const sas_encoding::part* find_part(const std::vector<sas_encoding::part> &invariant, int predicate)
+{
+	for (const sas_encoding::part &p : invariant)
+	{
+		if ((int)p.first == predicate)
+			return &p;
+	}
+
+	return nullptr;
+}
+
+// True if the literal is a positive pre-condition of the schema, with the same parameters
+static bool required(const std::vector<literal> &preconds, const literal &lit)
+{
+	for (const literal &pre : preconds)
+	{
+		if (!std::get<1>(pre) && std::get<0>(pre) == std::get<0>(lit) && std::get<2>(pre) == std::get<2>(lit))
+			return true;
+	}
+
+	return false;
+}
+
+/**
+ * Checks that the invariant holds for an action schema.
+ * @arg refinements Filled with the refinements of the invariant if the action is unbalanced
+ * @return True if the action never breaks the invariant.
+*/
+static bool balanced(const std::vector<sas_encoding::part> &invariant, const action &act,
+		     const std::vector<unsigned int> &dimensions,
+		     std::vector<std::vector<sas_encoding::part>> &refinements)
+{
+	unsigned int i, arity, nb_params = invariant.front().second.size();
+	const literal *added = nullptr;
+	const sas_encoding::part *p, *q;
+	std::vector<int> binding;
+	std::vector<unsigned int> order;
+	bool bound;
+
+	for (const auto &cond_eff : act.cond_effects())
+	{
+		for (const literal &eff : cond_eff.second)
+		{
+			if (!std::get<1>(eff) && find_part(invariant, std::get<0>(eff)))
+				return false;
+		}
+	}
+
+	// An action adding two predicates of the invariant may add them with the same binding
+	for (const literal &eff : act.effects())
+	{
+		if (std::get<1>(eff) || !find_part(invariant, std::get<0>(eff)))
+			continue;
+
+		if (added && (std::get<0>(*added) != std::get<0>(eff) || std::get<2>(*added) != std::get<2>(eff)))
+			return false;
+		added = &eff;
+	}
+
+	if (!added || required(act.preconds(), *added))
+		return true;
+
+	p = find_part(invariant, std::get<0>(*added));
+	for (unsigned int position : p->second)
+		binding.push_back(std::get<2>(*added)[position]);
+
+	// A predicate of the invariant with the same binding, required and deleted by the action
+	for (const literal &eff : act.effects())
+	{
+		q = find_part(invariant, std::get<0>(eff));
+		if (!std::get<1>(eff) || !q || !required(act.preconds(), eff))
+			continue;
+
+		bound = true;
+		for (i = 0; i < nb_params && bound; ++i)
+			bound = (std::get<2>(eff)[q->second[i]] == binding[i]);
+
+		if (bound)
+			return true;
+	}
+
+	// The other predicates required and deleted by the action, with at most one counted position
+	for (const literal &eff : act.effects())
+	{
+		if (!std::get<1>(eff) || find_part(invariant, std::get<0>(eff)) || !required(act.preconds(), eff))
+			continue;
+
+		arity = (std::get<0>(eff) == 0 ? 0 : dimensions[std::get<0>(eff)]);
+		if (arity < nb_params || arity > nb_params+1)
+			continue;
+
+		order.clear();
+		for (i = 0; i < nb_params; ++i)
+		{
+			auto position = std::find(std::get<2>(eff).begin(), std::get<2>(eff).end(), binding[i]);
+
+			if (position == std::get<2>(eff).end()
+			    || std::find(order.begin(), order.end(), position-std::get<2>(eff).begin()) != order.end())
+				break;
+			order.push_back(position-std::get<2>(eff).begin());
+		}
+
+		if (order.size() == nb_params)
+		{
+			refinements.push_back(invariant);
+			refinements.back().push_back(sas_encoding::part(std::get<0>(eff), order));
+			std::sort(refinements.back().begin(), refinements.back().end());
+		}
+	}
+
+	return false;
+}
+
+/**
+ * Invariant synthesis on the schemas of the domain (see sas_encoding).
+*/
+static std::vector<std::vector<sas_encoding::part>> synthesize(domain &dom, unsigned int max_candidates)
+{
+	bool proved;
+	unsigned int pred, counted, i, nb_candidates = 0;
+	std::vector<unsigned int> dimensions = dom.state_dimensions();
+	std::vector<std::vector<sas_encoding::part>> invariants, refinements;
+	std::vector<sas_encoding::part> candidate;
+	std::deque<std::vector<sas_encoding::part>> waiting_list;
+	std::set<std::vector<sas_encoding::part>> known;
+
+	// The candidates made of one predicate, one of its positions being counted
+	for (pred = 1; pred < dimensions.size(); ++pred)
+	{
+		for (counted = 0; counted < dimensions[pred]; ++counted)
+		{
+			candidate.assign(1, sas_encoding::part(pred, std::vector<unsigned int>()));
+			for (i = 0; i < dimensions[pred]; ++i)
+			{
+				if (i != counted)
+					candidate.back().second.push_back(i);
+			}
+
+			known.insert(candidate);
+			waiting_list.push_back(candidate);
+		}
+	}
+
+	while (!waiting_list.empty() && nb_candidates < max_candidates)
+	{
+		candidate = std::move(waiting_list.front());
+		waiting_list.pop_front();
+		nb_candidates++;
+
+		proved = true;
+		refinements.clear();
+
+		for (action &act : dom)
+		{
+			if (!balanced(candidate, act, dimensions, refinements))
+			{
+				proved = false;
+				break;
+			}
+		}
+
+		if (proved)
+			invariants.push_back(candidate);
+		else
+		{
+			for (std::vector<sas_encoding::part> &refinement : refinements)
+			{
+				if (known.insert(refinement).second)
+					waiting_list.push_back(std::move(refinement));
+			}
+		}
+	}
+
+	return invariants;
+}
+
+sas_encoding::sas_encoding(const problem &prob, const ground_task &task, unsigned int max_candidates):
+	m_task(task), m_nb_bits(0), m_nb_words(0)
+{
+	int best;
+	unsigned int i, v, f, count, best_count, bits, nb_init;
+	std::string key;
+	std::vector<std::vector<unsigned int>> groups;
+	std::unordered_map<std::string, unsigned int> group_indexes;
+	std::vector<bool> covered(task.nb_facts(), false), in_init(task.nb_facts(), false), exact, deleted, added;
+	std::vector<unsigned int> order, used;
+
+	m_invariants = synthesize(prob.get_domain(), max_candidates);
+
+	// Mutex groups: the facts matching an invariant, by binding of its parameters
+	for (i = 0; i < m_invariants.size(); ++i)
+	{
+		for (f = 0; f < task.nb_facts(); ++f)
+		{
+			const part *p = find_part(m_invariants[i], task.fact(f).first);
+
+			if (!p)
+				continue;
+
+			key = std::to_string(i);
+			for (unsigned int position : p->second)
+				key += " " + task.fact(f).second[position];
+
+			auto it = group_indexes.insert({key, groups.size()});
+			if (it.second)
+				groups.emplace_back();
+			groups[it.first->second].push_back(f);
+		}
+	}
+
+	for (unsigned int fact : task.init())
+		in_init[fact] = true;
+
+	// Picking the groups with the most facts not covered yet
+	while (true)
+	{
+		best = -1;
+		best_count = 1;
+
+		for (i = 0; i < groups.size(); ++i)
+		{
+			count = nb_init = 0;
+			for (unsigned int fact : groups[i])
+			{
+				count += !covered[fact];
+				nb_init += in_init[fact];
+			}
+
+			if (count > best_count && nb_init <= 1)
+			{
+				best = i;
+				best_count = count;
+			}
+		}
+
+		if (best < 0)
+			break;
+
+		m_values.emplace_back();
+		for (unsigned int fact : groups[best])
+		{
+			if (!covered[fact])
+			{
+				covered[fact] = true;
+				m_values.back().push_back(fact);
+			}
+		}
+		std::sort(m_values.back().begin(), m_values.back().end());
+		exact.push_back(true);
+	}
+
+	for (f = 0; f < task.nb_facts(); ++f)
+	{
+		if (!covered[f])
+		{
+			m_values.push_back(std::vector<unsigned int>(1, f));
+			exact.push_back(false);
+		}
+	}
+
+	m_variable.assign(task.nb_facts(), 0);
+	m_value.assign(task.nb_facts(), 0);
+	for (v = 0; v < m_values.size(); ++v)
+	{
+		for (unsigned int fact : m_values[v])
+			m_variable[fact] = v;
+	}
+
+	/**
+	 * A group has no "none" value when exactly one of its facts holds in the initial state
+	 * and every action deleting one of them adds another one.
+	*/
+	for (v = 0; v < m_values.size(); ++v)
+	{
+		count = 0;
+		for (unsigned int fact : m_values[v])
+			count += in_init[fact];
+		if (count != 1)
+			exact[v] = false;
+	}
+
+	for (i = 0; i < task.nb_actions(); ++i)
+	{
+		const ground_action &act = task.get_action(i);
+
+		deleted.assign(m_values.size(), false);
+		added.assign(m_values.size(), false);
+
+		for (unsigned int fact : act.del)
+			deleted[m_variable[fact]] = true;
+		for (unsigned int fact : act.add)
+			added[m_variable[fact]] = true;
+
+		for (v = 0; v < m_values.size(); ++v)
+		{
+			if (deleted[v] && !added[v])
+				exact[v] = false;
+		}
+
+		for (const auto &cond_eff : act.cond_effects)
+		{
+			for (unsigned int fact : std::get<3>(cond_eff))
+				exact[m_variable[fact]] = false;
+		}
+	}
+
+	m_none.assign(m_values.size(), true);
+	for (v = 0; v < m_values.size(); ++v)
+	{
+		m_none[v] = !exact[v];
+		for (i = 0; i < m_values[v].size(); ++i)
+			m_value[m_values[v][i]] = i+m_none[v];
+	}
+
+	// Packing the variables by decreasing number of bits
+	m_word.assign(m_values.size(), 0);
+	m_shift.assign(m_values.size(), 0);
+	m_mask.assign(m_values.size(), 0);
+
+	for (v = 0; v < m_values.size(); ++v)
+		order.push_back(v);
+	std::stable_sort(order.begin(), order.end(), [this](unsigned int v1, unsigned int v2)
+		{
+			return domain_size(v1) > domain_size(v2);
+		});
+
+	for (unsigned int var : order)
+	{
+		for (bits = 0; (1ULL << bits) < domain_size(var); ++bits);
+
+		for (i = 0; i < used.size() && used[i]+bits > 64; ++i);
+		if (i == used.size())
+			used.push_back(0);
+
+		m_word[var] = i;
+		m_shift[var] = used[i];
+		m_mask[var] = (bits == 0 ? 0 : ~0ULL >> (64-bits));
+		used[i] += bits;
+		m_nb_bits += bits;
+	}
+
+	m_nb_words = used.size();
+}
+
+const ground_task& sas_encoding::task(void) const { return m_task; }
+
+unsigned int sas_encoding::nb_invariants(void) const { return m_invariants.size(); }
+
+const std::vector<sas_encoding::part>& sas_encoding::invariant(unsigned int index) const { return m_invariants[index]; }
+
+unsigned int sas_encoding::nb_variables(void) const { return m_values.size(); }
+
+unsigned int sas_encoding::domain_size(unsigned int variable) const
+{
+	return m_values[variable].size()+m_none[variable];
+}
+
+const std::vector<unsigned int>& sas_encoding::values(unsigned int variable) const { return m_values[variable]; }
+
+bool sas_encoding::has_none(unsigned int variable) const { return m_none[variable]; }
+
+unsigned int sas_encoding::variable(unsigned int fact) const { return m_variable[fact]; }
+
+unsigned int sas_encoding::nb_bits(void) const { return m_nb_bits; }
+
+unsigned int sas_encoding::nb_words(void) const { return m_nb_words; }
+
+unsigned int sas_encoding::get(const std::uint64_t *words, unsigned int variable) const
+{
+	return (words[m_word[variable]] >> m_shift[variable]) & m_mask[variable];
+}
+
+void sas_encoding::set(std::uint64_t *words, unsigned int variable, unsigned int value) const
+{
+	std::uint64_t &word = words[m_word[variable]];
+
+	word = (word & ~(m_mask[variable] << m_shift[variable])) | ((std::uint64_t)value << m_shift[variable]);
+}
+
+void sas_encoding::reset(std::uint64_t *words, unsigned int fact) const
+{
+	if (holds(fact, words))
+		set(words, m_variable[fact], 0);
+}
+
+void sas_encoding::encode(const std::vector<unsigned int> &facts, std::uint64_t *words) const
+{
+	std::memset(words, 0, m_nb_words*sizeof(std::uint64_t));
+
+	for (unsigned int f : facts)
+		set(words, m_variable[f], m_value[f]);
+}
+
+std::vector<unsigned int> sas_encoding::decode(const std::uint64_t *words) const
+{
+	unsigned int v, val;
+	std::vector<unsigned int> to_return;
+
+	for (v = 0; v < m_values.size(); ++v)
+	{
+		val = get(words, v);
+		if (!m_none[v] || val != 0)
+			to_return.push_back(m_values[v][val-m_none[v]]);
+	}
+
+	std::sort(to_return.begin(), to_return.end());
+
+	return to_return;
+}
+
+unsigned int sas_encoding::value(const std::uint64_t *words, unsigned int variable) const
+{
+	return get(words, variable);
+}
+
+bool sas_encoding::holds(unsigned int fact, const std::uint64_t *words) const
+{
+	return get(words, m_variable[fact]) == m_value[fact];
+}
+
+bool sas_encoding::is_goal(const std::uint64_t *words) const
+{
+	for (unsigned int f : m_task.goal())
+	{
+		if (!holds(f, words))
+			return false;
+	}
+
+	return true;
+}
+
+unsigned int sas_encoding::nb_unsatisfied_goals(const std::uint64_t *words) const
+{
+	unsigned int to_return = 0;
+
+	for (unsigned int f : m_task.goal())
+		to_return += !holds(f, words);
+
+	return to_return;
+}
+
+bool sas_encoding::applicable(unsigned int action, const std::uint64_t *words) const
+{
+	const ground_action &a = m_task.get_action(action);
+
+	for (unsigned int f : a.pre_pos)
+	{
+		if (!holds(f, words))
+			return false;
+	}
+
+	for (unsigned int f : a.pre_neg)
+	{
+		if (holds(f, words))
+			return false;
+	}
+
+	return true;
+}
+
+bool sas_encoding::apply(unsigned int action, const std::uint64_t *source, std::uint64_t *target) const
+{
+	unsigned int i;
+	bool enabled;
+	std::uint64_t mask = 0;
+	std::vector<bool> fired;
+	const ground_action &a = m_task.get_action(action);
+
+	if (!applicable(action, source))
+		return false;
+
+	// As in ground_task::apply(), a mask unless the action has too many conditional effects
+	if (a.cond_effects.size() > 64)
+		fired.resize(a.cond_effects.size(), false);
+
+	// The conditions are evaluated on the source state before it may be modified
+	for (i = 0; i < a.cond_effects.size(); ++i)
+	{
+		enabled = true;
+		for (unsigned int f : std::get<0>(a.cond_effects[i]))
+			enabled = enabled && holds(f, source);
+		for (unsigned int f : std::get<1>(a.cond_effects[i]))
+			enabled = enabled && !holds(f, source);
+
+		if (enabled && fired.empty())
+			mask |= std::uint64_t(1) << i;
+		else if (enabled)
+			fired[i] = true;
+	}
+
+	if (target != source)
+		std::memcpy(target, source, m_nb_words*sizeof(std::uint64_t));
+
+	// As in ground_task::apply(), the deletions come first
+	for (unsigned int f : a.del)
+		reset(target, f);
+	for (unsigned int f : a.add)
+		set(target, m_variable[f], m_value[f]);
+
+	for (i = 0; i < a.cond_effects.size(); ++i)
+	{
+		if (fired.empty() ? (mask & (std::uint64_t(1) << i)) != 0 : fired[i])
+		{
+			for (unsigned int f : std::get<3>(a.cond_effects[i]))
+				reset(target, f);
+			for (unsigned int f : std::get<2>(a.cond_effects[i]))
+				set(target, m_variable[f], m_value[f]);
+		}
+	}
+
+	return true;
+}
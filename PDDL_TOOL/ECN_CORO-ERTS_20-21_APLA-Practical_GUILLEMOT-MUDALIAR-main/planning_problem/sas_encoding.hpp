@@ -0,0 +1,126 @@
+#ifndef SAS_ENCODING_HPP
+#define SAS_ENCODING_HPP
+
+#include "ground_task.hpp"
+#include "problem.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+/**
+ * Finite-domain (SAS+) encoding of the states of a ground task.
+ *
+ * Invariants are first synthesized from the schemas of the domain, as in Helmert's monotonicity
+ * analysis. An invariant is a set of parts, a part being a predicate and, for each parameter
+ * of the invariant, the position of the predicate's parameter bound to it; the other position
+ * of the predicate, if any, is counted. The invariant states that for each binding of its
+ * parameters, at most one grounded predicate matching one of its parts holds, e.g. at most
+ * one of holding(x) and handempty for every state, or at most one of on(x, y), ontable(x) and
+ * holding(x) for each block x. A candidate is proved when every action which may add one of
+ * its predicates:
+ *	- adds at most one of them, unconditionally,
+ *	- and either requires it, or deletes a predicate of the candidate with the same binding
+ *	  that it requires.
+ * An unbalanced action refines the candidate with the other predicates that it deletes and
+ * requires. The synthesis starts with the candidates made of one predicate and one counted
+ * position, and stops after max_candidates candidates.
+ *
+ * The invariants are then grounded on the facts of the task: the facts with the same binding
+ * form a mutex group, kept if at most one of them holds in the initial state. The groups are
+ * picked greedily, the one with the most facts not yet covered first, each giving a variable
+ * whose values are its facts, plus a "none" value unless exactly one of them always holds.
+ * The facts left get a binary variable. Each variable takes the smallest number of bits for
+ * its domain, and the variables are packed into 64-bit words (first fit, by decreasing
+ * number of bits, a variable never straddling two words), so that the states of most tasks
+ * fit in a few words, and hashing, comparing or copying them costs a few word operations.
+ *
+ * The encoding is only defined for the states which satisfy the invariants, which is the case
+ * of every state reachable from the initial state.
+*/
+class sas_encoding
+{
+	public:
+		/**
+		 * A part of an invariant: the index of a predicate's KD-tree in a state, and the
+		 * position of the predicate's parameter bound to each parameter of the invariant.
+		*/
+		typedef std::pair<unsigned int, std::vector<unsigned int>> part;
+
+	private:
+		/** ATTRIBUTES **/
+		const ground_task &m_task;
+
+		// The invariants, as sorted lists of parts
+		std::vector<std::vector<part>> m_invariants;
+
+		/**
+		 * The facts of the values of each variable, and whether its value 0 means that
+		 * none of them holds (the value of a fact is then its position plus 1).
+		*/
+		std::vector<std::vector<unsigned int>> m_values;
+		std::vector<bool> m_none;
+
+		// Variable and value of each fact
+		std::vector<unsigned int> m_variable;
+		std::vector<unsigned int> m_value;
+
+		// Word, shift and mask of the bits of each variable
+		std::vector<unsigned int> m_word;
+		std::vector<unsigned int> m_shift;
+		std::vector<std::uint64_t> m_mask;
+
+		unsigned int m_nb_bits;
+		unsigned int m_nb_words;
+
+		/** METHODS **/
+		unsigned int get(const std::uint64_t *words, unsigned int variable) const;
+		void set(std::uint64_t *words, unsigned int variable, unsigned int value) const;
+
+		// Sets the fact to false, if it holds
+		void reset(std::uint64_t *words, unsigned int fact) const;
+
+	public:
+		/** METHODS **/
+
+		// Constructor, task must be the ground task of prob
+		sas_encoding(const problem &prob, const ground_task &task, unsigned int max_candidates = 1000);
+
+		// Getters
+		const ground_task& task(void) const;
+		unsigned int nb_invariants(void) const;
+		const std::vector<part>& invariant(unsigned int index) const;
+		unsigned int nb_variables(void) const;
+		unsigned int domain_size(unsigned int variable) const;
+
+		// Facts of the values of the variable, without the "none" value if it has one
+		const std::vector<unsigned int>& values(unsigned int variable) const;
+		bool has_none(unsigned int variable) const;
+
+		// Variable of the fact
+		unsigned int variable(unsigned int fact) const;
+
+		/**
+		 * Size of an encoded state: the number of bits used by the variables, and the
+		 * number of 64-bit words holding them.
+		*/
+		unsigned int nb_bits(void) const;
+		unsigned int nb_words(void) const;
+
+		// Conversions between sorted lists of fact indexes and encoded states
+		void encode(const std::vector<unsigned int> &facts, std::uint64_t *words) const;
+		std::vector<unsigned int> decode(const std::uint64_t *words) const;
+
+		// Value of the variable in an encoded state
+		unsigned int value(const std::uint64_t *words, unsigned int variable) const;
+
+		// Same as the methods of ground_task, on states encoded by encode()
+		bool holds(unsigned int fact, const std::uint64_t *words) const;
+		bool is_goal(const std::uint64_t *words) const;
+		unsigned int nb_unsatisfied_goals(const std::uint64_t *words) const;
+		bool applicable(unsigned int action, const std::uint64_t *words) const;
+		bool apply(unsigned int action, const std::uint64_t *source, std::uint64_t *target) const;
+};
+
+#endif // SAS_ENCODING_HPP
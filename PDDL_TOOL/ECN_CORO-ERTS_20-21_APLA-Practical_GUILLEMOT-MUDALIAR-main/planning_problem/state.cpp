@@ -1,40 +1,56 @@
 #include "state.hpp"
 
-state::state(void) : m_size(0), m_gdpredicates(nullptr) {}
+state::state(void) : m_size(0) {}
 
 state::state(const std::vector<unsigned int> &statedims) : m_size(0),
 							   m_dimensions(statedims)
 {
-	unsigned int i = 0;
-
-	m_gdpredicates = new kdt<tuple, symbol>[m_dimensions.size()];
+	unsigned int i;
 
-	for (unsigned int u : m_dimensions)
+	for (i = 0; i < m_dimensions.size(); ++i)
 	{
-		m_gdpredicates[i].set_dimension(u);
-		i++;
+		switch (arity(i))
+		{
+			case 0:
+				m_slots.push_back(m_nullary.size());
+				m_nullary.emplace_back();
+				break;
+			case 1:
+				m_slots.push_back(m_unary.size());
+				m_unary.emplace_back();
+				break;
+			case 2:
+				m_slots.push_back(m_binary.size());
+				m_binary.emplace_back();
+				break;
+			case 3:
+				m_slots.push_back(m_ternary.size());
+				m_ternary.emplace_back();
+				break;
+			case 4:
+				m_slots.push_back(m_quaternary.size());
+				m_quaternary.emplace_back();
+				break;
+			default:
+				m_slots.push_back(m_nary.size());
+				m_nary.emplace_back(m_dimensions[i]);
+		}
 	}
 }
 
-state::state (const state &other) : m_size(0), m_dimensions(other.m_dimensions)
-{
-	unsigned int i = 0;
-
-	m_gdpredicates = new kdt<tuple, symbol>[m_dimensions.size()];
-
-	for (unsigned int u : m_dimensions)
-	{
-		m_gdpredicates[i].set_dimension(u);
-		i++;
-	}
+state::state (const state &other) = default;
 
-	for (i = 0; i < m_dimensions.size(); ++i)
-	{
-		for (tuple<symbol> value : other.m_gdpredicates[i])
-			add(i, value);
-	}
+state::state(state &&other) noexcept : m_size(other.m_size), m_dimensions(std::move(other.m_dimensions)),
+				       m_slots(std::move(other.m_slots)), m_nullary(std::move(other.m_nullary)),
+				       m_unary(std::move(other.m_unary)), m_binary(std::move(other.m_binary)),
+				       m_ternary(std::move(other.m_ternary)),
+				       m_quaternary(std::move(other.m_quaternary)), m_nary(std::move(other.m_nary))
+{
+	other.m_size = 0;
 }
 
+state::~state(void) {}
+
 unsigned int state::size(void) const { return m_size; }
 
 std::vector<unsigned int> state::dimensions(void) const { return m_dimensions; }
@@ -44,26 +60,19 @@ unsigned int state::kdt_size(unsigned int index) const
 	unsigned int to_return = 0;
 
 	if (index < m_dimensions.size())
-		to_return = m_gdpredicates[index].size();
+		to_return = dispatch(index, [](const auto &tree) { return tree.size(); });
 
 	return to_return;
 }
 
 void state::reset(void)
 {
-	unsigned int i = 0;
+	unsigned int i;
 
-	if (m_gdpredicates)
-	{
-		m_size = 0;
-		delete[] m_gdpredicates;
-		m_gdpredicates = new kdt<tuple, symbol>[m_dimensions.size()];
-		for (unsigned int u : m_dimensions)
-		{
-			m_gdpredicates[i].set_dimension(u);
-			i++;
-		}
-	}
+	m_size = 0;
+
+	for (i = 0; i < m_dimensions.size(); ++i)
+		dispatch(i, [](auto &tree) { tree.clear(); });
 }
 
 bool state::empty(void) const
@@ -71,119 +80,170 @@ bool state::empty(void) const
 	bool return_value = true;
 	unsigned int i;
 
-	if (m_gdpredicates)
-	{
-		for (i = 0; i < m_dimensions.size(); ++i)
-			return_value &= !m_gdpredicates[i].empty();
-	}
+	for (i = 0; i < m_dimensions.size() && return_value; ++i)
+		return_value = dispatch(i, [](const auto &tree) { return tree.empty(); });
 
 	return return_value;
 }
 
-bool state::contains(unsigned int index, tuple<symbol> value) const
+bool state::valid(void) const { return !m_dimensions.empty(); }
+
+bool state::contains(unsigned int index, const tuple<symbol> &value) const
 {
-	return m_gdpredicates[index].contains(value);
+	return has(index, value);
 }
 
 void state::add(unsigned int index, tuple<symbol> value)
 {
-	if(!m_gdpredicates[index].insert(value))
+	assert(("Wrong number of parameters for this predicate.", value.size() == arity(index)));
+
+	if (!dispatch(index, [&value](auto &tree) { return tree.insert(std::move(value)); }))
 		m_size++;
 }
 
-void state::erase(unsigned int index, tuple<symbol> value)
+void state::erase(unsigned int index, const tuple<symbol> &value)
 {
-	assert(("Error erasing predicate from state.", m_gdpredicates[index].erase(value) == 0));
+	assert(("Error erasing predicate from state.",
+		dispatch(index, [&value](auto &tree) { return tree.erase(value); }) == 0));
 	m_size--;
 }
 
-bool state::included(const state &other)
+bool state::included(const state &other) const
 {
 	bool is_included = true;
 	unsigned int i;
 
-	if (m_gdpredicates)
+	for (i = 0; i < m_dimensions.size() && is_included; ++i)
 	{
-		for (i = 0; i < m_dimensions.size() && is_included; ++i)
-		{
-			for (tuple<symbol> t : m_gdpredicates[i])
+		for_each(i, [&](const auto &t)
 			{
-				is_included &= other.contains(i, t);
-			}
-		}
+				is_included = is_included && other.has(i, t);
+			});
 	}
 
 	return is_included;
 }
 
-tuple<symbol> state::operator[](unsigned int index) const
+void state::freeze(void)
 {
-	unsigned int curr_index = index, i, total_size(0);
-	tuple<symbol> to_return;
+	for (fixed_kdt<1, symbol> &tree : m_unary)
+		tree.freeze();
+	for (fixed_kdt<2, symbol> &tree : m_binary)
+		tree.freeze();
+	for (fixed_kdt<3, symbol> &tree : m_ternary)
+		tree.freeze();
+	for (fixed_kdt<4, symbol> &tree : m_quaternary)
+		tree.freeze();
+}
+
+std::size_t state::hash(void) const
+{
+	std::size_t to_return = 0, atom_hash;
+	std::hash<symbol> symbol_hash;
+	unsigned int i, j;
 
 	for (i = 0; i < m_dimensions.size(); ++i)
 	{
-		total_size += m_gdpredicates[i].size();
-		if (index < total_size)
-		{
-			to_return = m_gdpredicates[i][curr_index];
-			break;
-		}
-		else
-			curr_index -= m_gdpredicates[i].size();
+		for_each(i, [&](const auto &t)
+			{
+				atom_hash = i;
+				for (j = 0; j < t.size(); ++j)
+					atom_hash = atom_hash*31 + symbol_hash(t[j]);
+
+				// Summing the hashes of the atoms so that the order of the KD-tree does not matter
+				to_return += (atom_hash*0x9e3779b97f4a7c15ULL) ^ (atom_hash >> 29);
+			});
 	}
 
 	return to_return;
 }
 
-state state::operator=(const state &other)
+std::vector<std::pair<unsigned int, tuple<symbol>>> state::atoms(void) const
 {
-	unsigned int i = 0;
+	std::vector<std::pair<unsigned int, tuple<symbol>>> to_return;
+	unsigned int i;
 
-	m_dimensions.clear();
-	if (m_gdpredicates)
-		delete[] m_gdpredicates;
+	to_return.reserve(m_size);
 
-	m_size = 0;
-	m_dimensions = other.m_dimensions;
-	m_gdpredicates = new kdt<tuple, symbol>[m_dimensions.size()];
-
-	for (unsigned int u : m_dimensions)
+	for (i = 0; i < m_dimensions.size(); ++i)
 	{
-		m_gdpredicates[i].set_dimension(u);
-		i++;
+		for_each(i, [&](const auto &t)
+			{
+				to_return.push_back(std::make_pair(i, tuple<symbol>(t)));
+			});
 	}
 
-	for (i = 0; i < m_dimensions.size(); ++i)
+	return to_return;
+}
+
+tuple<symbol> state::at(unsigned int index, unsigned int rank) const
+{
+	return dispatch(index, [rank](const auto &tree) { return tuple<symbol>(tree.at(rank)); });
+}
+
+std::pair<unsigned int, tuple<symbol>> state::atom(unsigned int index) const
+{
+	unsigned int i;
+
+	assert(("Index out of the state.", index < m_size));
+
+	for (i = 0; index >= kdt_size(i); ++i)
+		index -= kdt_size(i);
+
+	return std::make_pair(i, at(i, index));
+}
+
+tuple<symbol> state::operator[](unsigned int index) const
+{
+	tuple<symbol> to_return;
+
+	if (index < m_size)
+		to_return = atom(index).second;
+
+	return to_return;
+}
+
+state& state::operator=(const state &other) = default;
+
+state& state::operator=(state &&other) noexcept
+{
+	if (this != &other)
 	{
-		for (tuple<symbol> value : other.m_gdpredicates[i])
-			add(i, value);
+		m_size = other.m_size;
+		m_dimensions = std::move(other.m_dimensions);
+		m_slots = std::move(other.m_slots);
+		m_nullary = std::move(other.m_nullary);
+		m_unary = std::move(other.m_unary);
+		m_binary = std::move(other.m_binary);
+		m_ternary = std::move(other.m_ternary);
+		m_quaternary = std::move(other.m_quaternary);
+		m_nary = std::move(other.m_nary);
+
+		other.m_size = 0;
 	}
 
 	return *this;
 }
 
-bool state::operator==(const state& other)
+bool state::operator==(const state& other) const
 {
 	bool equal = true;
 	unsigned int i;
 
-	if (m_gdpredicates)
+	for (i = 0; i < m_dimensions.size() && equal; ++i)
 	{
-		for (i = 0; i < m_dimensions.size() && equal; ++i)
-		{
-			for (tuple<symbol> t : m_gdpredicates[i])
-				equal &= other.contains(i, t);
-		}
+		for_each(i, [&](const auto &t)
+			{
+				equal = equal && other.has(i, t);
+			});
 	}
 
-	if (other.m_gdpredicates)
+	for (i = 0; i < other.m_dimensions.size() && equal; ++i)
 	{
-		for (i = 0; i < other.m_dimensions.size() && equal; ++i)
-		{
-			for (tuple<symbol> t : other.m_gdpredicates[i])
-				equal &= contains(i, t);
-		}
+		other.for_each(i, [&](const auto &t)
+			{
+				equal = equal && has(i, t);
+			});
 	}
 
 	return equal;
@@ -191,26 +251,20 @@ bool state::operator==(const state& other)
 
 std::ostream& operator<<(std::ostream &os, const state &s)
 {
-	unsigned int curr_size(0), curr_kdt, curr_index = 0;
-	tuple<symbol>::iterator it;
+	unsigned int curr_kdt, i, nb_kdts = s.dimensions().size();
+	state::const_iterator it = s.begin(), end = s.end();
 
-	for (curr_kdt = 0; curr_kdt < s.dimensions().size(); ++curr_kdt)
+	// Single pass over the grounded predicates, which come in the order of their KD-trees
+	for (curr_kdt = 0; curr_kdt < nb_kdts; ++curr_kdt)
 	{
-		curr_size += s.kdt_size(curr_kdt);
 		os << curr_kdt << ": ";
 
-		for (; curr_index < curr_size; ++curr_index)
+		for (; it != end && it->first == curr_kdt; ++it)
 		{
-			for (it = s[curr_index].begin(); it < s[curr_index].end(); ++it)
-			{
-				if (it == s[curr_index].begin())
-					os << "(";
-				else
-					os << ", ";
-				os << *it;
-				if (it == s[curr_index].end()-1)
-					os << ") ";
-			}
+			for (i = 0; i < it->second.size(); ++i)
+				os << (i == 0 ? "(" : ", ") << it->second[i];
+			if (it->second.size() > 0)
+				os << ") ";
 		}
 		os << "\n";
 	}
@@ -1,12 +1,21 @@
 #ifndef STATE_HPP
 #define STATE_HPP
 
+#include "../data_structures/fixed_kdt.hpp"
 #include "../data_structures/kdt.hpp"
+#include "../data_structures/kdt_range.hpp"
 #include "../data_structures/tuple.hpp"
 
+#include <array>
 #include <cassert>
+#include <cstddef>
+#include <functional>
+#include <iostream>
+#include <iterator>
 #include <map>
 #include <string>
+#include <utility>
+#include <variant>
 #include <vector>
 
 #ifndef SYMBOL
@@ -14,6 +23,31 @@
 	typedef std::string symbol;
 #endif
 
+/**
+ * Parameters of a grounded predicate of a state, seen without any copy: a view on the key of
+ * a KD-tree node (a std::array or a tuple, depending on the arity), valid until the state is
+ * modified or destroyed. It converts to a tuple, which copies the parameters.
+*/
+class params_view
+{
+	public:
+		params_view(void): m_values(nullptr), m_size(0) {}
+
+		template<std::size_t K> params_view(const std::array<symbol, K> &key): m_values(key.data()), m_size(K) {}
+
+		params_view(const tuple<symbol> &key): m_values(key.size() > 0 ? &key[0] : nullptr), m_size(key.size()) {}
+
+		unsigned int size(void) const { return m_size; }
+
+		const symbol& operator[](unsigned int index) const { return m_values[index]; }
+
+		operator tuple<symbol>(void) const { return tuple<symbol>(std::vector<symbol>(m_values, m_values+m_size)); }
+
+	private:
+		const symbol *m_values;
+		unsigned int m_size;
+};
+
 class state
 {
 	private:
@@ -33,8 +67,72 @@ class state
 		*/
 		std::vector<unsigned int> m_dimensions;
 
-		// Array of KD-trees to store the grounded predicates
-		kdt<tuple, symbol>* m_gdpredicates;
+		/**
+		 * KD-trees to store the grounded predicates, specialized by arity. The tree of
+		 * index i is the tree m_slots[i] of the vector of its arity. The tree 0 holds the
+		 * 0-arity predicates, and the predicates with more than 4 parameters are stored in
+		 * KD-trees with a dimension chosen at run time.
+		 * The trees of fixed dimension are persistent: a copy of a state shares their nodes
+		 * with the original, and a modification of the copy only copies the paths to the
+		 * predicates it adds or erases.
+		*/
+		std::vector<unsigned int> m_slots;
+		std::vector<fixed_kdt<0, symbol>> m_nullary;
+		std::vector<fixed_kdt<1, symbol>> m_unary;
+		std::vector<fixed_kdt<2, symbol>> m_binary;
+		std::vector<fixed_kdt<3, symbol>> m_ternary;
+		std::vector<fixed_kdt<4, symbol>> m_quaternary;
+		std::vector<kdt<tuple, symbol>> m_nary;
+
+		/** METHODS **/
+
+		// Number of parameters of the predicates in the tree of the given index
+		unsigned int arity(unsigned int index) const { return index == 0 ? 0 : m_dimensions[index]; }
+
+		// Calls f on the tree of the given index, with its specialized type
+		template<typename F> decltype(auto) dispatch(unsigned int index, F &&f) const
+		{
+			switch (arity(index))
+			{
+				case 0: return f(m_nullary[m_slots[index]]);
+				case 1: return f(m_unary[m_slots[index]]);
+				case 2: return f(m_binary[m_slots[index]]);
+				case 3: return f(m_ternary[m_slots[index]]);
+				case 4: return f(m_quaternary[m_slots[index]]);
+				default: return f(m_nary[m_slots[index]]);
+			}
+		}
+
+		template<typename F> decltype(auto) dispatch(unsigned int index, F &&f)
+		{
+			switch (arity(index))
+			{
+				case 0: return f(m_nullary[m_slots[index]]);
+				case 1: return f(m_unary[m_slots[index]]);
+				case 2: return f(m_binary[m_slots[index]]);
+				case 3: return f(m_ternary[m_slots[index]]);
+				case 4: return f(m_quaternary[m_slots[index]]);
+				default: return f(m_nary[m_slots[index]]);
+			}
+		}
+
+		/**
+		 * Calls f on each grounded predicate of the tree of the given index, given as a
+		 * std::array or a tuple depending on the arity.
+		*/
+		template<typename F> void for_each(unsigned int index, F f) const
+		{
+			dispatch(index, [&f](const auto &tree) { tree.for_each(f); });
+		}
+
+		// contains() for a grounded predicate given as a std::array or a tuple
+		template<typename V> bool has(unsigned int index, const V &value) const
+		{
+			return dispatch(index, [&value](const auto &tree) { return tree.contains(value); });
+		}
+
+		// Grounded predicate of the given rank in the tree of the given index
+		tuple<symbol> at(unsigned int index, unsigned int rank) const;
 
 	public:
 		/** METHODS **/
@@ -42,9 +140,9 @@ class state
 		// Constructors
 
 		/**
-		 * Default constructor creating the empty state.
-		 * The empty state is returned when trying to apply an action on a state
-		 * which doesnt fullfil the pre-conditions of the action.
+		 * Default constructor creating the invalid state, without any KD-tree.
+		 * The invalid state is returned when trying to apply an action on a state
+		 * which doesnt fullfil the pre-conditions of the action (see valid()).
 		*/
 		state(void);
 
@@ -58,6 +156,15 @@ class state
 		*/
 		state(const state &other);
 
+		/**
+		 * Move constructor, the KD-trees are taken from other which is left as the empty
+		 * state.
+		*/
+		state(state &&other) noexcept;
+
+		// Destructor
+		~state(void);
+
 		// Getter
 		unsigned int size(void) const;
 		std::vector<unsigned int> dimensions(void) const;
@@ -66,15 +173,156 @@ class state
 		// Others
 		void reset(void);
 		bool empty(void) const;
-		bool contains(unsigned int index, tuple<symbol> value) const;
+
+		/**
+		 * False for the state built by the default constructor. A valid state may hold no
+		 * grounded predicate at all, so empty() cannot tell a state without any predicate
+		 * from the result of an action which was not applicable.
+		*/
+		bool valid(void) const;
+		bool contains(unsigned int index, const tuple<symbol> &value) const;
+
+		// contains() for parameters given without any copy, e.g. a params_view
+		template<typename V> bool contains(unsigned int index, const V &value) const { return has(index, value); }
+
 		void add(unsigned int index, tuple<symbol> value);
-		void erase(unsigned int index, tuple<symbol> value);
-		bool included(const state &other);
+		void erase(unsigned int index, const tuple<symbol> &value);
+		bool included(const state &other) const;
+
+		/**
+		 * Freezes the KD-trees of the predicates with 1 to 4 parameters (see fixed_kdt),
+		 * for a state which will only be queried, copied or iterated from now on. A later
+		 * modification of a tree rebuilds it. The frozen trees do not share their values
+		 * with the states the state was copied from, so freezing only pays off for a state
+		 * which is queried many times.
+		*/
+		void freeze(void);
+
+		/**
+		 * Calls f on each grounded predicate of the tree of the given index within range
+		 * (see kdt_range), e.g. on every connected(rm1, y) with the pattern (rm1, ?). The
+		 * predicate is given without any copy, as a std::array or a tuple depending on the
+		 * arity.
+		*/
+		template<typename F> void match(unsigned int index, const kdt_range<symbol> &range, F f) const
+		{
+			dispatch(index, [&range, &f](const auto &tree) { tree.match(range, f); });
+		}
+
+		/**
+		 * Hash of the set of grounded predicates. It does not depend on the shape of the
+		 * KD-trees, so two equal states always have the same hash.
+		*/
+		std::size_t hash(void) const;
+
+		/**
+		 * All the grounded predicates of the state along with the index of their KD-tree,
+		 * in a single pass over the KD-trees.
+		*/
+		std::vector<std::pair<unsigned int, tuple<symbol>>> atoms(void) const;
+
+		/**
+		 * The grounded predicate of the given index in the order of the iterators, with the
+		 * index of its KD-tree. The KD-trees find it in O(log n) with the sizes of their
+		 * subtrees.
+		*/
+		std::pair<unsigned int, tuple<symbol>> atom(unsigned int index) const;
+
+		/** ITERATOR **/
+
+		/**
+		 * Forward iterator over the grounded predicates of the state, along with the index of
+		 * their KD-tree, in the order of the KD-trees and then in the order of each tree. The
+		 * trees are walked by their own iterators, so that an increment takes constant
+		 * amortized time, and the parameters are a view on the keys of the trees (see
+		 * params_view): the state must not be modified while iterated.
+		*/
+		class const_iterator
+		{
+			public:
+				using iterator_category = std::forward_iterator_tag;
+				using value_type = std::pair<unsigned int, params_view>;
+				using difference_type = std::ptrdiff_t;
+				using pointer = const value_type*;
+				using reference = const value_type&;
+
+				const_iterator(void): m_state(nullptr), m_tree(0) {}
+
+				reference operator*(void) const { return m_atom; }
+				pointer operator->(void) const { return &m_atom; }
+
+				const_iterator& operator++(void)
+				{
+					std::visit([](auto &it) { ++it; }, m_position);
+					settle();
+					return *this;
+				}
+
+				const_iterator operator++(int)
+				{
+					const_iterator tmp(*this);
+					++(*this);
+					return tmp;
+				}
+
+				bool operator==(const const_iterator &rhs) const { return m_tree == rhs.m_tree && m_position == rhs.m_position; }
+				bool operator!=(const const_iterator &rhs) const { return !(*this == rhs); }
+
+			private:
+				friend class state;
+
+				// Position in the current tree, and end of the tree
+				typedef std::variant<fixed_kdt<0, symbol>::const_iterator, fixed_kdt<1, symbol>::const_iterator,
+						     fixed_kdt<2, symbol>::const_iterator, fixed_kdt<3, symbol>::const_iterator,
+						     fixed_kdt<4, symbol>::const_iterator,
+						     kdt<tuple, symbol>::const_iterator> position;
+
+				const state *m_state;
+				unsigned int m_tree;
+				position m_position;
+				position m_end;
+				value_type m_atom;
+
+				const_iterator(const state *s, unsigned int tree): m_state(s), m_tree(tree)
+				{
+					if (m_tree < m_state->m_dimensions.size())
+						enter();
+					settle();
+				}
+
+				void enter(void)
+				{
+					m_state->dispatch(m_tree, [this](const auto &tree)
+						{
+							m_position = tree.begin();
+							m_end = tree.end();
+						});
+				}
+
+				// Skips the end of the current tree and the empty trees, then loads the predicate
+				void settle(void)
+				{
+					while (m_tree < m_state->m_dimensions.size() && m_position == m_end)
+					{
+						if (++m_tree < m_state->m_dimensions.size())
+							enter();
+					}
+
+					if (m_tree < m_state->m_dimensions.size())
+						m_atom = value_type(m_tree, std::visit([](const auto &it) { return params_view(*it); }, m_position));
+					else
+						m_position = m_end = position();
+				}
+		};
+
+		const_iterator begin(void) const { return const_iterator(this, 0); }
+		const_iterator end(void) const { return const_iterator(this, m_dimensions.size()); }
 
 		/** OPERATOR **/
 		tuple<symbol> operator[](unsigned int index) const;
-		state operator=(const state &other);
-		bool operator==(const state &other);
+		state& operator=(const state &other);
+		state& operator=(state &&other) noexcept;
+		bool operator==(const state &other) const;
 };
 
 std::ostream& operator<<(std::ostream &os, const state &s);
@@ -0,0 +1,171 @@
+#include "stubborn_sets.hpp"
+
+#include <algorithm>
+
+stubborn_sets::stubborn_sets(const ground_task &task, unsigned int min_calls, double min_ratio):
+	m_task(task), m_min_calls(min_calls), m_min_ratio(min_ratio), m_enabled(true),
+	m_calls(0), m_applicable(0), m_pruned(0), m_in_set(task.nb_actions(), false)
+{
+	unsigned int a, f, nb_facts = task.nb_facts();
+	std::vector<std::vector<unsigned int>> writers(2*nb_facts), readers(2*nb_facts);
+
+	m_achievers.resize(2*nb_facts);
+	m_interference.resize(task.nb_actions());
+
+	for (a = 0; a < task.nb_actions(); ++a)
+	{
+		const ground_action &act = task.get_action(a);
+
+		for (unsigned int p : act.pre_pos)
+			readers[p].push_back(a);
+		for (unsigned int p : act.pre_neg)
+			readers[p+nb_facts].push_back(a);
+
+		for (unsigned int e : act.add)
+			writers[e].push_back(a);
+		for (unsigned int e : act.del)
+			writers[e+nb_facts].push_back(a);
+
+		for (const auto &cond_eff : act.cond_effects)
+		{
+			for (unsigned int c : std::get<0>(cond_eff))
+			{
+				readers[c].push_back(a);
+				readers[c+nb_facts].push_back(a);
+			}
+			for (unsigned int c : std::get<1>(cond_eff))
+			{
+				readers[c].push_back(a);
+				readers[c+nb_facts].push_back(a);
+			}
+
+			for (unsigned int e : std::get<2>(cond_eff))
+				writers[e].push_back(a);
+			for (unsigned int e : std::get<3>(cond_eff))
+				writers[e+nb_facts].push_back(a);
+		}
+	}
+
+	for (f = 0; f < 2*nb_facts; ++f)
+	{
+		m_achievers[f] = writers[f];
+		m_achievers[f].erase(std::unique(m_achievers[f].begin(), m_achievers[f].end()), m_achievers[f].end());
+
+		// The writers of the negation of f interfere with the readers and writers of f
+		for (unsigned int w : writers[f < nb_facts ? f+nb_facts : f-nb_facts])
+		{
+			for (unsigned int r : readers[f])
+			{
+				m_interference[w].push_back(r);
+				m_interference[r].push_back(w);
+			}
+
+			for (unsigned int r : writers[f])
+			{
+				m_interference[w].push_back(r);
+				m_interference[r].push_back(w);
+			}
+		}
+	}
+
+	for (a = 0; a < task.nb_actions(); ++a)
+	{
+		std::sort(m_interference[a].begin(), m_interference[a].end());
+		m_interference[a].erase(std::unique(m_interference[a].begin(), m_interference[a].end()),
+					m_interference[a].end());
+	}
+}
+
+const ground_task& stubborn_sets::task(void) const { return m_task; }
+
+bool stubborn_sets::enabled(void) const { return m_enabled; }
+
+unsigned long long stubborn_sets::nb_calls(void) const { return m_calls; }
+
+unsigned long long stubborn_sets::nb_applicable(void) const { return m_applicable; }
+
+unsigned long long stubborn_sets::nb_pruned(void) const { return m_pruned; }
+
+/**
+ * @return The literal of pos (facts) or neg (negated facts) which does not hold in the state
+ *	   and has the fewest achievers, or -1 if they all hold.
+*/
+int stubborn_sets::unsatisfied_literal(const std::vector<unsigned int> &pos, const std::vector<unsigned int> &neg,
+				       const unsigned char *buffer) const
+{
+	int to_return = -1;
+
+	for (unsigned int f : pos)
+	{
+		if (!m_task.holds(f, buffer)
+		    && (to_return < 0 || m_achievers[f].size() < m_achievers[to_return].size()))
+			to_return = f;
+	}
+
+	for (unsigned int f : neg)
+	{
+		if (m_task.holds(f, buffer)
+		    && (to_return < 0 || m_achievers[f+m_task.nb_facts()].size() < m_achievers[to_return].size()))
+			to_return = f+m_task.nb_facts();
+	}
+
+	return to_return;
+}
+
+std::vector<unsigned int> stubborn_sets::prune(const unsigned char *buffer, const std::vector<unsigned int> &applicable)
+{
+	int literal;
+	unsigned int i;
+	std::vector<unsigned int> set, to_return;
+	static const std::vector<unsigned int> no_facts;
+
+	// The pruning did not pay off
+	if (m_enabled && m_calls == m_min_calls && m_pruned < m_min_ratio*m_applicable)
+		m_enabled = false;
+
+	m_calls++;
+	m_applicable += applicable.size();
+
+	if (!m_enabled)
+		return applicable;
+
+	literal = unsatisfied_literal(m_task.goal(), no_facts, buffer);
+	if (literal < 0)
+		return applicable;
+
+	// The set, which is also the queue of the actions to close over
+	for (unsigned int a : m_achievers[literal])
+	{
+		m_in_set[a] = true;
+		set.push_back(a);
+	}
+
+	for (i = 0; i < set.size(); ++i)
+	{
+		const ground_action &act = m_task.get_action(set[i]);
+
+		literal = unsatisfied_literal(act.pre_pos, act.pre_neg, buffer);
+
+		for (unsigned int b : literal < 0 ? m_interference[set[i]] : m_achievers[literal])
+		{
+			if (!m_in_set[b])
+			{
+				m_in_set[b] = true;
+				set.push_back(b);
+			}
+		}
+	}
+
+	for (unsigned int a : applicable)
+	{
+		if (m_in_set[a])
+			to_return.push_back(a);
+	}
+
+	for (unsigned int a : set)
+		m_in_set[a] = false;
+
+	m_pruned += applicable.size()-to_return.size();
+
+	return to_return;
+}
@@ -0,0 +1,87 @@
+#ifndef STUBBORN_SETS_HPP
+#define STUBBORN_SETS_HPP
+
+#include "ground_task.hpp"
+
+#include <vector>
+
+/**
+ * Strong stubborn set pruning (partial-order reduction) over a ground task.
+ * In a state which is not a goal, a strong stubborn set S is built from the actions which
+ * may make an unsatisfied goal fact true, and is closed by:
+ *	- adding, for each action of S applicable in the state, all the actions interfering with it,
+ *	- adding, for each action of S not applicable in the state, the actions which may make
+ *	  one of its unsatisfied pre-conditions true (the one with the fewest achievers).
+ * Only the applicable actions of S need to be expanded: the pruning keeps at least one optimal
+ * plan from every state, so an optimal search stays optimal.
+ * Two actions interfere if one of them writes a literal whose negation the other one requires
+ * or writes. A conditional effect may write its literals, and reads its conditions in both
+ * values.
+ *
+ * The pruning is taken by astar(), bucket_astar(), breadth_first_search(), delta_astar(),
+ * external_search(), bitstate_search(), beam_search(), enforced_hill_climbing(), iw_search(),
+ * bfws() and the lookahead of real_time_search. The other engines do not take it: the sets are
+ * built towards the goal, not towards the partial states met by bidirectional_search(), their
+ * combination with the symmetry reduction of orbit_search() is not proved safe, the walks of
+ * random_walk_search() sample one applicable action at a time instead of expanding the states,
+ * and the symbolic, SAT-based and regression-based engines do not expand states one by one.
+ *
+ * Building the sets costs some time at each expansion: when less than min_ratio of the
+ * applicable actions are pruned after min_calls calls to prune(), the pruning is disabled and
+ * prune() returns all the applicable actions.
+*/
+class stubborn_sets
+{
+	private:
+		/** ATTRIBUTES **/
+		const ground_task &m_task;
+
+		/**
+		 * Actions which may make each literal true, the literal of the fact f being f and
+		 * the literal of its negation f+nb_facts.
+		*/
+		std::vector<std::vector<unsigned int>> m_achievers;
+
+		// Interference table: the actions interfering with each action
+		std::vector<std::vector<unsigned int>> m_interference;
+
+		unsigned int m_min_calls;
+		double m_min_ratio;
+		bool m_enabled;
+
+		unsigned long long m_calls;
+		unsigned long long m_applicable;
+		unsigned long long m_pruned;
+
+		// Membership of the actions in the set being built
+		std::vector<bool> m_in_set;
+
+		/** METHODS **/
+		int unsatisfied_literal(const std::vector<unsigned int> &pos, const std::vector<unsigned int> &neg,
+					const unsigned char *buffer) const;
+
+	public:
+		/** METHODS **/
+
+		// Constructor
+		stubborn_sets(const ground_task &task, unsigned int min_calls = 1000, double min_ratio = 0.2);
+
+		// Getters
+		const ground_task& task(void) const;
+		bool enabled(void) const;
+
+		// Number of calls to prune(), and of applicable actions given to and pruned by it
+		unsigned long long nb_calls(void) const;
+		unsigned long long nb_applicable(void) const;
+		unsigned long long nb_pruned(void) const;
+
+		/**
+		 * @arg buffer An encoded state (see ground_task::encode())
+		 * @arg applicable The indexes of the ground actions applicable in the state
+		 * @return The actions of applicable which belong to a strong stubborn set of the state,
+		 *	   in the same order.
+		*/
+		std::vector<unsigned int> prune(const unsigned char *buffer, const std::vector<unsigned int> &applicable);
+};
+
+#endif // STUBBORN_SETS_HPP
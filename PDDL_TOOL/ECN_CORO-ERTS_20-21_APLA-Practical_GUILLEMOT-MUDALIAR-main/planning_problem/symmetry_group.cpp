@@ -0,0 +1,168 @@
+#include "symmetry_group.hpp"
+#include "../data_structures/graph_automorphisms.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+symmetry_group::symmetry_group(const problem &prob, const ground_task &task, unsigned long long max_nodes):
+	m_task(task), m_objects(prob.get_objects()), m_nodes(0)
+{
+	unsigned int o, f, i;
+	int image;
+	bool valid;
+	graph_automorphisms graph;
+	std::vector<symbol> constants = prob.get_domain().constants();
+	std::vector<symbol> params;
+	std::vector<unsigned int> objects;
+
+	// Color of each label of the vertices
+	std::unordered_map<std::string, unsigned int> colors;
+
+	auto color = [&colors](const std::string &label)
+		{
+			return colors.insert({label, colors.size()}).first->second;
+		};
+
+	// Vertices of the objects
+	for (o = 0; o < m_objects.size(); ++o)
+	{
+		m_object_indexes.insert({m_objects[o], o});
+
+		if (std::find(constants.begin(), constants.end(), m_objects[o]) != constants.end())
+			graph.add_vertex(color("constant " + m_objects[o]));
+		else
+			graph.add_vertex(color("object"));
+	}
+
+	// Vertices of the facts of the initial state and of the goal
+	auto add_facts = [&](const std::vector<unsigned int> &facts, const std::string &kind)
+		{
+			for (unsigned int f : facts)
+			{
+				const std::pair<unsigned int, tuple<symbol>> &fact = m_task.fact(f);
+				std::string label = kind + " " + std::to_string(fact.first);
+				unsigned int vertex = graph.add_vertex(color(label));
+
+				for (unsigned int p = 0; p < fact.second.size(); ++p)
+				{
+					unsigned int param = graph.add_vertex(color(label + " " + std::to_string(p)));
+
+					graph.add_edge(vertex, param);
+					graph.add_edge(param, m_object_indexes.at(fact.second[p]));
+				}
+			}
+		};
+
+	add_facts(m_task.init(), "init");
+	add_facts(m_task.goal(), "goal");
+
+	for (const std::vector<unsigned int> &generator : graph.generators(max_nodes))
+	{
+		objects.assign(generator.begin(), generator.begin()+m_objects.size());
+		m_fact_generators.push_back(std::vector<unsigned int>(m_task.nb_facts()));
+		valid = true;
+
+		for (f = 0; f < m_task.nb_facts() && valid; ++f)
+		{
+			const std::pair<unsigned int, tuple<symbol>> &fact = m_task.fact(f);
+
+			params.clear();
+			for (i = 0; i < fact.second.size(); ++i)
+				params.push_back(m_objects[objects[m_object_indexes.at(fact.second[i])]]);
+
+			image = m_task.fact_index(fact.first, tuple<symbol>(params));
+			valid = (image >= 0);
+			m_fact_generators.back()[f] = image;
+		}
+
+		if (valid)
+			m_object_generators.push_back(objects);
+		else
+			m_fact_generators.pop_back();
+	}
+
+	m_nodes = graph.nb_nodes();
+}
+
+const ground_task& symmetry_group::task(void) const { return m_task; }
+
+unsigned int symmetry_group::nb_generators(void) const { return m_object_generators.size(); }
+
+unsigned long long symmetry_group::nb_nodes(void) const { return m_nodes; }
+
+const std::vector<unsigned int>& symmetry_group::fact_generator(unsigned int index) const
+{
+	return m_fact_generators[index];
+}
+
+void symmetry_group::canonicalize(unsigned char *buffer, std::vector<unsigned int> *permutation) const
+{
+	bool improved = true;
+	unsigned int g, o;
+	std::vector<unsigned int> facts = m_task.decode(buffer), image;
+	std::vector<unsigned char> candidate(m_task.state_bytes());
+
+	while (improved)
+	{
+		improved = false;
+
+		for (g = 0; g < m_fact_generators.size(); ++g)
+		{
+			image.clear();
+			for (unsigned int f : facts)
+				image.push_back(m_fact_generators[g][f]);
+			std::sort(image.begin(), image.end());
+
+			m_task.encode(image, candidate.data());
+
+			if (std::memcmp(candidate.data(), buffer, candidate.size()) < 0)
+			{
+				std::memcpy(buffer, candidate.data(), candidate.size());
+				facts.swap(image);
+				improved = true;
+
+				if (permutation)
+				{
+					for (o = 0; o < permutation->size(); ++o)
+						(*permutation)[o] = m_object_generators[g][(*permutation)[o]];
+				}
+			}
+		}
+	}
+}
+
+std::vector<unsigned int> symmetry_group::identity(void) const
+{
+	std::vector<unsigned int> to_return(m_objects.size());
+
+	for (unsigned int o = 0; o < to_return.size(); ++o)
+		to_return[o] = o;
+
+	return to_return;
+}
+
+std::vector<unsigned int> symmetry_group::inverse(const std::vector<unsigned int> &permutation)
+{
+	std::vector<unsigned int> to_return(permutation.size());
+
+	for (unsigned int o = 0; o < permutation.size(); ++o)
+		to_return[permutation[o]] = o;
+
+	return to_return;
+}
+
+std::vector<symbol> symmetry_group::permute(const std::vector<symbol> &name,
+					    const std::vector<unsigned int> &permutation) const
+{
+	std::vector<symbol> to_return(name);
+	std::unordered_map<symbol, unsigned int>::const_iterator it;
+
+	for (unsigned int i = 1; i < to_return.size(); ++i)
+	{
+		it = m_object_indexes.find(to_return[i]);
+		if (it != m_object_indexes.end())
+			to_return[i] = m_objects[permutation[it->second]];
+	}
+
+	return to_return;
+}
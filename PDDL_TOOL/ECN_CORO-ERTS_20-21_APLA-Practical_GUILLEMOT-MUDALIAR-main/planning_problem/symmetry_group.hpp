@@ -0,0 +1,81 @@
+#ifndef SYMMETRY_GROUP_HPP
+#define SYMMETRY_GROUP_HPP
+
+#include "ground_task.hpp"
+#include "problem.hpp"
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#ifndef SYMBOL
+#define SYMBOL
+	typedef std::string symbol;
+#endif
+
+/**
+ * Object symmetries of a problem: permutations of its objects mapping the initial state on
+ * itself and the goal on itself. They are the automorphisms of the problem description graph,
+ * whose vertices are:
+ *	- the objects, the constants of the domain having their own color since the actions may
+ *	  refer to them,
+ *	- the facts of the initial state and of the goal, colored by their kind and predicate,
+ *	- one vertex for each parameter of these facts, colored by the kind, the predicate and the
+ *	  position of the parameter, linked to its fact and to its object.
+ * The generators of the group are computed once (see graph_automorphisms), and turned into
+ * permutations of the objects and of the facts of the ground task. A generator which maps a
+ * fact outside of the ground task is dropped.
+ *
+ * Two states in the same orbit have the same optimal cost to the goal, so a search may only
+ * keep one state of each orbit. The canonical state of an orbit is approximated greedily:
+ * a generator is applied as long as it gives a lexicographically smaller encoded state. The
+ * same canonical state may then be reached for two symmetric states or not, which only costs
+ * some pruning.
+*/
+class symmetry_group
+{
+	private:
+		/** ATTRIBUTES **/
+		const ground_task &m_task;
+
+		// The objects of the problem and their indexes
+		std::vector<symbol> m_objects;
+		std::unordered_map<symbol, unsigned int> m_object_indexes;
+
+		// The generators, as permutations of the object indexes and of the fact indexes
+		std::vector<std::vector<unsigned int>> m_object_generators;
+		std::vector<std::vector<unsigned int>> m_fact_generators;
+
+		// Number of nodes of the search for the automorphisms
+		unsigned long long m_nodes;
+
+	public:
+		/** METHODS **/
+
+		// Constructor, task must be the ground task of prob
+		symmetry_group(const problem &prob, const ground_task &task, unsigned long long max_nodes = 100000);
+
+		// Getters
+		const ground_task& task(void) const;
+		unsigned int nb_generators(void) const;
+		unsigned long long nb_nodes(void) const;
+		const std::vector<unsigned int>& fact_generator(unsigned int index) const;
+
+		/**
+		 * Replaces an encoded state (see ground_task::encode()) by the canonical state of its
+		 * orbit.
+		 * @arg permutation If not null, composed on the left with the object permutation
+		 *		    mapping the state on its canonical state. It must hold a permutation
+		 *		    of the objects (the identity from identity()).
+		*/
+		void canonicalize(unsigned char *buffer, std::vector<unsigned int> *permutation = nullptr) const;
+
+		// Object permutations
+		std::vector<unsigned int> identity(void) const;
+		static std::vector<unsigned int> inverse(const std::vector<unsigned int> &permutation);
+
+		// @return The ground action name (name followed by the parameters) with its objects permuted
+		std::vector<symbol> permute(const std::vector<symbol> &name, const std::vector<unsigned int> &permutation) const;
+};
+
+#endif // SYMMETRY_GROUP_HPP
@@ -8,21 +8,145 @@ bool max_count(unsigned int nb_params, unsigned int nb_objects, unsigned int *co
 void increment_count(unsigned int nb_params, unsigned int nb_objects,
 		     unsigned int *counter, unsigned int index)
 {
-	counter[index] = ++counter[index]%nb_objects;
+	// The last counter only flags that all the combinations have been enumerated
+	if (index == nb_params)
+		counter[index] = 1;
+	else
+	{
+		counter[index] = (counter[index]+1)%nb_objects;
 
-	if (counter[index] == 0 && index <= nb_params)
-		increment_count(nb_params, nb_objects, counter, ++index);
+		if (counter[index] == 0)
+			increment_count(nb_params, nb_objects, counter, ++index);
+	}
 }
 
-path astar(const problem &prob, heuristic h, unsigned int power)
+/**
+ * @return a+b, or UINT_MAX if the sum overflows. UINT_MAX stands for an infinite cost, e.g. the
+ *	   heuristic value of a dead end.
+*/
+static inline unsigned int saturated_sum(unsigned int a, unsigned int b)
+{
+	return (a > UINT_MAX-b ? UINT_MAX : a+b);
+}
+
+std::vector<successor> successors(const problem &prob, const state &current, stubborn_sets *pruning)
 {
-	bool found = false;
 	int i;
-	unsigned int current_cost, heur_value, *obj_indexes;
+	unsigned int j;
+	state next;
+	const std::vector<symbol> &objects = prob.get_objects();
+	std::vector<symbol> params;
+	std::vector<unsigned int> obj_indexes;
+	std::vector<std::vector<unsigned int>> combinations;
+	std::unordered_map<symbol, unsigned int> object_positions;
+	std::unordered_map<symbol, unsigned int>::iterator position;
+	std::vector<successor> to_return;
+
+	for (j = 0; j < objects.size(); ++j)
+		object_positions.insert({objects[j], j});
+
+	// For each action, try to build valid states
+	for (action &a : prob.get_domain())
+	{
+		combinations.clear();
+
+		// Only the combinations of objects fulfilling the positive pre-conditions are tried
+		for (const std::vector<symbol> &candidate : a.matching_params(current, objects))
+		{
+			obj_indexes.clear();
+			for (const symbol &param : candidate)
+			{
+				position = object_positions.find(param);
+				if (position == object_positions.end())
+					break;
+				obj_indexes.push_back(position->second);
+			}
+
+			if (obj_indexes.size() == candidate.size())
+				combinations.push_back(obj_indexes);
+		}
+
+		// In the order of the enumeration of all the combinations, which breaks the ties between successors
+		std::sort(combinations.begin(), combinations.end());
+
+		for (const std::vector<unsigned int> &combination : combinations)
+		{
+			for (unsigned int obj_index : combination)
+				params.push_back(objects[obj_index]);
+
+			next = a.apply(current, params);
+
+			// If we found a valid state
+			if (next.valid())
+			{
+				params.insert(params.begin(), a.name());
+				to_return.emplace_back(std::move(next), std::move(params), a.cost());
+			}
+
+			params.clear();
+		}
+	}
+
+	// Keeping the successors of the ground actions in the stubborn set
+	if (pruning && pruning->enabled())
+	{
+		const ground_task &task = pruning->task();
+		std::vector<unsigned char> buffer(task.state_bytes());
+		std::vector<unsigned int> applicable, kept;
+		std::vector<successor> pruned;
+
+		task.encode(task.facts(current), buffer.data());
+
+		for (const successor &succ : to_return)
+		{
+			applicable.push_back(task.action_index(std::get<1>(succ)));
+			assert(("The stubborn sets are not built on the ground task of the problem.", (int)applicable.back() >= 0));
+		}
+
+		kept = pruning->prune(buffer.data(), applicable);
+
+		for (i = 0, j = 0; i < (int)to_return.size() && j < kept.size(); ++i)
+		{
+			if (applicable[i] == kept[j])
+			{
+				pruned.push_back(std::move(to_return[i]));
+				j++;
+			}
+		}
+
+		to_return.swap(pruned);
+	}
+
+	return to_return;
+}
+
+/**
+ * @arg buffer A state encoded by the ground task of pruning (see ground_task::encode())
+ * @return The ground actions applicable in the state which belong to a strong stubborn set of it.
+*/
+static std::vector<unsigned int> stubborn_actions(stubborn_sets &pruning, const unsigned char *buffer)
+{
+	const ground_task &task = pruning.task();
+	std::vector<unsigned int> applicable;
+
+	for (unsigned int a = 0; a < task.nb_actions(); ++a)
+	{
+		if (task.applicable(a, buffer))
+			applicable.push_back(a);
+	}
+
+	return pruning.prune(buffer, applicable);
+}
+
+path astar(const problem &prob, heuristic h, unsigned int power, stubborn_sets *pruning, pool_statistics *stats)
+{
+	pool_scope memory(stats);
+	bool found = false;
+	unsigned int current_cost, heur_value;
 
 	path p;
-	state current_state, next, final_state = prob.final_state();
-	std::vector<symbol> objects = prob.get_objects(), params;
+	state current_state;
+	const state &final_state = prob.final_state();
 	std::vector<std::pair<state, unsigned int>> waiting_list;
 
 	/**
@@ -45,7 +169,7 @@ path astar(const problem &prob, heuristic h, unsigned int power)
 	// Main loop
 	while (!waiting_list.empty())
 	{
-		current_state = waiting_list.back().first;
+		current_state = std::move(waiting_list.back().first);
 		waiting_list.pop_back();
 
 		// FOR TEST PURPOSES ONLY
@@ -73,59 +197,44 @@ path astar(const problem &prob, heuristic h, unsigned int power)
 			break;
 		}
 
-		// For each action, try to build valid states
-		for (action a : prob.get_domain())
+		// For each valid successor of the current state
+		for (successor &succ : successors(prob, current_state, pruning))
 		{
-			obj_indexes = new unsigned int[a.nbparams()+1];
+			state &next = std::get<0>(succ);
+			std::vector<symbol> &params = std::get<1>(succ);
+			heur_value = h(prob, next, power);
 
-			for (i = 0; i < a.nbparams(); ++i)
-				obj_indexes[i] = 0;
-
-			// While loop over all the possible combinations of objects
-			while (!max_count(a.nbparams(), objects.size(), obj_indexes))
+			// FOR TEST PURPOSES ONLY
+			if (h == critical_path)
 			{
-				for (i = a.nbparams()-1; i >= 0; --i)
-					params.push_back(objects[obj_indexes[i]]);
-
-				next = a.apply(current_state, params);
+				printf("Next state:\n");
+				std::cout << next;
+				printf("\tHeuristic value = %d\n\n", heur_value);
+			}
+			// END OF TEST
 
-				// If we found a valid state
-				if (!next.empty())
+			for (preds_it = preds.begin(); preds_it < preds.end(); ++preds_it)
+			{
+				if (std::get<0>(*preds_it) == next)
 				{
-					heur_value = h(prob, next, power);
-
-					// FOR TEST PURPOSES ONLY
-					if (h == critical_path)
-					{
-						printf("Next state:\n");
-						std::cout << next;
-						printf("\tHeuristic value = %d\n\n", heur_value);
-					}
-					// END OF TEST
-
-					params.insert(params.begin(), a.name());
-
-					for (preds_it = preds.begin(); preds_it < preds.end(); ++preds_it)
-					{
-						if (std::get<0>(*preds_it) == next)
-						{
-							if (std::get<2>(*preds_it) > current_cost+a.cost())
-							{
-								*preds_it = {std::get<0>(*preds_it), state(current_state), current_cost+a.cost(), params};
-								waiting_list.push_back({next, current_cost+a.cost()+heur_value});
-							}
-							break;
-						}
-					}
-					if (preds_it == preds.end())
+					if (std::get<2>(*preds_it) > current_cost+std::get<2>(succ))
 					{
-						preds.push_back({next, state(current_state), current_cost+a.cost(), params});
-						waiting_list.push_back({next, current_cost+a.cost()+heur_value});
+						std::get<1>(*preds_it) = current_state;
+						std::get<2>(*preds_it) = current_cost+std::get<2>(succ);
+						std::get<3>(*preds_it) = std::move(params);
+						if (heur_value != UINT_MAX)
+							waiting_list.push_back({std::move(next), saturated_sum(current_cost+std::get<2>(succ), heur_value)});
 					}
+					break;
 				}
+			}
+			if (preds_it == preds.end())
+			{
+				preds.push_back({next, current_state, current_cost+std::get<2>(succ), std::move(params)});
 
-				params.clear();
-				increment_count(a.nbparams(), objects.size(), obj_indexes);
+				// The dead ends are recorded, but never expanded
+				if (heur_value != UINT_MAX)
+					waiting_list.push_back({std::move(next), saturated_sum(current_cost+std::get<2>(succ), heur_value)});
 			}
 		}
 
@@ -141,7 +250,8 @@ path astar(const problem &prob, heuristic h, unsigned int power)
 
 		std::get<2>(p) = std::get<2>(*preds_it);
 
-		while (!std::get<1>(*preds_it).empty())
+		// The predecessor of the initial state is the invalid state
+		while (std::get<1>(*preds_it).valid())
 		{
 			path_states.push(std::get<0>(*preds_it));
 			path_actions.push(std::get<3>(*preds_it));
@@ -172,74 +282,3215 @@ path astar(const problem &prob, heuristic h, unsigned int power)
 	return p;
 }
 
-unsigned int zero_heuristic(const problem &prob, const state &init, unsigned int power)
+/**
+ * Builds the path leading to nodes[goal]. The items in a node correspond to:
+ *	- the state which is considered,
+ *	- the index of its predecessor in nodes (the root is at index 0),
+ *	- the cost to reach this state,
+ *	- the action that leaded to this state.
+*/
+static path extract_path(const std::vector<std::tuple<state, unsigned int, unsigned int,
+			 std::vector<symbol>>> &nodes, unsigned int goal)
 {
-	return 0;
+	unsigned int node;
+	path p;
+
+	std::stack<state> path_states;
+	std::stack<std::vector<symbol>> path_actions;
+
+	std::get<2>(p) = std::get<2>(nodes[goal]);
+
+	for (node = goal; node != 0; node = std::get<1>(nodes[node]))
+	{
+		path_states.push(std::get<0>(nodes[node]));
+		path_actions.push(std::get<3>(nodes[node]));
+	}
+	path_states.push(std::get<0>(nodes[0]));
+
+	while (!path_states.empty())
+	{
+		std::get<0>(p).push_back(path_states.top());
+		path_states.pop();
+	}
+
+	while (!path_actions.empty())
+	{
+		std::get<1>(p).push_back(path_actions.top());
+		path_actions.pop();
+	}
+
+	return p;
 }
 
-unsigned int delete_relaxation(const problem &prob, const state &init, unsigned int power)
+path bucket_astar(const problem &prob, heuristic h, unsigned int power, stubborn_sets *pruning,
+		  pool_statistics *stats)
+{
+	pool_scope memory(stats);
+	bool unit_costs = (h == zero_heuristic);
+	unsigned int current, next_cost, priority, max_cost = 0;
+	std::pair<unsigned int, unsigned int> entry;
+
+	const state &final_state = prob.final_state();
+	std::vector<std::tuple<state, unsigned int, unsigned int, std::vector<symbol>>> nodes;
+	std::vector<unsigned int> heur_values;
+	std::unordered_map<state, unsigned int, state_hasher> node_indexes;
+	std::unordered_map<state, unsigned int, state_hasher>::iterator node_it;
+
+	// Waiting list of (node index, cost to reach the node when it was pushed)
+	bucket_queue<std::pair<unsigned int, unsigned int>> waiting_list;
+
+	for (action &a : prob.get_domain())
+	{
+		unit_costs &= (a.cost() == 1);
+		max_cost = std::max(max_cost, a.cost());
+	}
+
+	if (unit_costs)
+		return breadth_first_search(prob, pruning, stats);
+
+	// The queue has one bucket per f-value up to the largest one, most of them empty with large costs
+	if (max_cost > 64)
+		return astar(prob, h, power, pruning, stats);
+
+	// Initialization
+	nodes.push_back({prob.init_state(), 0, 0, std::vector<symbol>()});
+	heur_values.push_back(h(prob, std::get<0>(nodes.back()), power));
+	node_indexes.insert({std::get<0>(nodes.back()), 0});
+
+	// The dead ends, and the states whose estimated cost overflows, are never pushed
+	if (heur_values.back() != UINT_MAX)
+		waiting_list.push({0, 0}, heur_values.back());
+
+	// Main loop
+	while (!waiting_list.empty())
+	{
+		entry = waiting_list.pop();
+		current = entry.first;
+
+		// A cheaper path to this node has been found since it was pushed
+		if (entry.second > std::get<2>(nodes[current]))
+			continue;
+
+		// Checking if we reached the final state
+		if (final_state.included(std::get<0>(nodes[current])))
+			return extract_path(nodes, current);
+
+		for (successor &succ : successors(prob, std::get<0>(nodes[current]), pruning))
+		{
+			next_cost = saturated_sum(std::get<2>(nodes[current]), std::get<2>(succ));
+			node_it = node_indexes.find(std::get<0>(succ));
+
+			if (node_it == node_indexes.end())
+			{
+				node_indexes.insert({std::get<0>(succ), nodes.size()});
+				nodes.push_back({std::move(std::get<0>(succ)), current, next_cost, std::move(std::get<1>(succ))});
+				heur_values.push_back(h(prob, std::get<0>(nodes.back()), power));
+
+				priority = saturated_sum(next_cost, heur_values.back());
+				if (priority != UINT_MAX)
+					waiting_list.push({nodes.size()-1, next_cost}, priority);
+			}
+			else if (next_cost < std::get<2>(nodes[node_it->second]))
+			{
+				std::get<1>(nodes[node_it->second]) = current;
+				std::get<2>(nodes[node_it->second]) = next_cost;
+				std::get<3>(nodes[node_it->second]) = std::get<1>(succ);
+
+				priority = saturated_sum(next_cost, heur_values[node_it->second]);
+				if (priority != UINT_MAX)
+					waiting_list.push({node_it->second, next_cost}, priority);
+			}
+		}
+	}
+
+	return path();
+}
+
+path breadth_first_search(const problem &prob, stubborn_sets *pruning, pool_statistics *stats)
+{
+	pool_scope memory(stats);
+	unsigned int current;
+
+	const state &final_state = prob.final_state();
+	std::vector<std::tuple<state, unsigned int, unsigned int, std::vector<symbol>>> nodes;
+	std::unordered_set<state, state_hasher> visited;
+
+	// The list of nodes is also the FIFO waiting list
+	nodes.push_back({prob.init_state(), 0, 0, std::vector<symbol>()});
+	visited.insert(std::get<0>(nodes.back()));
+
+	if (final_state.included(std::get<0>(nodes.back())))
+		return extract_path(nodes, 0);
+
+	for (current = 0; current < nodes.size(); ++current)
+	{
+		for (successor &succ : successors(prob, std::get<0>(nodes[current]), pruning))
+		{
+			if (!visited.insert(std::get<0>(succ)).second)
+				continue;
+
+			nodes.push_back({std::move(std::get<0>(succ)), current,
+					 std::get<2>(nodes[current])+std::get<2>(succ), std::move(std::get<1>(succ))});
+
+			if (final_state.included(std::get<0>(nodes.back())))
+				return extract_path(nodes, nodes.size()-1);
+		}
+	}
+
+	return path();
+}
+
+path delta_astar(const problem &prob, heuristic h, unsigned int power, unsigned int checkpoint_interval,
+		 unsigned int cache_size, stubborn_sets *pruning, delta_statistics *stats)
 {
+	pool_scope memory(stats ? &stats->memory : nullptr);
+	int found = -1, known;
+	unsigned int current, next_cost, priority, node;
+	std::pair<unsigned int, unsigned int> entry;
+	delta_statistics local_stats = {0, 0, 0, 0, 0, 0, 0, 0, pool_statistics()};
+
 	path p;
-	problem relaxed_prob;
+	state current_state;
+	const state &final_state = prob.final_state();
+	std::vector<unsigned int> path_nodes;
+
+	// The states, of the same indexes as their nodes
+	delta_store closed(checkpoint_interval, cache_size);
 
 	/**
-	 * Eliminating all negative effects of the initial problem and the negative effects
-	 * in the conditional effects
+	 * Search nodes. The items in a tuple correspond to:
+	 *	- the index of the predecessor (the root is at index 0),
+	 *	- the cost to reach the state,
+	 *	- the heuristic value of the state,
+	 *	- the action that leaded to the state.
 	*/
-	relaxed_prob.delete_relax(prob);
+	std::vector<std::tuple<unsigned int, unsigned int, unsigned int, std::vector<symbol>>> nodes;
+
+	// Waiting list of (node index, cost to reach the node when it was pushed)
+	bucket_queue<std::pair<unsigned int, unsigned int>> waiting_list;
+
+	// Initialization
+	closed.insert(prob.init_state());
+	nodes.push_back({0, 0, h(prob, prob.init_state(), power), std::vector<symbol>()});
+
+	// The dead ends stay in the closed list, so that they are not evaluated again, but are never pushed
+	if (std::get<2>(nodes.back()) != UINT_MAX)
+		waiting_list.push({0, 0}, std::get<2>(nodes.back()));
+
+	// Main loop
+	while (found < 0 && !waiting_list.empty())
+	{
+		entry = waiting_list.pop();
+		current = entry.first;
+
+		// A cheaper path to this node has been found since it was pushed
+		if (entry.second > std::get<1>(nodes[current]))
+			continue;
+
+		current_state = closed.get(current);
+
+		// Checking if we reached the final state
+		if (final_state.included(current_state))
+		{
+			found = current;
+			continue;
+		}
+
+		local_stats.expansions++;
+
+		for (successor &succ : successors(prob, current_state, pruning))
+		{
+			local_stats.generated++;
+			next_cost = saturated_sum(std::get<1>(nodes[current]), std::get<2>(succ));
+			known = closed.find(std::get<0>(succ));
+
+			if (known < 0)
+			{
+				// The delta is taken from the state being expanded, which is in the cache
+				closed.insert(std::get<0>(succ), current);
+				nodes.push_back({current, next_cost, h(prob, std::get<0>(succ), power), std::move(std::get<1>(succ))});
+
+				priority = saturated_sum(next_cost, std::get<2>(nodes.back()));
+				if (priority != UINT_MAX)
+					waiting_list.push({nodes.size()-1, next_cost}, priority);
+			}
+			else if (next_cost < std::get<1>(nodes[known]))
+			{
+				std::get<0>(nodes[known]) = current;
+				std::get<1>(nodes[known]) = next_cost;
+				std::get<3>(nodes[known]) = std::move(std::get<1>(succ));
+
+				priority = saturated_sum(next_cost, std::get<2>(nodes[known]));
+				if (priority != UINT_MAX)
+					waiting_list.push({(unsigned int)known, next_cost}, priority);
+			}
+		}
+	}
 
-	relaxed_prob.set_initial(init);
+	if (found >= 0)
+	{
+		for (node = found; node != 0; node = std::get<0>(nodes[node]))
+			path_nodes.push_back(node);
+		path_nodes.push_back(0);
 
-	// Solving the relaxed problem using Dijkstra
-	p = astar(relaxed_prob, zero_heuristic);
+		// Rebuilding the states from the root, so that each one is one delta from the previous one
+		for (auto it = path_nodes.rbegin(); it != path_nodes.rend(); ++it)
+		{
+			std::get<0>(p).push_back(closed.get(*it));
+			if (*it != 0)
+				std::get<1>(p).push_back(std::get<3>(nodes[*it]));
+		}
+		std::get<2>(p) = std::get<1>(nodes[found]);
+	}
 
-	relaxed_prob.delete_domain();
+	if (stats)
+	{
+		local_stats.stored = closed.size();
+		local_stats.checkpoints = closed.nb_checkpoints();
+		local_stats.delta_atoms = closed.nb_delta_atoms();
+		local_stats.cache_hits = closed.nb_cache_hits();
+		local_stats.cache_misses = closed.nb_cache_misses();
+		local_stats.applied_deltas = closed.nb_applied_deltas();
+		*stats = local_stats;
+	}
 
-	// Returning the total cost
-	return std::get<2>(p);
+	return p;
 }
 
-unsigned int critical_path(const problem &prob, const state &init, unsigned int power)
+/**
+ * @return True if the two sorted lists have a common element.
+*/
+static bool intersects(const std::vector<unsigned int> &l1, const std::vector<unsigned int> &l2)
 {
-	bool updated;
-	int i, j;
-	path p;
-	problem new_p(prob);
-	state s(prob.get_domain().state_dimensions());
-	unsigned int total_size, pred_indexes[power], h_max(0);
+	std::vector<unsigned int>::const_iterator it1 = l1.begin(), it2 = l2.begin();
 
-	assert(("Cannot use critical_path heuristic with the current power value, not enough predicate in the final state to create a subset of predicate of this size.", power <= prob.final_state().size()));
+	while (it1 != l1.end() && it2 != l2.end())
+	{
+		if (*it1 < *it2)
+			++it1;
+		else if (*it2 < *it1)
+			++it2;
+		else
+			return true;
+	}
 
-	// Initializing the predicate indexes to the first power-size combination
-	for (i = 0; i < power; ++i)
-		pred_indexes[i] = i;
+	return false;
+}
 
-	// Initializing the initial state
-	new_p.set_initial(init);
+/**
+ * Regresses the partial state (pos, neg) through a ground action.
+ * The action must add a fact of pos or delete a fact of neg, and must not contradict the
+ * partial state. Actions whose conditional effects touch the partial state are not regressed.
+ * @return False if the partial state cannot be regressed through the action.
+*/
+static bool regress(const ground_action &a, const std::vector<unsigned int> &pos,
+		    const std::vector<unsigned int> &neg, std::vector<unsigned int> &new_pos,
+		    std::vector<unsigned int> &new_neg)
+{
+	std::vector<unsigned int> remaining;
 
-	while (pred_indexes[0] < prob.final_state().size()-power
-	       || pred_indexes[power-1] <= prob.final_state().size()-1)
+	if (!intersects(a.add, pos) && !intersects(a.del, neg))
+		return false;
+
+	if (intersects(a.del, pos) || intersects(a.add, neg))
+		return false;
+
+	for (const std::tuple<std::vector<unsigned int>, std::vector<unsigned int>,
+			      std::vector<unsigned int>, std::vector<unsigned int>> &cond_eff : a.cond_effects)
 	{
-		// Initializing the final state
-		for (i = 0; i < power; ++i)
+		if (intersects(std::get<2>(cond_eff), pos) || intersects(std::get<2>(cond_eff), neg)
+		    || intersects(std::get<3>(cond_eff), pos) || intersects(std::get<3>(cond_eff), neg))
+			return false;
+	}
+
+	new_pos.clear();
+	new_neg.clear();
+
+	std::set_difference(pos.begin(), pos.end(), a.add.begin(), a.add.end(),
+			    std::back_inserter(remaining));
+	std::set_union(remaining.begin(), remaining.end(), a.pre_pos.begin(), a.pre_pos.end(),
+		       std::back_inserter(new_pos));
+
+	remaining.clear();
+	std::set_difference(neg.begin(), neg.end(), a.del.begin(), a.del.end(),
+			    std::back_inserter(remaining));
+	std::set_union(remaining.begin(), remaining.end(), a.pre_neg.begin(), a.pre_neg.end(),
+		       std::back_inserter(new_neg));
+
+	return !intersects(new_pos, new_neg);
+}
+
+/**
+ * @return The indexes of the ground actions which add a fact of pos or delete a fact of neg.
+ * candidate is a buffer of nb_actions() false values, restored before returning.
+*/
+static std::vector<unsigned int> relevant_actions(const ground_task &task,
+	const std::vector<unsigned int> &pos, const std::vector<unsigned int> &neg,
+	std::vector<bool> &candidate)
+{
+	std::vector<unsigned int> to_return;
+
+	for (unsigned int f : pos)
+	{
+		for (unsigned int a : task.achievers(f))
 		{
-			// Finding the index of the KD-tree to add the predicate
-			total_size = 0;
+			if (!candidate[a])
+			{
+				candidate[a] = true;
+				to_return.push_back(a);
+			}
+		}
+	}
+
+	for (unsigned int f : neg)
+	{
+		for (unsigned int a : task.deleters(f))
+		{
+			if (!candidate[a])
+			{
+				candidate[a] = true;
+				to_return.push_back(a);
+			}
+		}
+	}
+
+	for (unsigned int a : to_return)
+		candidate[a] = false;
+
+	return to_return;
+}
+
+/**
+ * @return The facts and the negated facts (shifted by nb_facts) of a partial state.
+*/
+static std::vector<unsigned int> literals(const std::vector<unsigned int> &pos,
+					  const std::vector<unsigned int> &neg, unsigned int nb_facts)
+{
+	std::vector<unsigned int> to_return(pos);
+
+	for (unsigned int f : neg)
+		to_return.push_back(f+nb_facts);
+
+	return to_return;
+}
+
+/**
+ * Applies a ground action (its name followed by its parameters) on a state.
+*/
+static state apply_ground_action(const problem &prob, const state &s, const std::vector<symbol> &act)
+{
+	for (action &a : prob.get_domain())
+	{
+		if (a.name() == act[0])
+			return a.apply(s, std::vector<symbol>(act.begin()+1, act.end()));
+	}
+
+	return state();
+}
+
+path bidirectional_search(const problem &prob, bidirectional_statistics *stats)
+{
+	int meeting = -1;
+	unsigned int fwd_begin = 0, bwd_begin = 0, fwd_end, bwd_end, current, fwd_node, bwd_node;
+	bidirectional_statistics local_stats = {0, 0, 0};
+
+	path p;
+	ground_task task(prob);
+	std::vector<unsigned int> new_pos, new_neg, facts;
+
+	// Forward nodes, as in breadth_first_search(), and their facts
+	std::vector<std::tuple<state, unsigned int, unsigned int, std::vector<symbol>>> fwd_nodes;
+	std::unordered_set<state, state_hasher> visited;
+	subset_index fwd_facts;
+
+	/**
+	 * Backward nodes. The items in a tuple correspond to:
+	 *	- the facts which must be false in the partial state,
+	 *	- the index of the partial state it was regressed from,
+	 *	- the cost to reach the goal from it,
+	 *	- the index of the ground action it was regressed through.
+	 * bwd_pos holds the facts which must be true and bwd_literals all its literals, the
+	 * indexes of the sets being those of the nodes.
+	*/
+	std::vector<std::tuple<std::vector<unsigned int>, unsigned int, unsigned int, unsigned int>> bwd_nodes;
+	subset_index bwd_pos, bwd_literals;
+	std::vector<bool> candidate;
+
+	// Initialization
+	fwd_nodes.push_back({prob.init_state(), 0, 0, std::vector<symbol>()});
+	visited.insert(std::get<0>(fwd_nodes.back()));
+	fwd_facts.insert(task.init());
+
+	bwd_nodes.push_back({std::vector<unsigned int>(), 0, 0, 0});
+	bwd_pos.insert(task.goal());
+	bwd_literals.insert(task.goal());
+
+	candidate.assign(task.nb_actions(), false);
+
+	if (std::includes(task.init().begin(), task.init().end(), task.goal().begin(), task.goal().end()))
+		meeting = 0;
+
+	fwd_node = bwd_node = 0;
+
+	/**
+	 * The regression skips the actions whose conditional effects touch the partial state, so
+	 * the backward search may run out of partial states while the goal is reachable: the
+	 * forward search then goes on alone, the goal being the first backward node.
+	*/
+	while (meeting < 0 && fwd_begin < fwd_nodes.size())
+	{
+		fwd_end = fwd_nodes.size();
+		bwd_end = bwd_nodes.size();
 
-			for (j = 0; j < prob.final_state().dimensions().size(); ++j)
+		// Expanding the smallest layer
+		if (bwd_begin == bwd_end || fwd_end-fwd_begin <= bwd_end-bwd_begin)
+		{
+			for (current = fwd_begin; current < fwd_end && meeting < 0; ++current)
 			{
-				total_size += prob.final_state().kdt_size(j);
-				if (pred_indexes[i] < total_size)
+				local_stats.forward_expansions++;
+
+				for (successor succ : successors(prob, std::get<0>(fwd_nodes[current])))
 				{
-					s.add(j, prob.final_state()[pred_indexes[i]]);
-					break;
+					if (!visited.insert(std::get<0>(succ)).second)
+						continue;
+
+					fwd_nodes.push_back({std::get<0>(succ), current,
+							     std::get<2>(fwd_nodes[current])+std::get<2>(succ),
+							     std::get<1>(succ)});
+					facts = task.facts(std::get<0>(succ));
+					fwd_facts.insert(facts);
+
+					// Looking for a partial state satisfied by the new state
+					meeting = bwd_pos.find_subset(facts, [&](unsigned int index)
+						{
+							return !intersects(std::get<0>(bwd_nodes[index]), facts);
+						});
+
+					if (meeting >= 0)
+					{
+						fwd_node = fwd_nodes.size()-1;
+						bwd_node = meeting;
+						break;
+					}
 				}
 			}
+			fwd_begin = fwd_end;
+		}
+		else
+		{
+			for (current = bwd_begin; current < bwd_end && meeting < 0; ++current)
+			{
+				local_stats.backward_expansions++;
+
+				for (unsigned int a : relevant_actions(task, bwd_pos[current],
+								       std::get<0>(bwd_nodes[current]), candidate))
+				{
+					if (meeting >= 0 || !regress(task.get_action(a), bwd_pos[current],
+								     std::get<0>(bwd_nodes[current]),
+								     new_pos, new_neg))
+						continue;
+
+					// Pruning the partial states subsumed by a known one
+					if (bwd_literals.find_subset(literals(new_pos, new_neg, task.nb_facts()),
+								     [](unsigned int) { return true; }) >= 0)
+					{
+						local_stats.subsumed++;
+						continue;
+					}
+
+					bwd_nodes.push_back({new_neg, current,
+							     std::get<2>(bwd_nodes[current])+task.get_action(a).cost, a});
+					bwd_pos.insert(new_pos);
+					bwd_literals.insert(literals(new_pos, new_neg, task.nb_facts()));
+
+					// Looking for a forward state satisfying the new partial state
+					meeting = fwd_facts.find_superset(new_pos, [&](unsigned int index)
+						{
+							return !intersects(new_neg, fwd_facts[index]);
+						});
+
+					if (meeting >= 0)
+					{
+						fwd_node = meeting;
+						bwd_node = bwd_nodes.size()-1;
+					}
+				}
+			}
+			bwd_begin = bwd_end;
+		}
+	}
+
+	// Joining the forward path and the actions of the backward path
+	if (meeting >= 0)
+	{
+		p = extract_path(fwd_nodes, fwd_node);
+
+		for (current = bwd_node; current != 0; current = std::get<1>(bwd_nodes[current]))
+		{
+			std::get<1>(p).push_back(task.get_action(std::get<3>(bwd_nodes[current])).name);
+			std::get<0>(p).push_back(apply_ground_action(prob, std::get<0>(p).back(),
+								     std::get<1>(p).back()));
+			std::get<2>(p) += task.get_action(std::get<3>(bwd_nodes[current])).cost;
+		}
+	}
+
+	if (stats)
+		*stats = local_stats;
+
+	return p;
+}
+
+path regression_search(const problem &prob, regression_statistics *stats)
+{
+	int found = -1;
+	unsigned int current, next_cost;
+	regression_statistics local_stats = {0, 0, 0};
+
+	path p;
+	ground_task task(prob);
+	planning_graph graph(task, task.init());
+	std::vector<unsigned int> new_pos, new_neg, new_literals;
+	std::vector<bool> candidate(task.nb_actions(), false);
+
+	/**
+	 * Nodes of the search. The items in a tuple correspond to:
+	 *	- the facts which must be false in the partial state,
+	 *	- the index of the partial state it was regressed from,
+	 *	- the cost to reach the goal from it,
+	 *	- the index of the ground action it was regressed through.
+	 * The facts which must be true are stored in pos, and all the literals in closed, with
+	 * the same indexes as the nodes.
+	*/
+	std::vector<std::tuple<std::vector<unsigned int>, unsigned int, unsigned int, unsigned int>> nodes;
+	subset_index pos, closed;
+	bucket_queue<unsigned int> waiting_list;
+
+	// The literals and mutexes of the last layer hold in every state reachable from the initial state
+	while (graph.expand());
+
+	// Initialization
+	nodes.push_back({std::vector<unsigned int>(), 0, 0, 0});
+	pos.insert(task.goal());
+	closed.insert(task.goal());
+	waiting_list.push(0, 0);
+
+	// Main loop
+	while (!waiting_list.empty())
+	{
+		current = waiting_list.pop();
+
+		// Checking if the initial state satisfies the partial state
+		if (std::includes(task.init().begin(), task.init().end(), pos[current].begin(), pos[current].end())
+		    && !intersects(std::get<0>(nodes[current]), task.init()))
+		{
+			found = current;
+			break;
+		}
+
+		local_stats.expansions++;
+
+		for (unsigned int a : relevant_actions(task, pos[current], std::get<0>(nodes[current]), candidate))
+		{
+			if (!regress(task.get_action(a), pos[current], std::get<0>(nodes[current]), new_pos, new_neg))
+				continue;
+
+			next_cost = std::get<2>(nodes[current])+task.get_action(a).cost;
+			new_literals = literals(new_pos, new_neg, task.nb_facts());
+
+			if (graph.goal_level(new_literals) == UINT_MAX)
+			{
+				local_stats.unreachable++;
+				continue;
+			}
+
+			// Pruning the partial states subsumed by a known one which is not more expensive
+			if (closed.find_subset(new_literals, [&](unsigned int index)
+				{
+					return std::get<2>(nodes[index]) <= next_cost;
+				}) >= 0)
+			{
+				local_stats.subsumed++;
+				continue;
+			}
+
+			nodes.push_back({new_neg, current, next_cost, a});
+			pos.insert(new_pos);
+			closed.insert(new_literals);
+			waiting_list.push(nodes.size()-1, next_cost);
+		}
+	}
+
+	// The actions are applied from the initial state, in the reverse order of the regression
+	if (found >= 0)
+	{
+		std::get<0>(p).push_back(prob.init_state());
+
+		for (current = found; current != 0; current = std::get<1>(nodes[current]))
+		{
+			std::get<1>(p).push_back(task.get_action(std::get<3>(nodes[current])).name);
+			std::get<0>(p).push_back(apply_ground_action(prob, std::get<0>(p).back(),
+								     std::get<1>(p).back()));
+		}
+
+		std::get<2>(p) = std::get<2>(nodes[found]);
+	}
+
+	if (stats)
+		*stats = local_stats;
+
+	return p;
+}
+
+/**
+ * Sorts the records of buffer on their first key_size bytes and appends them to run, without
+ * the duplicates. buffer is emptied.
+*/
+static void spill_run(std::vector<unsigned char> &buffer, unsigned int record_size,
+		      unsigned int key_size, segment_file &run, external_layer_statistics &stats)
+{
+	unsigned int i;
+	std::vector<unsigned int> order(buffer.size()/record_size);
+	std::vector<unsigned char> sorted;
+
+	for (i = 0; i < order.size(); ++i)
+		order[i] = i;
+
+	std::stable_sort(order.begin(), order.end(), [&](unsigned int r1, unsigned int r2)
+		{
+			return std::memcmp(&buffer[r1*record_size], &buffer[r2*record_size], key_size) < 0;
+		});
+
+	for (i = 0; i < order.size(); ++i)
+	{
+		if (i > 0 && std::memcmp(&buffer[order[i]*record_size], &buffer[order[i-1]*record_size],
+					 key_size) == 0)
+			continue;
+
+		sorted.insert(sorted.end(), buffer.begin()+order[i]*record_size,
+			      buffer.begin()+(order[i]+1)*record_size);
+	}
+
+	run.append(sorted.data(), sorted.size()/record_size);
+	stats.bytes_written += sorted.size();
+	stats.runs++;
+	buffer.clear();
+}
+
+/**
+ * Merges the sorted runs into layer, dropping the states of the closed list, and writes the
+ * union of closed and layer (keys only) into next_closed.
+*/
+static void merge_runs(std::vector<std::unique_ptr<segment_file>> &runs, segment_file &closed,
+		       segment_file &layer, segment_file &next_closed, unsigned int key_size,
+		       external_layer_statistics &stats)
+{
+	const std::size_t block = 4096;
+	unsigned int record_size = layer.record_size(), r;
+	std::size_t closed_pos = 0;
+	const unsigned char *record, *last = nullptr, *closed_keys = closed.map();
+	std::vector<std::size_t> positions(runs.size(), 0);
+	std::vector<unsigned char> layer_out, closed_out;
+
+	// Min-heap of the current record of each run
+	auto compare = [&](const std::pair<const unsigned char*, unsigned int> &r1,
+			   const std::pair<const unsigned char*, unsigned int> &r2)
+		{
+			return std::memcmp(r1.first, r2.first, key_size) > 0;
+		};
+	std::vector<std::pair<const unsigned char*, unsigned int>> heap;
+
+	for (r = 0; r < runs.size(); ++r)
+	{
+		stats.bytes_read += runs[r]->size()*record_size;
+		if (runs[r]->size() > 0)
+			heap.push_back({runs[r]->record(0), r});
+	}
+	stats.bytes_read += closed.size()*key_size;
+	std::make_heap(heap.begin(), heap.end(), compare);
+
+	while (!heap.empty())
+	{
+		std::pop_heap(heap.begin(), heap.end(), compare);
+		record = heap.back().first;
+		r = heap.back().second;
+
+		if (!last || std::memcmp(record, last, key_size) != 0)
+		{
+			// Copying the smaller states of the closed list
+			while (closed_pos < closed.size()
+			       && std::memcmp(closed_keys+closed_pos*key_size, record, key_size) < 0)
+			{
+				closed_out.insert(closed_out.end(), closed_keys+closed_pos*key_size,
+						  closed_keys+(closed_pos+1)*key_size);
+				closed_pos++;
+			}
+
+			// A new state
+			if (closed_pos == closed.size()
+			    || std::memcmp(closed_keys+closed_pos*key_size, record, key_size) != 0)
+			{
+				layer_out.insert(layer_out.end(), record, record+record_size);
+				closed_out.insert(closed_out.end(), record, record+key_size);
+			}
+
+			last = record;
+		}
+
+		if (++positions[r] < runs[r]->size())
+		{
+			heap.back().first = runs[r]->record(positions[r]);
+			std::push_heap(heap.begin(), heap.end(), compare);
+		}
+		else
+			heap.pop_back();
+
+		if (layer_out.size() >= block*record_size)
+		{
+			layer.append(layer_out.data(), layer_out.size()/record_size);
+			stats.bytes_written += layer_out.size();
+			layer_out.clear();
+		}
+		if (closed_out.size() >= block*key_size)
+		{
+			next_closed.append(closed_out.data(), closed_out.size()/key_size);
+			stats.bytes_written += closed_out.size();
+			closed_out.clear();
+		}
+	}
+
+	if (closed_pos < closed.size())
+		closed_out.insert(closed_out.end(), closed_keys+closed_pos*key_size,
+				  closed_keys+closed.size()*key_size);
+
+	layer.append(layer_out.data(), layer_out.size()/record_size);
+	next_closed.append(closed_out.data(), closed_out.size()/key_size);
+	stats.bytes_written += layer_out.size()+closed_out.size();
+}
+
+path external_search(const problem &prob, const std::string &directory, unsigned int buffer_size,
+		     stubborn_sets *pruning, external_statistics *stats)
+{
+	bool found, init_goal;
+	unsigned int key_size, record_size, layer = 0, action_index, no_action = UINT_MAX;
+	std::size_t current, goal_parent = 0;
+	external_statistics local_stats;
+	external_layer_statistics layer_stats;
+	std::chrono::steady_clock::time_point start;
+
+	path p;
+	ground_task task(prob);
+	scratch_directory scratch(directory, "external");
+	const unsigned char *records;
+	std::vector<unsigned char> buffer, next_state, goal_state;
+	std::vector<std::vector<unsigned char>> path_states;
+	std::vector<unsigned int> path_actions, all_actions, kept;
+	const std::vector<unsigned int> *candidates;
+
+	/**
+	 * The records of a layer are the encoded state followed by the index of the ground action
+	 * which generated it, the closed list only stores the encoded states.
+	*/
+	std::vector<std::unique_ptr<segment_file>> layers, runs;
+	std::unique_ptr<segment_file> closed, next_closed;
+
+	key_size = task.state_bytes();
+	record_size = key_size+sizeof(unsigned int);
+	next_state.resize(record_size);
+
+	for (action_index = 0; action_index < task.nb_actions(); ++action_index)
+		all_actions.push_back(action_index);
+
+	// Initialization
+	task.encode(task.init(), next_state.data());
+	std::memcpy(&next_state[key_size], &no_action, sizeof(unsigned int));
+
+	layers.emplace_back(new segment_file(scratch.path()+"/layer_0.bin", record_size));
+	layers[0]->append(next_state.data(), 1);
+	closed.reset(new segment_file(scratch.path()+"/closed_0.bin", key_size));
+	closed->append(next_state.data(), 1);
+
+	layer_stats = {1, 0, record_size+key_size, 0, 0.0};
+	local_stats.layers.push_back(layer_stats);
+
+	found = init_goal = task.is_goal(next_state.data());
+	goal_state = next_state;
+
+	// Main loop, one iteration per layer
+	while (!found && layers[layer]->size() > 0)
+	{
+		layer_stats = {0, 0, 0, 0, 0.0};
+		records = layers[layer]->map();
+		layer_stats.bytes_read += layers[layer]->size()*record_size;
+
+		for (current = 0; current < layers[layer]->size() && !found; ++current)
+		{
+			candidates = &all_actions;
+			if (pruning && pruning->enabled())
+			{
+				kept = stubborn_actions(*pruning, records+current*record_size);
+				candidates = &kept;
+			}
+
+			for (unsigned int a : *candidates)
+			{
+				if (!task.apply(a, records+current*record_size, next_state.data()))
+					continue;
+
+				std::memcpy(&next_state[key_size], &a, sizeof(unsigned int));
+
+				if (task.is_goal(next_state.data()))
+				{
+					found = true;
+					goal_parent = current;
+					goal_state = next_state;
+					break;
+				}
+
+				buffer.insert(buffer.end(), next_state.begin(), next_state.end());
+
+				if (buffer.size() >= (std::size_t)buffer_size*record_size)
+				{
+					runs.emplace_back(new segment_file(scratch.path()+"/run_"
+									   +std::to_string(runs.size())+".bin",
+									   record_size));
+					spill_run(buffer, record_size, key_size, *runs.back(), layer_stats);
+				}
+			}
+		}
+
+		if (found)
+			break;
+
+		if (!buffer.empty())
+		{
+			runs.emplace_back(new segment_file(scratch.path()+"/run_"+std::to_string(runs.size())
+							   +".bin", record_size));
+			spill_run(buffer, record_size, key_size, *runs.back(), layer_stats);
+		}
+
+		// Delayed duplicate detection
+		start = std::chrono::steady_clock::now();
+
+		layers.emplace_back(new segment_file(scratch.path()+"/layer_"+std::to_string(layer+1)+".bin",
+						     record_size));
+		next_closed.reset(new segment_file(scratch.path()+"/closed_"+std::to_string(layer+1)+".bin",
+						   key_size));
+		merge_runs(runs, *closed, *layers.back(), *next_closed, key_size, layer_stats);
+
+		closed->remove();
+		closed = std::move(next_closed);
+
+		for (std::unique_ptr<segment_file> &run : runs)
+			run->remove();
+		runs.clear();
+
+		layers[layer]->unmap();
+
+		layer_stats.merge_time = std::chrono::duration<double>(std::chrono::steady_clock::now()-start).count();
+		layer_stats.states = layers.back()->size();
+		local_stats.layers.push_back(layer_stats);
+
+		layer++;
+	}
+
+	// Building the path backwards, looking for a predecessor of each state in the previous layer
+	if (found)
+	{
+		path_states.push_back(std::vector<unsigned char>(goal_state.begin(), goal_state.begin()+key_size));
+
+		// The initial state was not the goal
+		if (!init_goal)
+		{
+			std::memcpy(&action_index, &goal_state[key_size], sizeof(unsigned int));
+			path_actions.push_back(action_index);
+			records = layers[layer]->record(goal_parent);
+
+			while (true)
+			{
+				path_states.push_back(std::vector<unsigned char>(records, records+key_size));
+				std::memcpy(&action_index, records+key_size, sizeof(unsigned int));
+
+				if (action_index == no_action)
+					break;
+
+				path_actions.push_back(action_index);
+
+				for (current = 0; current < layers[layer-1]->size(); ++current)
+				{
+					if (task.apply(action_index, layers[layer-1]->record(current), next_state.data())
+					    && std::memcmp(next_state.data(), records, key_size) == 0)
+						break;
+				}
+
+				records = layers[layer-1]->record(current);
+				layer--;
+			}
+		}
+
+		while (!path_states.empty())
+		{
+			std::get<0>(p).push_back(task.to_state(task.decode(path_states.back().data())));
+			path_states.pop_back();
+		}
+
+		while (!path_actions.empty())
+		{
+			std::get<1>(p).push_back(task.get_action(path_actions.back()).name);
+			std::get<2>(p) += task.get_action(path_actions.back()).cost;
+			path_actions.pop_back();
+		}
+	}
+
+	if (stats)
+		*stats = local_stats;
+
+	return p;
+}
+
+path bitstate_search(const problem &prob, unsigned long long filter_bits, unsigned int nb_hashes,
+		     unsigned int max_depth, stubborn_sets *pruning, bitstate_statistics *stats)
+{
+	bool found, init_goal;
+	unsigned int key_size, action_index, goal_action = 0, depth = 0;
+	bitstate_statistics local_stats = {0, 0, 0, 0, 0, 0.0, 0.0, 0};
+
+	path p;
+	ground_task task(prob);
+	sas_encoding encoding(prob, task);
+	bloom_filter visited(filter_bits, nb_hashes);
+
+	/**
+	 * The stack of the search: the states along the current path, packed by the finite-domain
+	 * encoding, are stored one after the other in states (followed by room for a successor),
+	 * and for each of them the ground actions leading to its new successors, sorted by number
+	 * of unsatisfied goals of the successor, together with the position of the next one to try.
+	*/
+	std::vector<std::uint64_t> states;
+	std::vector<std::pair<std::vector<std::pair<unsigned int, unsigned int>>, unsigned int>> branches;
+
+	// The ground actions tried on a state, and the state encoded for the stubborn sets
+	std::vector<unsigned int> all_actions, kept;
+	std::vector<unsigned char> buffer;
+
+	// Fills the branches of the state at depth d, returns true if one of its successors is a goal
+	auto expand = [&](unsigned int d)
+		{
+			std::uint64_t *current = states.data()+d*key_size, *next = current+key_size;
+
+			const std::vector<unsigned int> *candidates = &all_actions;
+
+			local_stats.expansions++;
+
+			if (pruning && pruning->enabled())
+			{
+				pruning->task().encode(encoding.decode(current), buffer.data());
+				kept = stubborn_actions(*pruning, buffer.data());
+				candidates = &kept;
+			}
+
+			for (unsigned int a : *candidates)
+			{
+				if (!encoding.apply(a, current, next))
+					continue;
+
+				local_stats.generated++;
+
+				if (!visited.insert(reinterpret_cast<const unsigned char*>(next), key_size*sizeof(std::uint64_t)))
+				{
+					local_stats.revisited++;
+					continue;
+				}
+
+				if (encoding.is_goal(next))
+				{
+					goal_action = a;
+					return true;
+				}
+
+				branches[d].first.push_back({encoding.nb_unsatisfied_goals(next), a});
+			}
+
+			std::stable_sort(branches[d].first.begin(), branches[d].first.end());
+
+			return false;
+		};
+
+	key_size = encoding.nb_words();
+	states.resize(2*key_size);
+
+	for (unsigned int a = 0; a < task.nb_actions(); ++a)
+		all_actions.push_back(a);
+	if (pruning)
+		buffer.resize(pruning->task().state_bytes());
+
+	// Initialization
+	encoding.encode(task.init(), states.data());
+	visited.insert(reinterpret_cast<const unsigned char*>(states.data()), key_size*sizeof(std::uint64_t));
+	branches.push_back({{}, 0});
+
+	found = init_goal = encoding.is_goal(states.data());
+	if (!found && max_depth > 0)
+		found = expand(0);
+
+	// Main loop
+	while (!found)
+	{
+		// Backtracking
+		if (branches[depth].second == branches[depth].first.size())
+		{
+			if (depth == 0)
+				break;
+
+			branches.pop_back();
+			states.resize(states.size()-key_size);
+			depth--;
+			continue;
+		}
+
+		// Going one step deeper
+		action_index = branches[depth].first[branches[depth].second++].second;
+		encoding.apply(action_index, states.data()+depth*key_size, states.data()+(depth+1)*key_size);
+		branches.push_back({{}, 0});
+		states.resize(states.size()+key_size);
+		depth++;
+
+		if (depth < max_depth)
+			found = expand(depth);
+	}
+
+	// The states of the stack, then the goal generated from the deepest one
+	if (found)
+	{
+		std::get<0>(p).push_back(task.to_state(encoding.decode(states.data())));
+
+		for (unsigned int d = 1; d <= depth+1 && !init_goal; ++d)
+		{
+			if (d <= depth)
+				action_index = branches[d-1].first[branches[d-1].second-1].second;
+			else
+				action_index = goal_action;
+
+			std::get<0>(p).push_back(task.to_state(encoding.decode(states.data()+d*key_size)));
+			std::get<1>(p).push_back(task.get_action(action_index).name);
+			std::get<2>(p) += task.get_action(action_index).cost;
+		}
+	}
+
+	local_stats.visited = visited.nb_inserted();
+	local_stats.filter_bits = visited.nb_bits();
+	local_stats.fill_ratio = visited.fill_ratio();
+	local_stats.false_positive_rate = visited.false_positive_rate();
+	local_stats.state_bits = encoding.nb_bits();
+
+	if (stats)
+		*stats = local_stats;
+
+	return p;
+}
+
+path beam_search(const problem &prob, heuristic h, unsigned int width, unsigned int power,
+		 bool diversity, stubborn_sets *pruning, beam_statistics *stats)
+{
+	pool_scope memory(stats ? &stats->memory : nullptr);
+	int found = -1;
+	unsigned int i, layer_begin, layer_end, heur;
+	beam_statistics local_stats = {0, 0, std::vector<unsigned int>(), false, pool_statistics()};
+
+	const state &final_state = prob.final_state();
+	std::vector<std::tuple<state, unsigned int, unsigned int, std::vector<symbol>>> nodes;
+	std::unordered_set<state, state_hasher> visited;
+
+	/**
+	 * Candidates of the next layer. The items in a tuple correspond to:
+	 *	- the heuristic value of the state,
+	 *	- the number of candidates with the same heuristic value generated before it from the
+	 *	  same predecessor (0 when diversity is off),
+	 *	- the index of the candidate,
+	 * so that sorting the tuples gives the selection order.
+	*/
+	std::vector<std::tuple<unsigned int, unsigned int, unsigned int>> order;
+	std::vector<std::tuple<state, unsigned int, unsigned int, std::vector<symbol>>> candidates;
+	std::unordered_map<unsigned int, unsigned int> same_heur;
+
+	// Initialization
+	nodes.push_back({prob.init_state(), 0, 0, std::vector<symbol>()});
+	visited.insert(std::get<0>(nodes.back()));
+
+	if (final_state.included(std::get<0>(nodes.back())))
+		found = 0;
+
+	layer_begin = 0;
+	layer_end = nodes.size();
+
+	// Main loop, one iteration per layer
+	while (found < 0 && layer_begin < layer_end)
+	{
+		for (unsigned int current = layer_begin; current < layer_end && found < 0; ++current)
+		{
+			local_stats.expansions++;
+			same_heur.clear();
+
+			for (successor &succ : successors(prob, std::get<0>(nodes[current]), pruning))
+			{
+				local_stats.generated++;
+
+				if (visited.find(std::get<0>(succ)) != visited.end())
+					continue;
+
+				if (final_state.included(std::get<0>(succ)))
+				{
+					found = nodes.size();
+					nodes.push_back({std::move(std::get<0>(succ)), current,
+							 saturated_sum(std::get<2>(nodes[current]), std::get<2>(succ)),
+							 std::move(std::get<1>(succ))});
+					break;
+				}
+
+				heur = h(prob, std::get<0>(succ), power);
+
+				// A dead end would only take the slot of a state which may lead to the goal
+				if (heur == UINT_MAX)
+					continue;
+
+				candidates.push_back({std::move(std::get<0>(succ)), current,
+						      saturated_sum(std::get<2>(nodes[current]), std::get<2>(succ)),
+						      std::move(std::get<1>(succ))});
+				order.push_back({heur, 0, candidates.size()-1});
+
+				if (diversity)
+					std::get<1>(order.back()) = same_heur[std::get<0>(order.back())]++;
+			}
+		}
+
+		if (found >= 0)
+			break;
+
+		// Selection of the best states
+		std::sort(order.begin(), order.end());
+
+		layer_begin = nodes.size();
+
+		// The same state may have been generated from several predecessors of the layer
+		for (i = 0; i < order.size() && nodes.size()-layer_begin < width; ++i)
+		{
+			if (visited.insert(std::get<0>(candidates[std::get<2>(order[i])])).second)
+				nodes.push_back(candidates[std::get<2>(order[i])]);
+		}
+
+		layer_end = nodes.size();
+		local_stats.pruned.push_back(0);
+
+		for (; i < order.size(); ++i)
+		{
+			if (visited.find(std::get<0>(candidates[std::get<2>(order[i])])) == visited.end())
+				local_stats.pruned.back()++;
+		}
+
+		order.clear();
+		candidates.clear();
+	}
+
+	for (unsigned int pruned : local_stats.pruned)
+		local_stats.incomplete |= (found < 0 && pruned > 0);
+
+	if (stats)
+		*stats = local_stats;
+
+	if (found >= 0)
+		return extract_path(nodes, found);
+
+	return path();
+}
+
+/**
+ * @return The path obtained by applying a sequence of ground actions from the initial state.
+*/
+static path replay_plan(const ground_task &task, const std::vector<unsigned int> &plan)
+{
+	path p;
+	std::vector<unsigned char> current(task.state_bytes());
+
+	task.encode(task.init(), current.data());
+	std::get<0>(p).push_back(task.to_state(task.init()));
+
+	for (unsigned int a : plan)
+	{
+		task.apply(a, current.data(), current.data());
+		std::get<0>(p).push_back(task.to_state(task.decode(current.data())));
+		std::get<1>(p).push_back(task.get_action(a).name);
+		std::get<2>(p) += task.get_action(a).cost;
+	}
+
+	return p;
+}
+
+/**
+ * @return The ground actions leading to the node goal of a search over encoded states, given
+ *	   the predecessor and the generating action of each node (the root is at index 0).
+*/
+static std::vector<unsigned int> node_plan(const std::vector<unsigned int> &parents,
+					   const std::vector<unsigned int> &actions, unsigned int goal)
+{
+	std::vector<unsigned int> to_return;
+
+	for (unsigned int node = goal; node != 0; node = parents[node])
+		to_return.push_back(actions[node]);
+
+	std::reverse(to_return.begin(), to_return.end());
+
+	return to_return;
+}
+
+/**
+ * Symbolic representation of a ground task: fact f is the variable 2f in the current states
+ * and 2f+1 in the next states.
+*/
+struct symbolic_task
+{
+	bdd_manager manager;
+
+	/**
+	 * Transition relation of the ground actions of each cost, split into disjunctive
+	 * partitions of at most max_partition_nodes nodes (the image through the relation is the
+	 * union of the images through its partitions).
+	*/
+	static const unsigned int max_partition_nodes = 10000;
+	std::map<unsigned int, std::vector<bdd>> relations;
+
+	bdd current_vars;
+	bdd next_vars;
+	unsigned int to_next;
+	unsigned int to_current;
+
+	symbolic_task(const ground_task &task): manager(2*task.nb_facts())
+	{
+		unsigned int f;
+		std::vector<unsigned int> even, odd, mapping_next(2*task.nb_facts()), mapping_current(2*task.nb_facts());
+
+		for (f = 0; f < task.nb_facts(); ++f)
+		{
+			even.push_back(2*f);
+			odd.push_back(2*f+1);
+			mapping_next[2*f] = mapping_current[2*f] = 2*f+1;
+			mapping_next[2*f+1] = mapping_current[2*f+1] = 2*f;
+		}
+
+		current_vars = bdd::cube(manager, even);
+		next_vars = bdd::cube(manager, odd);
+		to_next = manager.add_renaming(mapping_next);
+		to_current = manager.add_renaming(mapping_current);
+
+		for (unsigned int a = 0; a < task.nb_actions(); ++a)
+		{
+			bdd r = relation(task.get_action(a), task.nb_facts());
+			std::vector<bdd> &partitions = relations[task.get_action(a).cost];
+
+			if (!partitions.empty() && (partitions.back() | r).node_count() <= max_partition_nodes)
+				partitions.back() |= r;
+			else
+				partitions.push_back(r);
+		}
+	}
+
+	// The set of the states satisfying a conjunction of literals
+	bdd conjunction(const std::vector<unsigned int> &pos, const std::vector<unsigned int> &neg)
+	{
+		bdd to_return = bdd::constant(manager, true);
+
+		for (unsigned int f : pos)
+			to_return &= bdd::literal(manager, 2*f);
+		for (unsigned int f : neg)
+			to_return &= bdd::literal(manager, 2*f, false);
+
+		return to_return;
+	}
+
+	// The set containing only the state encoded in buffer
+	bdd single(const ground_task &task, const unsigned char *buffer)
+	{
+		bdd to_return = bdd::constant(manager, true);
+		std::vector<bool> value(task.nb_facts(), false);
+
+		for (unsigned int f : task.decode(buffer))
+			value[f] = true;
+
+		// From the bottom variable up, so that the intermediate diagrams stay small
+		for (unsigned int f = task.nb_facts(); f > 0; --f)
+			to_return = bdd::literal(manager, 2*(f-1), value[f-1]) & to_return;
+
+		return to_return;
+	}
+
+	/**
+	 * The relation between the current and next states of a ground action. The next value of a
+	 * fact is given by the last effect writing it (the deletions are applied before the
+	 * additions, and the conditional effects after the unconditional ones), the facts which are
+	 * not written keep their value.
+	*/
+	bdd relation(const ground_action &a, unsigned int nb_facts)
+	{
+		unsigned int f;
+		bdd to_return = bdd::constant(manager, true), value, condition;
+		std::vector<std::vector<std::pair<bdd, bool>>> writes(nb_facts);
+
+		for (unsigned int d : a.del)
+			writes[d].push_back({bdd::constant(manager, true), false});
+		for (unsigned int d : a.add)
+			writes[d].push_back({bdd::constant(manager, true), true});
+
+		for (const auto &effect : a.cond_effects)
+		{
+			condition = conjunction(std::get<0>(effect), std::get<1>(effect));
+
+			for (unsigned int d : std::get<3>(effect))
+				writes[d].push_back({condition, false});
+			for (unsigned int d : std::get<2>(effect))
+				writes[d].push_back({condition, true});
+		}
+
+		for (f = nb_facts; f > 0; --f)
+		{
+			value = bdd::literal(manager, 2*(f-1));
+
+			for (const std::pair<bdd, bool> &w : writes[f-1])
+				value = w.second ? (w.first | value) : (~w.first & value);
+
+			to_return &= ~(bdd::literal(manager, 2*(f-1)+1) ^ value);
+		}
+
+		return to_return & conjunction(a.pre_pos, a.pre_neg);
+	}
+
+	// The successors of the states of s through the actions of a cost
+	bdd image(const bdd &s, unsigned int cost)
+	{
+		bdd to_return = bdd::constant(manager, false);
+
+		for (const bdd &partition : relations[cost])
+			to_return |= s.and_exists(partition, current_vars);
+
+		return to_return.rename(to_current);
+	}
+
+	// The predecessors of the states of s through the actions of a cost
+	bdd preimage(const bdd &s, unsigned int cost)
+	{
+		bdd to_return = bdd::constant(manager, false), next_states = s.rename(to_next);
+
+		for (const bdd &partition : relations[cost])
+			to_return |= next_states.and_exists(partition, next_vars);
+
+		return to_return;
+	}
+};
+
+/**
+ * Picks a state of a non-empty set of states and encodes it in buffer.
+*/
+static void pick_state(const ground_task &task, const bdd &states, unsigned char *buffer)
+{
+	std::vector<bool> assignment = states.pick_one();
+	std::vector<unsigned int> facts;
+
+	for (unsigned int f = 0; f < task.nb_facts(); ++f)
+	{
+		if (assignment[2*f])
+			facts.push_back(f);
+	}
+
+	task.encode(facts, buffer);
+}
+
+path symbolic_search(const problem &prob, symbolic_statistics *stats)
+{
+	bool forward, linked;
+	int concrete;
+	unsigned int g, cost = 0, best = UINT_MAX, meeting_forward = 0, meeting_backward = 0;
+	symbolic_statistics local_stats = {0, 0, 0, 0, 0, 0};
+
+	ground_task task(prob);
+	symbolic_task sym(task);
+	bdd expanded_states, meeting;
+	std::vector<unsigned char> current(task.state_bytes()), next(task.state_bytes());
+	std::vector<unsigned int> plan, backward_plan;
+
+	/**
+	 * States reached in each direction, indexed by their cost from the initial state (forward)
+	 * or to the goal (backward). A layer is replaced by its new states when it is expanded.
+	*/
+	std::map<unsigned int, bdd> layers[2];
+	std::set<unsigned int> open[2];
+	bdd closed[2];
+
+	for (unsigned int a = 0; a < task.nb_actions(); ++a)
+		assert(("Symbolic search requires positive action costs.", task.get_action(a).cost > 0));
+
+	for (const std::pair<const unsigned int, std::vector<bdd>> &r : sym.relations)
+	{
+		local_stats.relations += r.second.size();
+		for (const bdd &partition : r.second)
+			local_stats.relation_nodes += partition.node_count();
+	}
+
+	// Initialization
+	task.encode(task.init(), current.data());
+	layers[0][0] = sym.single(task, current.data());
+	layers[1][0] = sym.conjunction(task.goal(), std::vector<unsigned int>());
+	closed[0] = closed[1] = bdd::constant(sym.manager, false);
+	open[0].insert(0);
+	open[1].insert(0);
+
+	// Main loop, one layer expanded per iteration
+	while (!open[0].empty() && !open[1].empty())
+	{
+		// No path cheaper than the best meeting remains
+		if (best != UINT_MAX && best <= *open[0].begin()+*open[1].begin())
+			break;
+
+		forward = layers[0][*open[0].begin()].node_count() <= layers[1][*open[1].begin()].node_count();
+		std::map<unsigned int, bdd> &reached = layers[forward ? 0 : 1], &other = layers[forward ? 1 : 0];
+
+		g = *open[forward ? 0 : 1].begin();
+		open[forward ? 0 : 1].erase(open[forward ? 0 : 1].begin());
+
+		expanded_states = reached[g]-closed[forward ? 0 : 1];
+		reached[g] = expanded_states;
+		if (expanded_states.is_zero())
+			continue;
+
+		closed[forward ? 0 : 1] |= expanded_states;
+		(forward ? local_stats.forward_expansions : local_stats.backward_expansions)++;
+
+		// Meeting the states reached by the other direction
+		for (const std::pair<const unsigned int, bdd> &layer : other)
+		{
+			if (g+layer.first >= best)
+				break;
+
+			if (!(expanded_states & layer.second).is_zero())
+			{
+				best = g+layer.first;
+				meeting = expanded_states & layer.second;
+				meeting_forward = forward ? g : layer.first;
+				meeting_backward = forward ? layer.first : g;
+			}
+		}
+
+		for (const std::pair<const unsigned int, std::vector<bdd>> &r : sym.relations)
+		{
+			bdd new_states = (forward ? sym.image(expanded_states, r.first) : sym.preimage(expanded_states, r.first))
+					 -closed[forward ? 0 : 1];
+
+			if (new_states.is_zero())
+				continue;
+
+			if (reached.find(g+r.first) == reached.end())
+				reached[g+r.first] = new_states;
+			else
+				reached[g+r.first] |= new_states;
+
+			open[forward ? 0 : 1].insert(g+r.first);
+		}
+	}
+
+	local_stats.peak_nodes = sym.manager.peak_nodes();
+	local_stats.gc_runs = sym.manager.gc_runs();
+
+	if (stats)
+		*stats = local_stats;
+
+	if (best == UINT_MAX)
+		return path();
+
+	/**
+	 * From a meeting state, the forward layers are followed back to the initial state and the
+	 * backward layers forward to the goal. At each step, a state of a cheaper layer connected to
+	 * the current state by an action of the right cost is picked, and the concrete action is
+	 * found among the ground actions.
+	*/
+	pick_state(task, meeting, current.data());
+	std::vector<unsigned char> middle = current;
+
+	for (g = meeting_forward; g > 0; g -= cost)
+	{
+		linked = false;
+		for (const std::pair<const unsigned int, std::vector<bdd>> &r : sym.relations)
+		{
+			if (r.first > g || layers[0].find(g-r.first) == layers[0].end())
+				continue;
+
+			bdd predecessors = sym.preimage(sym.single(task, current.data()), r.first) & layers[0][g-r.first];
+			if (predecessors.is_zero())
+				continue;
+
+			cost = r.first;
+			pick_state(task, predecessors, next.data());
+			linked = true;
+			break;
+		}
+
+		assert(("No predecessor of the state in the forward layers.", linked));
+
+		concrete = -1;
+		for (unsigned int a = 0; a < task.nb_actions() && concrete < 0; ++a)
+		{
+			std::vector<unsigned char> result(task.state_bytes());
+
+			if (task.get_action(a).cost == cost && task.apply(a, next.data(), result.data())
+			    && result == current)
+				concrete = a;
+		}
+
+		assert(("No ground action between the states of two layers.", concrete >= 0));
+		plan.push_back(concrete);
+
+		current = next;
+	}
+
+	std::reverse(plan.begin(), plan.end());
+	current = middle;
+
+	for (g = meeting_backward; g > 0; g -= cost)
+	{
+		linked = false;
+		for (const std::pair<const unsigned int, std::vector<bdd>> &r : sym.relations)
+		{
+			if (r.first > g || layers[1].find(g-r.first) == layers[1].end())
+				continue;
+
+			bdd successors = sym.image(sym.single(task, current.data()), r.first) & layers[1][g-r.first];
+			if (successors.is_zero())
+				continue;
+
+			cost = r.first;
+			pick_state(task, successors, next.data());
+			linked = true;
+			break;
+		}
+
+		assert(("No successor of the state in the backward layers.", linked));
+
+		concrete = -1;
+		for (unsigned int a = 0; a < task.nb_actions() && concrete < 0; ++a)
+		{
+			std::vector<unsigned char> result(task.state_bytes());
+
+			if (task.get_action(a).cost == cost && task.apply(a, current.data(), result.data())
+			    && result == next)
+				concrete = a;
+		}
+
+		assert(("No ground action between the states of two layers.", concrete >= 0));
+		plan.push_back(concrete);
+
+		current = next;
+	}
+
+	return replay_plan(task, plan);
+}
+
+/**
+ * Incremental forall-step CNF encoding of a ground task, see sat_planning().
+*/
+struct sat_encoding
+{
+	const ground_task &task;
+	sat_solver solver;
+	unsigned int nb_clauses;
+
+	// Variables of the facts at each time point and of the actions at each step
+	std::vector<std::vector<unsigned int>> facts;
+	std::vector<std::vector<unsigned int>> actions;
+
+	/**
+	 * Writes of each ground action on each fact, in the order they are applied (see
+	 * ground_task::apply()). The items in a tuple correspond to:
+	 *	- the fact,
+	 *	- the index of the conditional effect doing the write, or -1 for the unconditional
+	 *	  effects,
+	 *	- the value written.
+	*/
+	std::vector<std::vector<std::tuple<unsigned int, int, bool>>> writes;
+
+	// Pairs of interfering actions, and the writers of each fact with the value written
+	std::vector<std::pair<unsigned int, unsigned int>> mutexes;
+	std::vector<std::vector<std::pair<unsigned int, int>>> adders;
+	std::vector<std::vector<std::pair<unsigned int, int>>> deleters;
+
+	sat_encoding(const ground_task &t): task(t), nb_clauses(0)
+	{
+		unsigned int a, f;
+
+		writes.resize(task.nb_actions());
+		adders.resize(task.nb_facts());
+		deleters.resize(task.nb_facts());
+
+		// Actions changing each fact, and requiring each fact to be true or false
+		std::vector<std::vector<unsigned int>> changers_true(task.nb_facts()), changers_false(task.nb_facts());
+		std::vector<std::vector<unsigned int>> requirers_true(task.nb_facts()), requirers_false(task.nb_facts());
+
+		for (a = 0; a < task.nb_actions(); ++a)
+		{
+			const ground_action &act = task.get_action(a);
+
+			for (unsigned int d : act.del)
+				writes[a].push_back({d, -1, false});
+			for (unsigned int d : act.add)
+				writes[a].push_back({d, -1, true});
+
+			for (unsigned int e = 0; e < act.cond_effects.size(); ++e)
+			{
+				for (unsigned int d : std::get<3>(act.cond_effects[e]))
+					writes[a].push_back({d, e, false});
+				for (unsigned int d : std::get<2>(act.cond_effects[e]))
+					writes[a].push_back({d, e, true});
+
+				// The conditions are required in both values, so that no other action of the step changes them
+				for (unsigned int c : std::get<0>(act.cond_effects[e]))
+				{
+					requirers_true[c].push_back(a);
+					requirers_false[c].push_back(a);
+				}
+				for (unsigned int c : std::get<1>(act.cond_effects[e]))
+				{
+					requirers_true[c].push_back(a);
+					requirers_false[c].push_back(a);
+				}
+			}
+
+			for (unsigned int p : act.pre_pos)
+				requirers_true[p].push_back(a);
+			for (unsigned int p : act.pre_neg)
+				requirers_false[p].push_back(a);
+
+			for (const std::tuple<unsigned int, int, bool> &w : writes[a])
+			{
+				(std::get<2>(w) ? adders : deleters)[std::get<0>(w)].push_back({a, std::get<1>(w)});
+				(std::get<2>(w) ? changers_true : changers_false)[std::get<0>(w)].push_back(a);
+			}
+		}
+
+		/**
+		 * Two actions interfere if one of them makes a fact false (resp. true) which the other
+		 * requires to be true (resp. false), or if they write different values in a fact.
+		*/
+		for (f = 0; f < task.nb_facts(); ++f)
+		{
+			for (unsigned int a1 : changers_false[f])
+			{
+				for (unsigned int a2 : requirers_true[f])
+					mutexes.push_back({std::min(a1, a2), std::max(a1, a2)});
+				for (unsigned int a2 : changers_true[f])
+					mutexes.push_back({std::min(a1, a2), std::max(a1, a2)});
+			}
+
+			for (unsigned int a1 : changers_true[f])
+			{
+				for (unsigned int a2 : requirers_false[f])
+					mutexes.push_back({std::min(a1, a2), std::max(a1, a2)});
+			}
+		}
+
+		std::sort(mutexes.begin(), mutexes.end());
+		mutexes.erase(std::unique(mutexes.begin(), mutexes.end()), mutexes.end());
+
+		// The initial state
+		facts.push_back(std::vector<unsigned int>());
+		for (f = 0; f < task.nb_facts(); ++f)
+			facts[0].push_back(solver.new_var());
+
+		for (f = 0; f < task.nb_facts(); ++f)
+			add({sat_solver::literal(facts[0][f], std::binary_search(task.init().begin(), task.init().end(), f))});
+	}
+
+	void add(const std::vector<unsigned int> &clause)
+	{
+		solver.add_clause(clause);
+		nb_clauses++;
+	}
+
+	unsigned int literal(unsigned int v, bool positive = true) const { return sat_solver::literal(v, positive); }
+
+	// Adds the variables and clauses of the step from facts.size()-1 to facts.size()
+	void add_step(void)
+	{
+		unsigned int a, f, t = actions.size();
+		std::vector<unsigned int> clause;
+
+		// Variables of the conditional effects of each action, which hold when the action and its conditions hold
+		std::vector<std::vector<unsigned int>> effects(task.nb_actions());
+
+		actions.push_back(std::vector<unsigned int>());
+		facts.push_back(std::vector<unsigned int>());
+
+		for (a = 0; a < task.nb_actions(); ++a)
+			actions[t].push_back(solver.new_var());
+		for (f = 0; f < task.nb_facts(); ++f)
+			facts[t+1].push_back(solver.new_var());
+
+		for (a = 0; a < task.nb_actions(); ++a)
+		{
+			const ground_action &act = task.get_action(a);
+
+			// Pre-conditions
+			for (unsigned int p : act.pre_pos)
+				add({literal(actions[t][a], false), literal(facts[t][p])});
+			for (unsigned int p : act.pre_neg)
+				add({literal(actions[t][a], false), literal(facts[t][p], false)});
+
+			for (const auto &effect : act.cond_effects)
+			{
+				effects[a].push_back(solver.new_var());
+
+				clause = {literal(effects[a].back()), literal(actions[t][a], false)};
+				add({literal(effects[a].back(), false), literal(actions[t][a])});
+
+				for (unsigned int c : std::get<0>(effect))
+				{
+					clause.push_back(literal(facts[t][c], false));
+					add({literal(effects[a].back(), false), literal(facts[t][c])});
+				}
+				for (unsigned int c : std::get<1>(effect))
+				{
+					clause.push_back(literal(facts[t][c]));
+					add({literal(effects[a].back(), false), literal(facts[t][c], false)});
+				}
+
+				add(clause);
+			}
+
+			/**
+			 * Effects: a write sets its value unless a later write of the other value on the same
+			 * fact fires too.
+			*/
+			for (unsigned int i = 0; i < writes[a].size(); ++i)
+			{
+				f = std::get<0>(writes[a][i]);
+				clause = {write_literal(t, a, std::get<1>(writes[a][i]), effects, false),
+					  literal(facts[t+1][f], std::get<2>(writes[a][i]))};
+
+				for (unsigned int j = i+1; j < writes[a].size(); ++j)
+				{
+					if (std::get<0>(writes[a][j]) == f && std::get<2>(writes[a][j]) != std::get<2>(writes[a][i]))
+						clause.push_back(write_literal(t, a, std::get<1>(writes[a][j]), effects, true));
+				}
+
+				add(clause);
+			}
+		}
+
+		// Explanatory frame axioms
+		for (f = 0; f < task.nb_facts(); ++f)
+		{
+			clause = {literal(facts[t][f], false), literal(facts[t+1][f])};
+			for (const std::pair<unsigned int, int> &w : deleters[f])
+				clause.push_back(write_literal(t, w.first, w.second, effects, true));
+			add(clause);
+
+			clause = {literal(facts[t][f]), literal(facts[t+1][f], false)};
+			for (const std::pair<unsigned int, int> &w : adders[f])
+				clause.push_back(write_literal(t, w.first, w.second, effects, true));
+			add(clause);
+		}
+
+		// Mutexes
+		for (const std::pair<unsigned int, unsigned int> &m : mutexes)
+		{
+			if (m.first != m.second)
+				add({literal(actions[t][m.first], false), literal(actions[t][m.second], false)});
+		}
+	}
+
+	// Literal of the variable firing a write (the action itself or its conditional effect)
+	unsigned int write_literal(unsigned int t, unsigned int a, int effect,
+				   const std::vector<std::vector<unsigned int>> &effects, bool positive) const
+	{
+		return literal(effect < 0 ? actions[t][a] : effects[a][effect], positive);
+	}
+};
+
+path sat_planning(const problem &prob, unsigned int max_horizon, double growth, sat_statistics *stats)
+{
+	bool found;
+	unsigned int horizon = 1, goal_var;
+	sat_statistics local_stats = {0, 0, 0, 0, 0, 0, 0};
+
+	ground_task task(prob);
+	sat_encoding encoding(task);
+	std::vector<unsigned int> plan;
+	std::vector<unsigned char> init(task.state_bytes());
+
+	task.encode(task.init(), init.data());
+	found = task.is_goal(init.data());
+
+	while (!found && horizon <= max_horizon)
+	{
+		while (encoding.actions.size() < horizon)
+			encoding.add_step();
+
+		// The goal of this horizon only holds under the assumption goal_var
+		goal_var = encoding.solver.new_var();
+		for (unsigned int f : task.goal())
+			encoding.add({sat_solver::literal(goal_var, false), sat_solver::literal(encoding.facts[horizon][f])});
+
+		local_stats.horizons++;
+		local_stats.horizon = horizon;
+		found = encoding.solver.solve({sat_solver::literal(goal_var)});
+
+		if (!found)
+			horizon = std::max(horizon+1, (unsigned int)(horizon*growth));
+	}
+
+	// The actions of a step are applied in the order of their indexes
+	if (found)
+	{
+		for (unsigned int t = 0; t < encoding.actions.size() && local_stats.horizons > 0; ++t)
+		{
+			if (t >= local_stats.horizon)
+				break;
+
+			for (unsigned int a = 0; a < task.nb_actions(); ++a)
+			{
+				if (encoding.solver.model_value(encoding.actions[t][a]))
+					plan.push_back(a);
+			}
+		}
+	}
+
+	local_stats.variables = encoding.solver.nb_vars();
+	local_stats.clauses = encoding.nb_clauses;
+	local_stats.conflicts = encoding.solver.conflicts();
+	local_stats.decisions = encoding.solver.decisions();
+	local_stats.learned = encoding.solver.nb_learned();
+
+	if (stats)
+		*stats = local_stats;
+
+	if (found)
+		return replay_plan(task, plan);
+
+	return path();
+}
+
+/**
+ * Supports the goals of a fact layer from the goal index, with nodes of the previous action
+ * layer which are not mutex with the nodes of chosen, then extracts the plan of their
+ * pre-conditions (see graphplan_extract()).
+*/
+static bool graphplan_support(const planning_graph &graph, unsigned int layer,
+	const std::vector<unsigned int> &goals, unsigned int goal, std::vector<unsigned int> &chosen,
+	std::vector<std::set<std::vector<unsigned int>>> &nogoods, std::vector<std::vector<unsigned int>> &steps,
+	graphplan_statistics &stats);
+
+/**
+ * Extracts a plan reaching the goals (sorted literals, without mutex pair) of a fact layer.
+ * The actions of the step from the layer k to k+1 are stored in steps[k].
+ * @return False if the goals cannot be reached, the goal set is then memoized in nogoods.
+*/
+static bool graphplan_extract(const planning_graph &graph, unsigned int layer,
+	const std::vector<unsigned int> &goals, std::vector<std::set<std::vector<unsigned int>>> &nogoods,
+	std::vector<std::vector<unsigned int>> &steps, graphplan_statistics &stats)
+{
+	std::vector<unsigned int> chosen;
+
+	// The goals are in the fact layer 0, which is the initial state
+	if (layer == 0)
+		return true;
+
+	if (nogoods[layer].count(goals))
+		return false;
+
+	stats.extractions++;
+
+	if (graphplan_support(graph, layer, goals, 0, chosen, nogoods, steps, stats))
+		return true;
+
+	nogoods[layer].insert(goals);
+	stats.nogoods++;
+
+	return false;
+}
+
+static bool graphplan_support(const planning_graph &graph, unsigned int layer,
+	const std::vector<unsigned int> &goals, unsigned int goal, std::vector<unsigned int> &chosen,
+	std::vector<std::set<std::vector<unsigned int>>> &nogoods, std::vector<std::vector<unsigned int>> &steps,
+	graphplan_statistics &stats)
+{
+	std::vector<unsigned int> subgoals, candidates;
+
+	if (goal == goals.size())
+	{
+		for (unsigned int n : chosen)
+			subgoals.insert(subgoals.end(), graph.preconditions(n).begin(), graph.preconditions(n).end());
+
+		std::sort(subgoals.begin(), subgoals.end());
+		subgoals.erase(std::unique(subgoals.begin(), subgoals.end()), subgoals.end());
+
+		if (!graphplan_extract(graph, layer-1, subgoals, nogoods, steps, stats))
+			return false;
+
+		steps[layer-1].clear();
+		for (unsigned int n : chosen)
+		{
+			if (!graph.is_noop(n))
+				steps[layer-1].push_back(n);
+		}
+
+		return true;
+	}
+
+	// The goal is already produced by a chosen node
+	for (unsigned int n : chosen)
+	{
+		if (std::binary_search(graph.effects(n).begin(), graph.effects(n).end(), goals[goal]))
+			return graphplan_support(graph, layer, goals, goal+1, chosen, nogoods, steps, stats);
+	}
+
+	// The no-op is the last supporter
+	candidates.assign(graph.supporters(goals[goal]).rbegin(), graph.supporters(goals[goal]).rend());
+
+	for (unsigned int n : candidates)
+	{
+		if (!graph.actions(layer-1).test(n))
+			continue;
+
+		bool mutex = false;
+
+		for (unsigned int i = 0; i < chosen.size() && !mutex; ++i)
+			mutex = graph.actions_mutex(layer-1, n, chosen[i]);
+
+		if (mutex)
+			continue;
+
+		chosen.push_back(n);
+		if (graphplan_support(graph, layer, goals, goal+1, chosen, nogoods, steps, stats))
+			return true;
+		chosen.pop_back();
+	}
+
+	return false;
+}
+
+path graphplan(const problem &prob, graphplan_statistics *stats)
+{
+	bool found = false;
+	unsigned int layer;
+	std::size_t last_nogoods = SIZE_MAX;
+	graphplan_statistics local_stats = {0, UINT_MAX, 0, 0, 0};
+
+	ground_task task(prob);
+	planning_graph graph(task, task.init());
+	std::vector<unsigned int> plan;
+	std::vector<std::set<std::vector<unsigned int>>> nogoods(1);
+	std::vector<std::vector<unsigned int>> steps;
+
+	while (true)
+	{
+		layer = graph.nb_layers()-1;
+
+		if (graph.goal_level(task.goal()) <= layer)
+		{
+			steps.assign(layer, std::vector<unsigned int>());
+
+			if (graphplan_extract(graph, layer, task.goal(), nogoods, steps, local_stats))
+			{
+				found = true;
+				break;
+			}
+
+			// No new goal set failed in the level-off layer, no plan will ever be found
+			if (local_stats.level_off != UINT_MAX)
+			{
+				if (nogoods[local_stats.level_off].size() == last_nogoods)
+					break;
+
+				last_nogoods = nogoods[local_stats.level_off].size();
+			}
+		}
+		else if (graph.leveled_off())
+			break;
+
+		if (!graph.expand() && local_stats.level_off == UINT_MAX)
+			local_stats.level_off = layer;
+
+		nogoods.resize(graph.nb_layers());
+	}
+
+	// The actions of a step are not mutex, so they can be applied in any order
+	if (found)
+	{
+		for (const std::vector<unsigned int> &step : steps)
+			plan.insert(plan.end(), step.begin(), step.end());
+	}
+
+	local_stats.layers = graph.nb_layers();
+	local_stats.mutexes = graph.nb_mutexes(graph.nb_layers()-1);
+
+	if (stats)
+		*stats = local_stats;
+
+	if (found)
+		return replay_plan(task, plan);
+
+	return path();
+}
+
+path orbit_search(const problem &prob, heuristic h, unsigned int power, symmetry_statistics *stats)
+{
+	int found = -1;
+	int real_action;
+	unsigned int current, next, key_size, next_cost, priority;
+	std::pair<unsigned int, unsigned int> entry;
+	symmetry_statistics local_stats = {0, 0, 0, 0, 0, 0};
+
+	ground_task task(prob);
+	symmetry_group group(prob, task);
+	std::vector<unsigned int> plan, canonical_actions, to_canonical;
+	std::vector<unsigned char> generated;
+
+	// The canonical states are stored as in iw_search(), with their cost and heuristic value
+	std::vector<unsigned char> states;
+	std::vector<unsigned int> parents, actions, costs, heur_values;
+	std::unordered_map<std::string, unsigned int> node_indexes;
+	std::unordered_map<std::string, unsigned int>::iterator node_it;
+
+	// Waiting list of (node index, cost to reach the node when it was pushed)
+	bucket_queue<std::pair<unsigned int, unsigned int>> waiting_list;
+
+	key_size = task.state_bytes();
+	generated.resize(key_size);
+	states.resize(key_size);
+
+	local_stats.generators = group.nb_generators();
+	local_stats.automorphism_nodes = group.nb_nodes();
+
+	// Initialization
+	task.encode(task.init(), states.data());
+	group.canonicalize(states.data());
+	node_indexes.insert({std::string(states.begin(), states.end()), 0});
+	parents.push_back(0);
+	actions.push_back(0);
+	costs.push_back(0);
+	heur_values.push_back(h(prob, task.to_state(task.decode(states.data())), power));
+
+	// The dead ends are kept among the canonical states, but never pushed
+	if (heur_values.back() != UINT_MAX)
+		waiting_list.push({0, 0}, heur_values.back());
+
+	// Main loop
+	while (!waiting_list.empty() && found < 0)
+	{
+		entry = waiting_list.pop();
+		current = entry.first;
+
+		// A cheaper path to this node has been found since it was pushed
+		if (entry.second > costs[current])
+			continue;
+
+		if (task.is_goal(&states[current*key_size]))
+		{
+			found = current;
+			break;
+		}
+
+		local_stats.expansions++;
+
+		for (unsigned int a = 0; a < task.nb_actions(); ++a)
+		{
+			if (!task.apply(a, &states[current*key_size], generated.data()))
+				continue;
+
+			local_stats.generated++;
+
+			std::string key(generated.begin(), generated.end());
+			group.canonicalize(generated.data());
+			next_cost = saturated_sum(costs[current], task.get_action(a).cost);
+			node_it = node_indexes.find(std::string(generated.begin(), generated.end()));
+
+			if (node_it == node_indexes.end())
+			{
+				next = parents.size();
+				node_indexes.insert({std::string(generated.begin(), generated.end()), next});
+				states.insert(states.end(), generated.begin(), generated.end());
+				parents.push_back(current);
+				actions.push_back(a);
+				costs.push_back(next_cost);
+				heur_values.push_back(h(prob, task.to_state(task.decode(generated.data())), power));
+
+				priority = saturated_sum(next_cost, heur_values.back());
+				if (priority != UINT_MAX)
+					waiting_list.push({next, next_cost}, priority);
+				continue;
+			}
+
+			local_stats.duplicates++;
+			if (std::memcmp(key.data(), generated.data(), key_size) != 0)
+				local_stats.pruned++;
+
+			if (next_cost < costs[node_it->second])
+			{
+				parents[node_it->second] = current;
+				actions[node_it->second] = a;
+				costs[node_it->second] = next_cost;
+
+				priority = saturated_sum(next_cost, heur_values[node_it->second]);
+				if (priority != UINT_MAX)
+					waiting_list.push({node_it->second, next_cost}, priority);
+			}
+		}
+	}
+
+	if (stats)
+		*stats = local_stats;
+
+	if (found < 0)
+		return path();
+
+	/*
+	 * Mapping the plan back: if the real state r_i is mapped on the canonical state c_i by the
+	 * permutation t_i, the real action of step i+1 is the canonical action permuted by the
+	 * inverse of t_i, and t_{i+1} is t_i composed with the permutation canonicalizing the
+	 * successor of c_i.
+	*/
+	canonical_actions = node_plan(parents, actions, found);
+	to_canonical = group.identity();
+
+	task.encode(task.init(), generated.data());
+	group.canonicalize(generated.data(), &to_canonical);
+
+	for (unsigned int a : canonical_actions)
+	{
+		real_action = task.action_index(group.permute(task.get_action(a).name,
+							       symmetry_group::inverse(to_canonical)));
+		assert(("The permuted action should be in the ground task", real_action >= 0));
+		plan.push_back(real_action);
+
+		task.apply(a, generated.data(), generated.data());
+		group.canonicalize(generated.data(), &to_canonical);
+	}
+
+	return replay_plan(task, plan);
+}
+
+path iw_search(const problem &prob, unsigned int width, stubborn_sets *pruning, width_statistics *stats)
+{
+	int found = -1;
+	unsigned int current, key_size;
+	width_statistics local_stats = {0, 0, 0, 0};
+
+	ground_task task(prob);
+	novelty_table table(task.nb_facts(), width);
+	std::vector<unsigned int> all_actions, kept;
+	const std::vector<unsigned int> *candidates;
+
+	/**
+	 * Nodes of the search, which are also the FIFO waiting list: the encoded states are
+	 * stored one after the other in states, with the index of the predecessor and of the
+	 * ground action which generated each of them.
+	*/
+	std::vector<unsigned char> states;
+	std::vector<unsigned int> parents, actions;
+
+	key_size = task.state_bytes();
+	states.resize(2*key_size);
+
+	for (unsigned int a = 0; a < task.nb_actions(); ++a)
+		all_actions.push_back(a);
+
+	// Initialization
+	task.encode(task.init(), states.data());
+	table.insert(task.init());
+	parents.push_back(0);
+	actions.push_back(0);
+
+	if (task.is_goal(states.data()))
+		found = 0;
+
+	// Main loop
+	for (current = 0; current < parents.size() && found < 0; ++current)
+	{
+		local_stats.expansions++;
+
+		candidates = &all_actions;
+		if (pruning && pruning->enabled())
+		{
+			kept = stubborn_actions(*pruning, &states[current*key_size]);
+			candidates = &kept;
+		}
+
+		for (unsigned int a : *candidates)
+		{
+			// The successor is built at the end of states, the buffer grows when it is kept
+			if (!task.apply(a, &states[current*key_size], &states[parents.size()*key_size]))
+				continue;
+
+			local_stats.generated++;
+
+			if (task.is_goal(&states[parents.size()*key_size]))
+			{
+				found = parents.size();
+				parents.push_back(current);
+				actions.push_back(a);
+				break;
+			}
+
+			if (table.insert(task.decode(&states[parents.size()*key_size])) > width)
+			{
+				local_stats.pruned++;
+				continue;
+			}
+
+			parents.push_back(current);
+			actions.push_back(a);
+			states.resize(states.size()+key_size);
+		}
+	}
+
+	if (stats)
+		*stats = local_stats;
+
+	if (found >= 0)
+		return replay_plan(task, node_plan(parents, actions, found));
+
+	return path();
+}
+
+path bfws(const problem &prob, stubborn_sets *pruning, width_statistics *stats)
+{
+	int found = -1;
+	unsigned int current, key_size, nb_goals, novelty, goals_left;
+	width_statistics local_stats = {0, 0, 0, 0};
+
+	ground_task task(prob);
+	std::vector<unsigned int> facts, all_actions, kept;
+	const std::vector<unsigned int> *candidates;
+
+	// The nodes are stored as in iw_search()
+	std::vector<unsigned char> states;
+	std::vector<unsigned int> parents, actions;
+	std::unordered_set<std::string> closed;
+
+	/**
+	 * One novelty table for each number of unsatisfied goals, allocated when a state with this
+	 * number is first generated, since a table of width 2 takes a quadratic number of bits in
+	 * the number of facts.
+	*/
+	std::vector<std::unique_ptr<novelty_table>> tables;
+
+	auto table = [&](unsigned int goals) -> novelty_table&
+		{
+			if (!tables[goals])
+				tables[goals].reset(new novelty_table(task.nb_facts(), 2));
+			return *tables[goals];
+		};
+
+	// Waiting list ordered by novelty first, then by number of unsatisfied goals
+	bucket_queue<unsigned int> waiting_list;
+
+	key_size = task.state_bytes();
+	nb_goals = task.goal().size();
+	tables.resize(nb_goals+1);
+	states.resize(2*key_size);
+
+	for (unsigned int a = 0; a < task.nb_actions(); ++a)
+		all_actions.push_back(a);
+
+	// Initialization
+	task.encode(task.init(), states.data());
+	goals_left = task.nb_unsatisfied_goals(states.data());
+	novelty = table(goals_left).insert(task.init());
+	closed.insert(std::string(states.begin(), states.begin()+key_size));
+	parents.push_back(0);
+	actions.push_back(0);
+	waiting_list.push(0, (novelty-1)*(nb_goals+1)+goals_left);
+
+	if (task.is_goal(states.data()))
+		found = 0;
+
+	// Main loop
+	while (!waiting_list.empty() && found < 0)
+	{
+		current = waiting_list.pop();
+		local_stats.expansions++;
+
+		candidates = &all_actions;
+		if (pruning && pruning->enabled())
+		{
+			kept = stubborn_actions(*pruning, &states[current*key_size]);
+			candidates = &kept;
+		}
+
+		for (unsigned int a : *candidates)
+		{
+			if (!task.apply(a, &states[current*key_size], &states[parents.size()*key_size]))
+				continue;
+
+			local_stats.generated++;
+
+			if (!closed.insert(std::string(states.begin()+parents.size()*key_size,
+						       states.begin()+(parents.size()+1)*key_size)).second)
+			{
+				local_stats.duplicates++;
+				continue;
+			}
+
+			parents.push_back(current);
+			actions.push_back(a);
+
+			if (task.is_goal(&states[(parents.size()-1)*key_size]))
+			{
+				found = parents.size()-1;
+				break;
+			}
+
+			facts = task.decode(&states[(parents.size()-1)*key_size]);
+			goals_left = task.nb_unsatisfied_goals(&states[(parents.size()-1)*key_size]);
+			novelty = table(goals_left).insert(facts);
+			waiting_list.push(parents.size()-1, (novelty-1)*(nb_goals+1)+goals_left);
+			states.resize(states.size()+key_size);
+		}
+	}
+
+	if (stats)
+		*stats = local_stats;
+
+	if (found >= 0)
+		return replay_plan(task, node_plan(parents, actions, found));
+
+	return path();
+}
+
+/**
+ * Best endpoint of the random walks of a thread, with the counters of the thread.
+*/
+struct walk_result
+{
+	// Number of unsatisfied goals in the endpoint
+	unsigned int heur_value;
+
+	std::vector<unsigned char> endpoint;
+
+	// Ground actions leading from the start of the walk to the endpoint
+	std::vector<unsigned int> actions;
+
+	unsigned long long walks;
+	unsigned long long steps;
+	unsigned long long dead_ends;
+};
+
+/**
+ * Samples nb_walks random walks of at most length actions from start, stopping at the first
+ * walk reaching a goal state.
+*/
+static void random_walks(const ground_task &task, const std::vector<unsigned char> &start,
+			 unsigned int nb_walks, unsigned int length, std::mt19937 &generator,
+			 walk_result &result)
+{
+	bool dead_end;
+	unsigned int walk, step, nb_applicable, chosen = 0, heur_value;
+	std::vector<unsigned char> current(start.size());
+	std::vector<unsigned int> actions;
+
+	result = {UINT_MAX, start, std::vector<unsigned int>(), 0, 0, 0};
+	actions.reserve(length);
+
+	for (walk = 0; walk < nb_walks && result.heur_value > 0; ++walk)
+	{
+		std::memcpy(current.data(), start.data(), start.size());
+		actions.clear();
+		dead_end = false;
+
+		for (step = 0; step < length && !task.is_goal(current.data()); ++step)
+		{
+			// Reservoir sampling of an applicable action
+			nb_applicable = 0;
+			for (unsigned int a = 0; a < task.nb_actions(); ++a)
+			{
+				if (task.applicable(a, current.data()) && generator()%(++nb_applicable) == 0)
+					chosen = a;
+			}
+
+			if (nb_applicable == 0)
+			{
+				dead_end = true;
+				break;
+			}
+
+			task.apply(chosen, current.data(), current.data());
+			actions.push_back(chosen);
+		}
+
+		result.walks++;
+		result.steps += actions.size();
+
+		if (dead_end)
+		{
+			result.dead_ends++;
+			continue;
+		}
+
+		heur_value = task.nb_unsatisfied_goals(current.data());
+		if (heur_value < result.heur_value)
+		{
+			result.heur_value = heur_value;
+			result.endpoint = current;
+			result.actions = actions;
+		}
+	}
+}
+
+path random_walk_search(const problem &prob, unsigned int nb_threads, unsigned int nb_walks,
+			unsigned int walk_length, unsigned int max_episodes, unsigned int seed,
+			random_walk_statistics *stats)
+{
+	const unsigned int max_stalls = 4;
+	unsigned int episode, t, best, heur_value, length = walk_length, stalls = 0;
+	random_walk_statistics local_stats = {0, 0, 0, 0, 0, 0};
+
+	path p;
+	ground_task task(prob);
+	std::vector<unsigned char> init(task.state_bytes()), current;
+	std::vector<unsigned int> plan;
+	std::vector<walk_result> results;
+	std::vector<std::mt19937> generators;
+	std::vector<std::thread> threads;
+
+	nb_threads = std::max(nb_threads, 1u);
+	results.resize(nb_threads);
+
+	for (t = 0; t < nb_threads; ++t)
+	{
+		std::seed_seq sequence = {seed, t};
+		generators.emplace_back(sequence);
+	}
+
+	task.encode(task.init(), init.data());
+	current = init;
+	heur_value = task.nb_unsatisfied_goals(current.data());
+
+	for (episode = 0; episode < max_episodes && !task.is_goal(current.data()); ++episode)
+	{
+		local_stats.episodes++;
+
+		// The walks of an episode are split between the threads
+		for (t = 0; t < nb_threads; ++t)
+		{
+			threads.emplace_back(random_walks, std::cref(task), std::cref(current),
+					     nb_walks/nb_threads+(t < nb_walks%nb_threads), length,
+					     std::ref(generators[t]), std::ref(results[t]));
+		}
+
+		best = 0;
+		for (t = 0; t < nb_threads; ++t)
+		{
+			threads[t].join();
+
+			local_stats.walks += results[t].walks;
+			local_stats.steps += results[t].steps;
+			local_stats.dead_ends += results[t].dead_ends;
+
+			if (results[t].heur_value < results[best].heur_value)
+				best = t;
+		}
+		threads.clear();
+
+		if (results[best].heur_value < heur_value)
+		{
+			// Committing to the best endpoint
+			heur_value = results[best].heur_value;
+			current = results[best].endpoint;
+			plan.insert(plan.end(), results[best].actions.begin(), results[best].actions.end());
+			length = walk_length;
+			stalls = 0;
+			local_stats.commits++;
+		}
+		else if (++stalls < max_stalls)
+			length *= 2;
+		else
+		{
+			current = init;
+			heur_value = task.nb_unsatisfied_goals(current.data());
+			plan.clear();
+			length = walk_length;
+			stalls = 0;
+			local_stats.restarts++;
+		}
+	}
+
+	if (task.is_goal(current.data()))
+		p = replay_plan(task, plan);
+
+	if (stats)
+		*stats = local_stats;
+
+	return p;
+}
+
+real_time_search::real_time_search(const problem &prob, heuristic h, unsigned int power, stubborn_sets *pruning):
+	m_problem(prob), m_heuristic(h), m_power(power), m_pruning(pruning), m_final_state(prob.final_state())
+{
+}
+
+unsigned int real_time_search::value(const state &s)
+{
+	std::unordered_map<state, unsigned int, state_hasher>::iterator it = m_values.find(s);
+
+	if (it == m_values.end())
+		it = m_values.insert({s, m_heuristic(m_problem, s, m_power)}).first;
+
+	return it->second;
+}
+
+unsigned int real_time_search::learned_value(const state &s) { return value(s); }
+
+unsigned int real_time_search::nb_learned(void) const { return m_values.size(); }
+
+successor real_time_search::next_action(const state &current, unsigned long long budget,
+					real_time_statistics *stats)
+{
+	int target = -1;
+	bool interrupted = false;
+	unsigned int node, next_cost, priority, best_f = UINT_MAX;
+	std::pair<unsigned int, unsigned int> entry;
+	real_time_statistics local_stats = {0, 0, 0, false, false};
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+	/**
+	 * Nodes of the lookahead, the items in a tuple correspond to:
+	 *	- the state which is considered,
+	 *	- the index of its predecessor in nodes,
+	 *	- the cost to reach this state from current,
+	 *	- the action that leaded to this state.
+	*/
+	std::vector<std::tuple<state, unsigned int, unsigned int, std::vector<symbol>>> nodes;
+	std::vector<bool> expanded;
+	std::unordered_map<state, unsigned int, state_hasher> node_indexes;
+	std::unordered_map<state, unsigned int, state_hasher>::iterator node_it;
+
+	// Predecessors of each node in the lookahead, with the cost of the edge
+	std::vector<std::vector<std::pair<unsigned int, unsigned int>>> predecessors;
+
+	// Waiting list of (node index, cost to reach the node when it was pushed)
+	bucket_queue<std::pair<unsigned int, unsigned int>> waiting_list;
+	bucket_queue<unsigned int> frontier;
+
+	auto elapsed = [&start](void)
+		{
+			return (unsigned long long)std::chrono::duration_cast<std::chrono::microseconds>(
+				std::chrono::steady_clock::now()-start).count();
+		};
+
+	nodes.push_back({current, 0, 0, std::vector<symbol>()});
+	expanded.push_back(false);
+	predecessors.push_back({});
+	node_indexes.insert({current, 0});
+	if (value(current) != UINT_MAX)
+		waiting_list.push({0, 0}, value(current));
+
+	// Lookahead, half of the budget is left for the learning phase
+	while (!waiting_list.empty())
+	{
+		entry = waiting_list.pop();
+		node = entry.first;
+
+		if (entry.second > std::get<2>(nodes[node]) || expanded[node])
+			continue;
+
+		if (m_final_state.included(std::get<0>(nodes[node])))
+		{
+			local_stats.goal_seen = true;
+			target = node;
+			break;
+		}
+
+		if (local_stats.expansions > 0 && 2*elapsed() >= budget)
+			break;
+
+		expanded[node] = true;
+		local_stats.expansions++;
+
+		for (successor succ : successors(m_problem, std::get<0>(nodes[node]), m_pruning))
+		{
+			/**
+			 * Out of time while evaluating the successors: the node goes back to the frontier,
+			 * the successors already generated only give it more paths to the frontier. The
+			 * first expansion is always completed, the agent could not move otherwise.
+			*/
+			if (local_stats.expansions > 1 && 2*elapsed() >= budget)
+			{
+				expanded[node] = false;
+				local_stats.expansions--;
+				interrupted = true;
+				break;
+			}
+
+			next_cost = saturated_sum(std::get<2>(nodes[node]), std::get<2>(succ));
+			node_it = node_indexes.find(std::get<0>(succ));
+
+			if (node_it == node_indexes.end())
+			{
+				node_it = node_indexes.insert({std::get<0>(succ), nodes.size()}).first;
+				nodes.push_back({std::get<0>(succ), node, next_cost, std::get<1>(succ)});
+				expanded.push_back(false);
+				predecessors.push_back({});
+
+				// The dead ends are never expanded
+				priority = saturated_sum(next_cost, value(std::get<0>(succ)));
+				if (priority != UINT_MAX)
+					waiting_list.push({nodes.size()-1, next_cost}, priority);
+			}
+			else if (next_cost < std::get<2>(nodes[node_it->second]) && !expanded[node_it->second])
+			{
+				std::get<1>(nodes[node_it->second]) = node;
+				std::get<2>(nodes[node_it->second]) = next_cost;
+				std::get<3>(nodes[node_it->second]) = std::get<1>(succ);
+
+				priority = saturated_sum(next_cost, value(std::get<0>(succ)));
+				if (priority != UINT_MAX)
+					waiting_list.push({node_it->second, next_cost}, priority);
+			}
+
+			predecessors[node_it->second].push_back({node, std::get<2>(succ)});
+		}
+
+		if (interrupted)
+			break;
+	}
+
+	if (target < 0)
+	{
+		// The best state of the frontier (the state is a dead end if there is none)
+		for (node = 0; node < nodes.size(); ++node)
+		{
+			priority = saturated_sum(std::get<2>(nodes[node]), value(std::get<0>(nodes[node])));
+
+			if (!expanded[node] && priority < best_f)
+			{
+				best_f = priority;
+				target = node;
+			}
+		}
+
+		/**
+		 * Learning phase: the value of an expanded state becomes the minimum over the frontier
+		 * of the cost to reach a frontier state plus its value (Dijkstra from the frontier,
+		 * along the reversed edges). It runs in the rest of the budget: if it is stopped, only
+		 * the states already popped have their final value, the others keep their value.
+		*/
+		std::unordered_map<unsigned int, unsigned int> new_values;
+		std::vector<bool> settled(nodes.size(), false);
+
+		for (node = 0; node < nodes.size(); ++node)
+		{
+			if (!expanded[node] && value(std::get<0>(nodes[node])) != UINT_MAX)
+				frontier.push(node, value(std::get<0>(nodes[node])));
+		}
+
+		while (!frontier.empty())
+		{
+			if (elapsed() >= budget)
+			{
+				local_stats.learning_interrupted = true;
+				break;
+			}
+
+			next_cost = frontier.min_priority();
+			node = frontier.pop();
+
+			if (settled[node])
+				continue;
+			settled[node] = true;
+
+			for (std::pair<unsigned int, unsigned int> pred : predecessors[node])
+			{
+				priority = saturated_sum(next_cost, pred.second);
+
+				if (priority != UINT_MAX && !settled[pred.first]
+				    && (new_values.find(pred.first) == new_values.end() || priority < new_values[pred.first]))
+				{
+					new_values[pred.first] = priority;
+					frontier.push(pred.first, priority);
+				}
+			}
+		}
+
+		for (node = 0; node < nodes.size(); ++node)
+		{
+			if (!expanded[node])
+				continue;
+
+			// The value of a state not reached yet by an interrupted learning phase is not known
+			if (local_stats.learning_interrupted && !settled[node])
+				continue;
+
+			// A state from which no frontier state is reachable is a dead end
+			if (new_values.find(node) == new_values.end())
+				new_values[node] = UINT_MAX;
+
+			if (new_values[node] > value(std::get<0>(nodes[node])))
+			{
+				m_values[std::get<0>(nodes[node])] = new_values[node];
+				local_stats.updates++;
+			}
+		}
+	}
+
+	local_stats.elapsed = elapsed();
+
+	if (stats)
+		*stats = local_stats;
+
+	// Current is a goal or a dead end
+	if (target <= 0)
+		return successor(current, std::vector<symbol>(), 0);
+
+	// The first action towards the target
+	for (node = target; std::get<1>(nodes[node]) != 0; node = std::get<1>(nodes[node]));
+
+	return successor(std::get<0>(nodes[node]), std::get<3>(nodes[node]), std::get<2>(nodes[node]));
+}
+
+/**
+ * Breadth-first search from start until a state with a heuristic value strictly lower than
+ * start_heur, or a state satisfying the goal, is found.
+ * The nodes of the search are stored in nodes. The items in a tuple correspond to:
+ *	- the state which is considered,
+ *	- the index of its predecessor in nodes,
+ *	- the cost to reach this state from start,
+ *	- the action that leaded to this state.
+ * Returns the index of the improving node in nodes, or 0 if there is none.
+*/
+static unsigned int ehc_breadth_first(const problem &prob, heuristic h, unsigned int power,
+	bool helpful, const state &start, unsigned int start_heur, unsigned int &found_heur,
+	std::vector<std::tuple<state, unsigned int, unsigned int, std::vector<symbol>>> &nodes,
+	stubborn_sets *pruning, ehc_statistics &stats)
+{
+	unsigned int current, found = 0, heur_value;
+	const state &final_state = prob.final_state();
+	std::vector<successor> next_states;
+	std::vector<std::vector<symbol>> relaxed_plan;
+	std::unordered_set<state, state_hasher> visited;
+
+	nodes.clear();
+	nodes.push_back({start, 0, 0, std::vector<symbol>()});
+	visited.insert(start);
+
+	for (current = 0; current < nodes.size() && !found; ++current)
+	{
+		stats.expansions++;
+		next_states = successors(prob, std::get<0>(nodes[current]), pruning);
+
+		// Keeping only the successors obtained with an action of the relaxed plan
+		if (helpful)
+		{
+			relaxed_plan = helpful_actions(prob, std::get<0>(nodes[current]));
+			next_states.erase(std::remove_if(next_states.begin(), next_states.end(),
+				[&relaxed_plan](const successor &succ)
+				{
+					return std::find(relaxed_plan.begin(), relaxed_plan.end(),
+							 std::get<1>(succ)) == relaxed_plan.end();
+				}), next_states.end());
+		}
+
+		for (successor succ : next_states)
+		{
+			if (!visited.insert(std::get<0>(succ)).second)
+				continue;
+
+			nodes.push_back({std::get<0>(succ), current,
+					 std::get<2>(nodes[current])+std::get<2>(succ), std::get<1>(succ)});
+
+			if (final_state.included(std::get<0>(succ)))
+			{
+				found_heur = 0;
+				found = nodes.size()-1;
+				break;
+			}
+
+			heur_value = h(prob, std::get<0>(succ), power);
+			if (heur_value < start_heur)
+			{
+				found_heur = heur_value;
+				found = nodes.size()-1;
+				break;
+			}
+		}
+	}
+
+	// The improving state was not a direct successor of start: the search crossed a plateau
+	if (found && current > 1)
+	{
+		stats.plateau_searches++;
+		stats.total_plateau_size += current;
+		stats.max_plateau_size = std::max(stats.max_plateau_size, current);
+	}
+
+	return found;
+}
+
+path enforced_hill_climbing(const problem &prob, heuristic h, unsigned int power, bool helpful,
+			    stubborn_sets *pruning, ehc_statistics *stats)
+{
+	pool_scope memory(stats ? &stats->memory : nullptr);
+	unsigned int current_heur, found, node;
+	ehc_statistics local_stats = {0, 0, 0, 0, false, pool_statistics()};
+
+	path p, rest;
+	problem rest_prob(prob);
+	state current_state = prob.init_state(), final_state = prob.final_state();
+	std::vector<std::tuple<state, unsigned int, unsigned int, std::vector<symbol>>> nodes;
+
+	std::stack<state> path_states;
+	std::stack<std::vector<symbol>> path_actions;
+
+	current_heur = h(prob, current_state, power);
+	std::get<0>(p).push_back(current_state);
+	std::get<2>(p) = 0;
+
+	while (!final_state.included(current_state))
+	{
+		found = ehc_breadth_first(prob, h, power, helpful, current_state, current_heur,
+					  current_heur, nodes, pruning, local_stats);
+
+		// Helpful actions may prune every improving state, retrying without pruning
+		if (!found && helpful)
+			found = ehc_breadth_first(prob, h, power, false, current_state, current_heur,
+						  current_heur, nodes, pruning, local_stats);
+
+		// Dead end: falling back to the complete best-first search from the current state
+		if (!found)
+		{
+			local_stats.fallback = true;
+			rest_prob.set_initial(current_state);
+			rest = astar(rest_prob, h, power, pruning);
+
+			if (std::get<0>(rest).empty())
+				p = astar(prob, h, power, pruning);
+			else
+			{
+				std::get<0>(p).insert(std::get<0>(p).end(), std::get<0>(rest).begin()+1, std::get<0>(rest).end());
+				std::get<1>(p).insert(std::get<1>(p).end(), std::get<1>(rest).begin(), std::get<1>(rest).end());
+				std::get<2>(p) += std::get<2>(rest);
+			}
+			break;
+		}
+
+		// Committing to the improving state and appending the path leading to it
+		std::get<2>(p) += std::get<2>(nodes[found]);
+
+		for (node = found; node != 0; node = std::get<1>(nodes[node]))
+		{
+			path_states.push(std::get<0>(nodes[node]));
+			path_actions.push(std::get<3>(nodes[node]));
+		}
+
+		while (!path_states.empty())
+		{
+			std::get<0>(p).push_back(path_states.top());
+			path_states.pop();
+			std::get<1>(p).push_back(path_actions.top());
+			path_actions.pop();
+		}
+
+		current_state = std::get<0>(nodes[found]);
+	}
+
+	if (stats)
+		*stats = local_stats;
+
+	return p;
+}
+
+/**
+ * Ground task and relaxed planning graph of the last problem given to a heuristic of the delete
+ * relaxation in a thread, so that they are built once per problem rather than once per
+ * evaluated state. The problem is recognized by its revision and the revision of its domain,
+ * which are never given again to another content (see new_revision()).
+*/
+struct relaxed_context
+{
+	unsigned long long prob_revision;
+	unsigned long long dom_revision;
+
+	std::unique_ptr<ground_task> task;
+	std::unique_ptr<planning_graph> graph;
+};
+
+/**
+ * @return The context of prob, built again if prob is not the problem of the last call in the
+ *	   thread.
+*/
+static relaxed_context& get_relaxed_context(const problem &prob)
+{
+	thread_local relaxed_context context = {0, 0, nullptr, nullptr};
+
+	if (!context.task || context.prob_revision != prob.revision()
+	    || context.dom_revision != prob.get_domain().revision())
+	{
+		// The graph refers to the task, it is destroyed first
+		context.graph.reset();
+		context.task.reset(new ground_task(prob));
+		context.graph.reset(new planning_graph(*context.task, context.task->init(), false));
+
+		context.prob_revision = prob.revision();
+		context.dom_revision = prob.get_domain().revision();
+	}
+
+	return context;
+}
+
+/**
+ * Extracts a plan of the delete relaxation of the task from the facts init, see relaxed_plan().
+ * The graph, built without mutexes on the task, is reset to init.
+ * @return False if the goal is unreachable.
+*/
+static bool relaxed_plan_actions(const ground_task &task, planning_graph &graph,
+				 const std::vector<unsigned int> &init, std::vector<unsigned int> &plan)
+{
+	unsigned int layer, best, difficulty, best_difficulty, node_layer;
+	std::vector<unsigned int> subgoals;
+
+	std::vector<std::vector<unsigned int>> goals;
+	std::vector<bool> achieved(graph.nb_literals(), false), selected(task.nb_actions(), false);
+
+	graph.reset(init);
+
+	while (graph.goal_level(task.goal()) == UINT_MAX)
+	{
+		if (!graph.expand())
+			return false;
+	}
+
+	goals.resize(graph.nb_layers());
+	for (unsigned int g : task.goal())
+		goals[graph.level(g)].push_back(g);
+
+	for (layer = graph.nb_layers()-1; layer > 0; --layer)
+	{
+		for (unsigned int i = 0; i < goals[layer].size(); ++i)
+		{
+			unsigned int g = goals[layer][i];
+
+			if (achieved[g])
+				continue;
+
+			// The supporter of the previous layer whose pre-conditions appear the earliest
+			best = UINT_MAX;
+			best_difficulty = UINT_MAX;
+			subgoals.clear();
+
+			for (unsigned int n : graph.supporters(g))
+			{
+				if (graph.is_noop(n) || graph.node_level(n) != layer-1)
+					continue;
+
+				difficulty = 0;
+				for (unsigned int p : graph.preconditions(n))
+					difficulty += graph.level(p);
+
+				if (difficulty < best_difficulty)
+				{
+					best = n;
+					best_difficulty = difficulty;
+					subgoals = graph.preconditions(n);
+				}
+			}
+
+			// A conditional effect, whose conditions are also sub-goals
+			for (const std::pair<unsigned int, unsigned int> &c : graph.cond_supporters(g))
+			{
+				const std::vector<unsigned int> &conditions = graph.cond_effects(c.first)[c.second].first;
+
+				node_layer = graph.node_level(c.first);
+				difficulty = 0;
+
+				for (unsigned int p : graph.preconditions(c.first))
+					difficulty += graph.level(p);
+
+				for (unsigned int p : conditions)
+				{
+					node_layer = std::max(node_layer, graph.level(p));
+					difficulty += graph.level(p);
+				}
+
+				if (node_layer == layer-1 && difficulty < best_difficulty)
+				{
+					best = c.first;
+					best_difficulty = difficulty;
+					subgoals = graph.preconditions(c.first);
+					subgoals.insert(subgoals.end(), conditions.begin(), conditions.end());
+				}
+			}
+
+			assert(("A literal of the relaxed planning graph has no supporter.", best != UINT_MAX));
+
+			if (!selected[best])
+			{
+				selected[best] = true;
+				plan.push_back(best);
+			}
+
+			for (unsigned int e : graph.effects(best))
+				achieved[e] = true;
+			achieved[g] = true;
+
+			for (unsigned int p : subgoals)
+			{
+				if (graph.level(p) > 0 && !achieved[p])
+					goals[graph.level(p)].push_back(p);
+			}
+		}
+	}
+
+	return true;
+}
+
+std::vector<std::vector<symbol>> helpful_actions(const problem &prob, const state &init)
+{
+	relaxed_context &context = get_relaxed_context(prob);
+	std::vector<unsigned int> plan;
+	std::vector<std::vector<symbol>> to_return;
+
+	relaxed_plan_actions(*context.task, *context.graph, context.task->facts(init), plan);
+
+	for (unsigned int a : plan)
+		to_return.push_back(context.task->get_action(a).name);
+
+	return to_return;
+}
+
+unsigned int zero_heuristic(const problem &prob, const state &init, unsigned int power)
+{
+	return 0;
+}
+
+/**
+ * Uniform-cost search over the encoded states of the delete relaxation of the task (see
+ * ground_task::apply_relaxed()).
+ * @return The cost of an optimal plan of the delete relaxation from the facts init, or UINT_MAX
+ *	   if the goal is unreachable.
+*/
+static unsigned int relaxed_cost(const ground_task &task, const std::vector<unsigned int> &init)
+{
+	unsigned int current, next, next_cost, key_size = task.state_bytes();
+	std::pair<unsigned int, unsigned int> entry;
+
+	// Encoded states stored one after the other, with the cost to reach each of them
+	std::vector<unsigned char> states(key_size), generated(key_size);
+	std::vector<unsigned int> costs;
+	std::unordered_map<std::string, unsigned int> node_indexes;
+	std::unordered_map<std::string, unsigned int>::iterator node_it;
+
+	// Waiting list of (cost to reach the node, node index)
+	std::set<std::pair<unsigned int, unsigned int>> waiting_list;
+
+	task.encode(init, states.data());
+	costs.push_back(0);
+	node_indexes.insert({std::string(states.begin(), states.end()), 0});
+	waiting_list.insert({0, 0});
+
+	while (!waiting_list.empty())
+	{
+		entry = *waiting_list.begin();
+		waiting_list.erase(waiting_list.begin());
+		current = entry.second;
+
+		if (task.is_goal(&states[current*key_size]))
+			return entry.first;
+
+		for (unsigned int a = 0; a < task.nb_actions(); ++a)
+		{
+			if (!task.apply_relaxed(a, &states[current*key_size], generated.data()))
+				continue;
+
+			next_cost = saturated_sum(entry.first, task.get_action(a).cost);
+			node_it = node_indexes.find(std::string(generated.begin(), generated.end()));
+
+			if (node_it == node_indexes.end())
+			{
+				next = costs.size();
+				node_indexes.insert({std::string(generated.begin(), generated.end()), next});
+				states.insert(states.end(), generated.begin(), generated.end());
+				costs.push_back(next_cost);
+				waiting_list.insert({next_cost, next});
+			}
+			else if (next_cost < costs[node_it->second])
+			{
+				waiting_list.erase({costs[node_it->second], node_it->second});
+				costs[node_it->second] = next_cost;
+				waiting_list.insert({next_cost, node_it->second});
+			}
+		}
+	}
+
+	return UINT_MAX;
+}
+
+unsigned int delete_relaxation(const problem &prob, const state &init, unsigned int power)
+{
+	relaxed_context &context = get_relaxed_context(prob);
+	std::vector<unsigned int> facts = context.task->facts(init);
+
+	// The goal missing from the relaxed planning graph, no relaxed plan needs to be searched
+	context.graph->reset(facts);
+
+	while (context.graph->goal_level(context.task->goal()) == UINT_MAX)
+	{
+		if (!context.graph->expand())
+			return UINT_MAX;
+	}
+
+	return relaxed_cost(*context.task, facts);
+}
+
+unsigned int relaxed_plan(const problem &prob, const state &init, unsigned int power)
+{
+	unsigned int to_return = 0;
+
+	relaxed_context &context = get_relaxed_context(prob);
+	std::vector<unsigned int> plan;
+
+	if (!relaxed_plan_actions(*context.task, *context.graph, context.task->facts(init), plan))
+		return UINT_MAX;
+
+	for (unsigned int a : plan)
+		to_return += context.task->get_action(a).cost;
+
+	return to_return;
+}
+
+unsigned int critical_path(const problem &prob, const state &init, unsigned int power)
+{
+	bool updated;
+	int i, j;
+	path p;
+	problem new_p(prob);
+	state s(prob.get_domain().state_dimensions());
+	std::pair<unsigned int, tuple<symbol>> goal;
+	unsigned int pred_indexes[power], h_max(0);
+
+	assert(("Cannot use critical_path heuristic with the current power value, not enough predicate in the final state to create a subset of predicate of this size.", power <= prob.final_state().size()));
+
+	// Initializing the predicate indexes to the first power-size combination
+	for (i = 0; i < power; ++i)
+		pred_indexes[i] = i;
+
+	// Initializing the initial state
+	new_p.set_initial(init);
+
+	while (pred_indexes[0] < prob.final_state().size()-power
+	       || pred_indexes[power-1] <= prob.final_state().size()-1)
+	{
+		// Initializing the final state
+		for (i = 0; i < power; ++i)
+		{
+			goal = prob.final_state().atom(pred_indexes[i]);
+			s.add(goal.first, std::move(goal.second));
 		}
 		new_p.set_final(s);
 
 		// Solving the new problem with Dijkstra
-		p = astar(new_p, zero_heuristic);
+		p = bucket_astar(new_p, zero_heuristic);
 
 		// Saving the heuristic value if greater than h_max
 		if (std::get<2>(p) > h_max)
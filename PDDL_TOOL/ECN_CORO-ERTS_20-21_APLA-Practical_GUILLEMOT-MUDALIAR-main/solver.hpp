@@ -1,14 +1,39 @@
 #ifndef SOLVER_HPP
 #define SOLVER_HPP
 
+#include "data_structures/bdd.hpp"
+#include "data_structures/bloom_filter.hpp"
+#include "data_structures/bucket_queue.hpp"
+#include "data_structures/node_pool.hpp"
+#include "data_structures/novelty_table.hpp"
+#include "data_structures/sat_solver.hpp"
+#include "data_structures/segment_file.hpp"
+#include "data_structures/subset_index.hpp"
+#include "planning_problem/delta_store.hpp"
+#include "planning_problem/ground_task.hpp"
+#include "planning_problem/planning_graph.hpp"
 #include "planning_problem/problem.hpp"
+#include "planning_problem/sas_encoding.hpp"
 #include "planning_problem/state.hpp"
+#include "planning_problem/stubborn_sets.hpp"
+#include "planning_problem/symmetry_group.hpp"
 
 #include <algorithm>
 #include <cassert>
+#include <chrono>
 #include <climits>
+#include <cstring>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <random>
+#include <set>
 #include <stack>
+#include <string>
+#include <thread>
 #include <tuple>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 // FOR TEST PURPOSES ONLY
@@ -22,7 +47,9 @@ typedef std::tuple<std::vector<state>, std::vector<std::vector<symbol>>, unsigne
  * @arg init The initial state whom estimated cost we want to compute
  * @arg power The power of the heuristic in its family (used only with critical path heuristic
  *	      to choose between h^{1}, h^{2}, etc.)
- * @return The estimated cost of solving the problem from state init.
+ * @return The estimated cost of solving the problem from state init, or UINT_MAX if init is a
+ *	   dead end (the goal cannot be reached from it). This value must not be added to a cost
+ *	   without a check, the best-first searches never expand such states.
 */
 typedef unsigned int (*heuristic)(const problem &prob, const state &init, unsigned int power);
 
@@ -34,23 +61,690 @@ struct
 	}
 } greater;
 
+/**
+ * A successor of a state. The items in the tuple correspond to:
+ *	- the state obtained,
+ *	- the ground action that leaded to it (its name followed by its parameters),
+ *	- the cost of this action.
+*/
+typedef std::tuple<state, std::vector<symbol>, unsigned int> successor;
+
+// Hash functor to store states in unordered containers
+struct state_hasher
+{
+	std::size_t operator()(const state &s) const { return s.hash(); }
+};
+
+/**
+ * Statistics of the enforced hill-climbing search.
+*/
+struct ehc_statistics
+{
+	// Number of states expanded by the breadth-first searches
+	unsigned int expansions;
+
+	// Number of breadth-first searches which had to look further than the direct successors
+	unsigned int plateau_searches;
+
+	// Number of states expanded by the largest plateau search and by all of them
+	unsigned int max_plateau_size;
+	unsigned int total_plateau_size;
+
+	// True if hill-climbing hit a dead end and the complete best-first search was used
+	bool fallback;
+
+	// Use of the node pool by the search, including the fallback (see pool_scope)
+	pool_statistics memory;
+};
+
 bool max_count(unsigned int nb_params, unsigned int nb_objects, unsigned int *counter);
 
 void increment_count(unsigned int nb_params, unsigned int nb_objects, unsigned int *counter,
 		     unsigned int index = 0);
 
+/**
+ * Statistics of the bidirectional search.
+*/
+struct bidirectional_statistics
+{
+	// Number of states expanded by the forward and the backward searches
+	unsigned int forward_expansions;
+	unsigned int backward_expansions;
+
+	// Number of regressed partial states pruned because a more general one was already known
+	unsigned int subsumed;
+};
+
+/**
+ * Statistics of the regression search.
+*/
+struct regression_statistics
+{
+	// Number of partial states expanded
+	unsigned int expansions;
+
+	// Number of partial states pruned because a more general and cheaper one was known
+	unsigned int subsumed;
+
+	// Number of partial states pruned because the planning graph proves them unreachable
+	unsigned int unreachable;
+};
+
+/**
+ * Statistics of a layer of the external-memory search.
+*/
+struct external_layer_statistics
+{
+	// Number of new states in the layer
+	unsigned int states;
+
+	// Number of sorted runs spilled to disk while generating the layer
+	unsigned int runs;
+
+	// Bytes written to and read from the segment files to build the layer
+	unsigned long long bytes_written;
+	unsigned long long bytes_read;
+
+	// Time spent merging the runs with the closed list, in seconds
+	double merge_time;
+};
+
+struct external_statistics
+{
+	std::vector<external_layer_statistics> layers;
+};
+
+/**
+ * Statistics of the beam search.
+*/
+struct beam_statistics
+{
+	// Number of states expanded and generated
+	unsigned int expansions;
+	unsigned int generated;
+
+	/**
+	 * Number of new states dropped by the beam at each depth (the first item is for the
+	 * successors of the initial state).
+	*/
+	std::vector<unsigned int> pruned;
+
+	// True if no plan was found after the beam pruned states, which might have led to the goal
+	bool incomplete;
+
+	// Use of the node pool by the search (see pool_scope)
+	pool_statistics memory;
+};
+
+/**
+ * Statistics of a decision of the real-time search.
+*/
+struct real_time_statistics
+{
+	// Number of states expanded by the lookahead
+	unsigned int expansions;
+
+	// Number of learned heuristic values which were increased
+	unsigned int updates;
+
+	// Time spent on the decision, in microseconds
+	unsigned long long elapsed;
+
+	// True if the lookahead reached a goal state
+	bool goal_seen;
+
+	// True if the learning phase ran out of time, leaving some values unchanged
+	bool learning_interrupted;
+};
+
+/**
+ * Statistics of the random-walk search.
+*/
+struct random_walk_statistics
+{
+	// Number of episodes (rounds of parallel walks from the same state)
+	unsigned int episodes;
+
+	// Number of walks, and of actions applied by the walks
+	unsigned long long walks;
+	unsigned long long steps;
+
+	// Number of walks which stopped in a state without any applicable action
+	unsigned long long dead_ends;
+
+	// Number of times the search committed to a better endpoint, and restarted from scratch
+	unsigned int commits;
+	unsigned int restarts;
+};
+
+/**
+ * Statistics of the width-based searches.
+*/
+struct width_statistics
+{
+	// Number of states expanded and generated
+	unsigned int expansions;
+	unsigned int generated;
+
+	// Number of generated states pruned because their novelty was greater than the width
+	unsigned int pruned;
+
+	// Number of generated states which had already been generated
+	unsigned int duplicates;
+};
+
+/**
+ * Statistics of the symbolic search.
+*/
+struct symbolic_statistics
+{
+	// Number of layers (sets of states with the same cost) expanded in each direction
+	unsigned int forward_expansions;
+	unsigned int backward_expansions;
+
+	// Number of partitions of the transition relations and their total number of nodes
+	unsigned int relations;
+	unsigned int relation_nodes;
+
+	// Largest number of BDD nodes allocated, and number of garbage collections
+	unsigned long long peak_nodes;
+	unsigned int gc_runs;
+};
+
+/**
+ * Statistics of the SAT-based planning.
+*/
+struct sat_statistics
+{
+	// Number of horizons tried, and the last one
+	unsigned int horizons;
+	unsigned int horizon;
+
+	// Size of the encoding for the last horizon
+	unsigned int variables;
+	unsigned int clauses;
+
+	// Counters of the CDCL solver over all the horizons
+	unsigned long long conflicts;
+	unsigned long long decisions;
+	unsigned int learned;
+};
+
+/**
+ * Statistics of Graphplan.
+*/
+struct graphplan_statistics
+{
+	// Number of fact layers of the planning graph, and the layer where it leveled off (or UINT_MAX)
+	unsigned int layers;
+	unsigned int level_off;
+
+	// Number of mutex pairs of literals in the last layer
+	unsigned long long mutexes;
+
+	// Number of goal sets the backward extraction tried to support, and of them which failed (memoized)
+	unsigned long long extractions;
+	unsigned long long nogoods;
+};
+
+/**
+ * Statistics of the orbit search.
+*/
+struct symmetry_statistics
+{
+	// Number of generators of the symmetry group, and of nodes of the search for them
+	unsigned int generators;
+	unsigned long long automorphism_nodes;
+
+	// Number of states expanded and generated
+	unsigned int expansions;
+	unsigned long long generated;
+
+	// Number of generated states whose orbit had already been reached
+	unsigned long long duplicates;
+
+	// Number of them which were only symmetric to a state already reached (pruned by symmetry)
+	unsigned long long pruned;
+};
+
+/**
+ * Statistics of the delta-encoded A* search.
+*/
+struct delta_statistics
+{
+	// Number of states expanded and generated
+	unsigned int expansions;
+	unsigned long long generated;
+
+	// Number of states stored in the closed list, and of checkpoints among them
+	unsigned int stored;
+	unsigned int checkpoints;
+
+	// Number of grounded predicates in all the deltas
+	unsigned long long delta_atoms;
+
+	// Number of states retrieved from the cache and rebuilt, and of deltas applied to rebuild them
+	unsigned long long cache_hits;
+	unsigned long long cache_misses;
+	unsigned long long applied_deltas;
+
+	// Use of the node pool by the search (see pool_scope)
+	pool_statistics memory;
+};
+
+/**
+ * Statistics of the bitstate search.
+*/
+struct bitstate_statistics
+{
+	// Number of states expanded and generated
+	unsigned int expansions;
+	unsigned long long generated;
+
+	// Number of generated states dropped because the filter reported them as visited
+	unsigned long long revisited;
+
+	// Number of states inserted in the filter
+	unsigned long long visited;
+
+	// Size of the filter in bits, and proportion of bits set at the end of the search
+	unsigned long long filter_bits;
+	double fill_ratio;
+
+	// Estimated probability that a new state was wrongly reported as visited
+	double false_positive_rate;
+
+	// Number of bits of a state in the finite-domain encoding
+	unsigned int state_bits;
+};
+
+/**
+ * @arg prob The problem to solve
+ * @arg current The state to expand
+ * @arg pruning If not null, only the successors obtained with the actions of a strong stubborn
+ *		set of current are returned (see stubborn_sets), its task must be the ground task
+ *		of prob
+ * @return All the states reachable from current by applying one ground action.
+*/
+std::vector<successor> successors(const problem &prob, const state &current, stubborn_sets *pruning = nullptr);
+
 /**
  * @arg prob The problem to solve
  * @arg h The heuristics used to estimate the cost of a state
  * @arg power The power of the heuristic in its family (used only with critical path heuristic
  * 	      to choose between h^{1}, h^{2}, etc.)
+ * @arg pruning If not null, the stubborn set pruning of the successors (see successors())
+ * @arg stats If not null, filled with the use of the node pool by the search (see pool_scope)
+*/
+path astar(const problem &prob, heuristic h, unsigned int power = 1, stubborn_sets *pruning = nullptr,
+	   pool_statistics *stats = nullptr);
+
+/**
+ * A* specialized for small integer action costs. The waiting list is a bucket queue indexed by
+ * the estimated total cost, so that pushing and popping a state run in constant time, and the
+ * states are found through a hash table instead of a scan of the predecessors.
+ * When every action costs 1 and h is zero_heuristic, breadth_first_search() is used instead,
+ * and when an action costs more than 64, astar() is used instead, since the queue allocates a
+ * bucket for each f-value up to the largest one.
+ * The states whose heuristic value is UINT_MAX are dead ends, and are never pushed.
+ *
+ * @arg prob The problem to solve
+ * @arg h The heuristics used to estimate the cost of a state
+ * @arg power The power of the heuristic in its family
+ * @arg pruning If not null, the stubborn set pruning of the successors (see successors())
+ * @arg stats If not null, filled with the use of the node pool by the search (see pool_scope)
+*/
+path bucket_astar(const problem &prob, heuristic h, unsigned int power = 1, stubborn_sets *pruning = nullptr,
+		  pool_statistics *stats = nullptr);
+
+/**
+ * Breadth-first search, optimal when every action costs 1. The goal test is done when a state
+ * is generated.
+ *
+ * @arg prob The problem to solve
+ * @arg pruning If not null, the stubborn set pruning of the successors (see successors())
+ * @arg stats If not null, filled with the use of the node pool by the search (see pool_scope)
+*/
+path breadth_first_search(const problem &prob, stubborn_sets *pruning = nullptr, pool_statistics *stats = nullptr);
+
+/**
+ * A* storing its closed list as deltas (see delta_store): each state is kept as the predicates
+ * added and deleted by the action from its predecessor, with a complete copy every
+ * checkpoint_interval generations, so the memory per state grows with the effects of the
+ * actions rather than with the size of the states. The states being expanded, compared and
+ * put in the plan are rebuilt from the deltas, an LRU cache of cache_size states keeping the
+ * recent ones at hand. The waiting list is a bucket queue, as in bucket_astar(), and the dead
+ * ends are never pushed either.
+ * The path is optimal if h is admissible and consistent.
+ *
+ * @arg prob The problem to solve
+ * @arg h The heuristics used to estimate the cost of a state
+ * @arg power The power of the heuristic in its family
+ * @arg checkpoint_interval The maximal number of deltas between a state and its checkpoint
+ * @arg cache_size The number of rebuilt states kept in the cache
+ * @arg pruning If not null, the stubborn set pruning of the successors (see successors())
+ * @arg stats If not null, filled with the statistics of the search
+*/
+path delta_astar(const problem &prob, heuristic h, unsigned int power = 1, unsigned int checkpoint_interval = 16,
+		 unsigned int cache_size = 64, stubborn_sets *pruning = nullptr, delta_statistics *stats = nullptr);
+
+/**
+ * Beam search. The states are expanded layer by layer, and each layer keeps only the width
+ * states with the lowest heuristic values, so that memory and time are bounded by width times
+ * the length of the plan. The goal test is done when a state is generated, and the states
+ * whose heuristic value is UINT_MAX are dead ends, which are never kept in a layer.
+ * The search is neither complete nor optimal.
+ *
+ * @arg prob The problem to solve
+ * @arg h The heuristics used to estimate the cost of a state
+ * @arg width The number of states kept in each layer
+ * @arg power The power of the heuristic in its family
+ * @arg diversity If true, the states with equal heuristic values are picked from different
+ *		  predecessors in turn, instead of in the order they were generated
+ * @arg pruning If not null, the stubborn set pruning of the successors (see successors())
+ * @arg stats If not null, filled with the statistics of the search
+*/
+path beam_search(const problem &prob, heuristic h, unsigned int width, unsigned int power = 1,
+		 bool diversity = false, stubborn_sets *pruning = nullptr, beam_statistics *stats = nullptr);
+
+/**
+ * Bidirectional breadth-first search. The forward search applies the actions on complete
+ * states, the backward search regresses the goal through the ground actions as partial states
+ * (a partial state is a set of facts which must be true and a set of facts which must be
+ * false). The smallest frontier is expanded first, and the search stops as soon as a forward
+ * state satisfies a partial state of the backward search. Both meetings are detected through
+ * subset indexes, which also prune the partial states subsumed by a more general one.
+ * The actions whose conditional effects touch a partial state are not regressed through, so
+ * the backward search may be exhausted: the forward search then goes on alone until the
+ * goal is reached or every reachable state is visited. The path is not guaranteed to be
+ * optimal.
+ *
+ * @arg prob The problem to solve
+ * @arg stats If not null, filled with the statistics of the search
+*/
+path bidirectional_search(const problem &prob, bidirectional_statistics *stats = nullptr);
+
+/**
+ * Uniform-cost regression search. The goal is regressed through the ground actions as a
+ * partial state (see bidirectional_search()) until a partial state satisfied by the initial
+ * state is found, so the facts which are irrelevant to the goal are never considered.
+ * A partial state is pruned when a known partial state with fewer literals and a lower or
+ * equal cost subsumes it, and when one of its literals, or a pair of them, is never reachable
+ * from the initial state according to the planning graph expanded until it leveled off.
+ * The actions whose conditional effects touch a partial state are not regressed through, so
+ * the search is incomplete on domains with conditional effects: it may return an empty path
+ * although the goal is reachable.
+ *
+ * @arg prob The problem to solve
+ * @arg stats If not null, filled with the statistics of the search
+*/
+path regression_search(const problem &prob, regression_statistics *stats = nullptr);
+
+/**
+ * External-memory breadth-first search with delayed duplicate detection.
+ * The states are encoded as bitsets over the facts of the ground task. Each layer is stored in
+ * an append-only segment file read through a memory mapping. While a layer is expanded, the
+ * successors are buffered in memory and spilled to disk as sorted runs; the runs are then
+ * merged and the states already in the closed list (a sorted file of all the previous layers)
+ * are removed. Only the buffer and the pages being scanned stay in memory.
+ * The path has the smallest number of actions, but not necessarily the smallest cost.
+ *
+ * @arg prob The problem to solve
+ * @arg directory The directory where a uniquely named subdirectory is created to hold the
+ *		  segment files, it is removed with them when the search returns or throws
+ * @arg buffer_size The number of states buffered in memory before spilling a sorted run
+ * @arg pruning If not null, only the actions of a strong stubborn set of each state are applied
+ *		(see stubborn_sets), its task must be the ground task of prob
+ * @arg stats If not null, filled with the statistics of each layer
 */
-path astar(const problem &prob, heuristic h, unsigned int power = 1);
+path external_search(const problem &prob, const std::string &directory,
+		     unsigned int buffer_size = 1 << 20, stubborn_sets *pruning = nullptr,
+		     external_statistics *stats = nullptr);
+
+/**
+ * Depth-first search with bitstate (supertrace) duplicate detection. The visited states are
+ * not stored: they are packed by the finite-domain encoding (see sas_encoding) and inserted in
+ * a Bloom filter, so each visited state costs a few bits. The successors of a state are tried by
+ * increasing number of unsatisfied goals.
+ * A false positive of the filter prunes a state which was never visited, so the search is
+ * neither complete nor optimal.
+ *
+ * @arg prob The problem to solve
+ * @arg filter_bits The size of the Bloom filter, in bits, allocated up front: the default
+ *		    (2 MiB) keeps the false positives rare up to about a million states, larger
+ *		    searches should give a size of ten or more bits per state expected
+ * @arg nb_hashes The number of hash functions of the filter
+ * @arg max_depth The maximal length of the path
+ * @arg pruning If not null, the stubborn set pruning of the successors (see external_search())
+ * @arg stats If not null, filled with the statistics of the search
+*/
+path bitstate_search(const problem &prob, unsigned long long filter_bits = 1ULL << 24,
+		     unsigned int nb_hashes = 3, unsigned int max_depth = UINT_MAX,
+		     stubborn_sets *pruning = nullptr, bitstate_statistics *stats = nullptr);
+
+/**
+ * Real-time heuristic search (LSS-LRTA*). Each decision runs a bounded A* lookahead from the
+ * current state, then raises the heuristic values of the expanded states with a Dijkstra
+ * propagation from the frontier, and returns the first action towards the best state of the
+ * frontier. The learned heuristic values are kept in the object, so that they carry over
+ * between the decisions (and the trials) on the same problem, and the agent eventually
+ * follows an optimal path.
+ * The lookahead stops when half of the time budget is spent, the clock being checked before
+ * each expansion and each evaluation of the heuristic, and the learning phase stops at the end
+ * of the budget, the states it did not reach keeping their value. The budget is only exceeded
+ * by the first expansion, which is always completed so that the agent can move, and by the
+ * last evaluation of the heuristic or step of the learning phase.
+*/
+class real_time_search
+{
+	private:
+		/** ATTRIBUTES **/
+
+		const problem &m_problem;
+		heuristic m_heuristic;
+		unsigned int m_power;
+
+		// Stubborn set pruning of the successors in the lookahead, or null (see successors())
+		stubborn_sets *m_pruning;
+
+		state m_final_state;
+
+		// Learned heuristic values of the states met so far
+		std::unordered_map<state, unsigned int, state_hasher> m_values;
+
+		/** METHODS **/
+		unsigned int value(const state &s);
+
+	public:
+		/** METHODS **/
+
+		// Constructor
+		real_time_search(const problem &prob, heuristic h, unsigned int power = 1,
+				 stubborn_sets *pruning = nullptr);
+
+		/**
+		 * @arg current The state of the agent
+		 * @arg budget The time allowed for the decision, in microseconds
+		 * @arg stats If not null, filled with the statistics of the decision
+		 * @return The next action and the state it leads to, with an empty action if current
+		 *	   satisfies the goal or is a dead end.
+		*/
+		successor next_action(const state &current, unsigned long long budget,
+				      real_time_statistics *stats = nullptr);
+
+		/**
+		 * @return The learned heuristic value of a state (the heuristic value if it was never
+		 *	   updated).
+		*/
+		unsigned int learned_value(const state &s);
+
+		// Number of states in the table of learned values
+		unsigned int nb_learned(void) const;
+};
+
+/**
+ * Arvand-style Monte-Carlo random-walk search. At each episode, nb_walks random walks of
+ * walk_length actions are sampled from the current state, split between nb_threads threads.
+ * The endpoints are scored by their number of unsatisfied goals, and the search commits to
+ * the best one if it improves on the current state. The walks work on encoded states of the
+ * ground task, applying the actions in place, so no state is allocated during the walks.
+ * After each episode without progress the length of the walks is doubled, and after 4 of them
+ * the search restarts from the initial state.
+ * The search is neither complete nor optimal.
+ *
+ * @arg prob The problem to solve
+ * @arg nb_threads The number of threads sampling the walks
+ * @arg nb_walks The number of walks of an episode
+ * @arg walk_length The initial number of actions of a walk
+ * @arg max_episodes The number of episodes after which the search gives up
+ * @arg seed The seed of the random generators
+ * @arg stats If not null, filled with the statistics of the search
+*/
+path random_walk_search(const problem &prob, unsigned int nb_threads = 4, unsigned int nb_walks = 2000,
+			unsigned int walk_length = 10, unsigned int max_episodes = 1000,
+			unsigned int seed = 0, random_walk_statistics *stats = nullptr);
+
+/**
+ * Symbolic bidirectional uniform-cost search. The sets of states are represented as binary
+ * decision diagrams over the facts of the ground task (a current and a next variable per fact,
+ * interleaved), and the ground actions with the same cost are merged into one transition
+ * relation, split into disjunctive partitions of bounded size. The layers of states with the
+ * same cost are expanded by images in the forward direction and pre-images in the backward
+ * direction, the direction whose next layer has the fewest nodes being expanded first. The
+ * search stops when no path cheaper than the best meeting of both directions remains, and the
+ * path is rebuilt concrete state by concrete state through the layers.
+ * Every action must have a positive cost. The path is optimal.
+ *
+ * @arg prob The problem to solve
+ * @arg stats If not null, filled with the statistics of the search
+*/
+path symbolic_search(const problem &prob, symbolic_statistics *stats = nullptr);
+
+/**
+ * Planning as satisfiability. The ground task is encoded in CNF for a horizon T with the
+ * forall-step parallel semantics: a step is a set of actions which can be executed in any
+ * order, the pairs of actions which interfere (one disables or conflicts with the other) being
+ * forbidden by mutex clauses. The frame is given by explanatory frame axioms (a fact changes
+ * only if an action of the step changes it).
+ * The horizon starts at 1 and is multiplied by growth (and increased by at least 1) until a
+ * plan is found. The steps are added to the same incremental CDCL solver, and the goal of a
+ * horizon is only assumed, so the learned clauses are reused from one horizon to the next.
+ * The path is neither optimal in cost nor in number of steps.
+ *
+ * @arg prob The problem to solve
+ * @arg max_horizon The horizon after which the search gives up
+ * @arg growth The factor applied to the horizon after each unsatisfiable one
+ * @arg stats If not null, filled with the statistics of the search
+*/
+path sat_planning(const problem &prob, unsigned int max_horizon = 200, double growth = 1.5,
+		  sat_statistics *stats = nullptr);
+
+/**
+ * Graphplan. The planning graph of the task (see planning_graph) is expanded until the goal
+ * literals are in the last fact layer without any mutex pair between them, then a plan is
+ * extracted backward from that layer: each goal is supported by a node of the previous action
+ * layer (the no-ops first) which is not mutex with the nodes already chosen, and the
+ * pre-conditions of the chosen nodes are the goals of the previous layer. The goal sets which
+ * cannot be supported in a layer are memoized, and the graph is expanded again after a failure.
+ * The search stops when the graph leveled off and the memoized goal sets of the level-off layer
+ * did not change between two failures.
+ * Conditional effects are never chosen to support a goal, so the search is incomplete when
+ * they are needed. The plan has the least number of parallel steps but is not optimal in cost.
+ *
+ * @arg prob The problem to solve
+ * @arg stats If not null, filled with the statistics of the search
+*/
+path graphplan(const problem &prob, graphplan_statistics *stats = nullptr);
+
+/**
+ * A* over the orbits of the object symmetries of the problem (see symmetry_group): each
+ * generated state is replaced by the canonical state of its orbit, so that the states which
+ * only differ by a permutation of interchangeable objects are expanded once. The heuristic is
+ * computed on the canonical states, the symmetries preserving the goal. The plan found over
+ * the canonical states is mapped back on the problem by composing the permutations of the
+ * canonicalizations along the path. Optimal with an admissible and consistent heuristic.
+ * As in bucket_astar(), the canonical states of heuristic value UINT_MAX are never expanded.
+ *
+ * @arg prob The problem to solve
+ * @arg h The heuristics used to estimate the cost of a state
+ * @arg power The power of the heuristic in its family
+ * @arg stats If not null, filled with the statistics of the search
+*/
+path orbit_search(const problem &prob, heuristic h, unsigned int power = 1, symmetry_statistics *stats = nullptr);
+
+/**
+ * Iterated width search IW(k): a breadth-first search over the encoded states of the ground
+ * task which prunes every generated state whose novelty is greater than k, i.e. which makes no
+ * new fact (k = 1) or pair of facts (k = 2) true. IW(k) expands a number of states linear in
+ * the number of facts for k = 1, and quadratic for k = 2.
+ * The search is neither complete nor optimal.
+ *
+ * @arg prob The problem to solve
+ * @arg width The width k, 1 or 2
+ * @arg pruning If not null, the stubborn set pruning of the successors (see external_search())
+ * @arg stats If not null, filled with the statistics of the search
+*/
+path iw_search(const problem &prob, unsigned int width = 1, stubborn_sets *pruning = nullptr,
+	       width_statistics *stats = nullptr);
+
+/**
+ * Best-first width search BFWS(w, #g). The states are expanded by increasing novelty, then by
+ * increasing number of unsatisfied goals #g. The novelty of a state (1, 2, or 3 when it makes
+ * no new pair of facts true) is computed with respect to the states generated with the same
+ * #g. No heuristic is computed on lifted states. The search is complete but not optimal.
+ *
+ * @arg prob The problem to solve
+ * @arg pruning If not null, the stubborn set pruning of the successors (see external_search())
+ * @arg stats If not null, filled with the statistics of the search
+*/
+path bfws(const problem &prob, stubborn_sets *pruning = nullptr, width_statistics *stats = nullptr);
+
+/**
+ * FF-style enforced hill-climbing. From the current state, a breadth-first search is run until
+ * a state with a strictly better heuristic value is found, and the search commits to it. If
+ * hill-climbing hits a dead end, the complete best-first search astar() is run from the state
+ * reached, keeping the path found so far. Since hill-climbing may have committed to a state
+ * from which the goal is unreachable, astar() is run from the initial state if it fails.
+ *
+ * @arg prob The problem to solve
+ * @arg h The heuristics used to estimate the cost of a state
+ * @arg power The power of the heuristic in its family
+ * @arg helpful If true, only the helpful actions (the actions of a relaxed plan) are expanded.
+ *		The search is run again without this pruning before falling back to astar().
+ * @arg pruning If not null, the stubborn set pruning of the successors (see successors()), also
+ *		given to astar() when it is run
+ * @arg stats If not null, filled with the statistics of the search
+*/
+path enforced_hill_climbing(const problem &prob, heuristic h, unsigned int power = 1,
+			    bool helpful = true, stubborn_sets *pruning = nullptr, ehc_statistics *stats = nullptr);
+
+/**
+ * @arg prob The problem to solve
+ * @arg init The state from which the relaxed problem is solved
+ * @return The ground actions of a plan of the delete relaxation of the problem, extracted from
+ *	   its relaxed planning graph as in FF (see relaxed_plan()).
+*/
+std::vector<std::vector<symbol>> helpful_actions(const problem &prob, const state &init);
 
 unsigned int zero_heuristic(const problem &prob, const state &init, unsigned int power);
 
+/**
+ * Cost of an optimal plan of the delete relaxation (h+), found by a uniform-cost search over the
+ * relaxed states of the ground task. Admissible, UINT_MAX if the goal is unreachable, which the
+ * relaxed planning graph tells before any search. The ground task and the graph are shared with
+ * relaxed_plan().
+*/
 unsigned int delete_relaxation(const problem &prob, const state &init, unsigned int power);
 
+/**
+ * FF heuristic: the cost of a plan of the delete relaxation, extracted backward from the relaxed
+ * planning graph. Each goal is supported by the action of the previous layer whose
+ * pre-conditions appear the earliest. Not admissible, UINT_MAX if the goal is unreachable.
+ * The ground task and the relaxed planning graph are built at the first call for a problem and
+ * reused, the graph being reset to each evaluated state (shared with helpful_actions()).
+*/
+unsigned int relaxed_plan(const problem &prob, const state &init, unsigned int power);
+
 unsigned int critical_path(const problem &prob, const state &init, unsigned int power);
 
 #endif // SOLVER_HPP
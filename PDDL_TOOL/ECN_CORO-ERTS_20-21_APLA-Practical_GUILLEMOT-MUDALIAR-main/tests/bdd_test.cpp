@@ -0,0 +1,242 @@
+#include "../data_structures/bdd.hpp"
+#include "check.hpp"
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+/**
+ * The diagrams over NB_VARS variables are checked against their truth tables: the bit i of a
+ * table is the value of the formula for the assignment whose variable v is the bit v of i.
+*/
+#define NB_VARS 6
+#define NB_ASSIGNMENTS (1 << NB_VARS)
+
+typedef std::uint64_t truth_table;
+
+struct formula
+{
+	bdd diagram;
+	truth_table table;
+};
+
+// Conjunction of the literals of an assignment
+static bdd minterm(bdd_manager &manager, unsigned int assignment)
+{
+	bdd to_return = bdd::constant(manager, true);
+
+	for (unsigned int v = 0; v < NB_VARS; ++v)
+		to_return &= bdd::literal(manager, v, (assignment >> v) & 1);
+
+	return to_return;
+}
+
+static truth_table table_of(bdd_manager &manager, const bdd &f)
+{
+	truth_table to_return = 0;
+
+	for (unsigned int i = 0; i < NB_ASSIGNMENTS; ++i)
+	{
+		if (!(f & minterm(manager, i)).is_zero())
+			to_return |= truth_table(1) << i;
+	}
+
+	return to_return;
+}
+
+static truth_table literal_table(unsigned int v)
+{
+	truth_table to_return = 0;
+
+	for (unsigned int i = 0; i < NB_ASSIGNMENTS; ++i)
+	{
+		if ((i >> v) & 1)
+			to_return |= truth_table(1) << i;
+	}
+
+	return to_return;
+}
+
+// Random formula of the given depth, built with the operators of bdd
+static formula random_formula(bdd_manager &manager, std::mt19937 &generator, unsigned int depth)
+{
+	unsigned int v;
+	formula f, g;
+
+	if (depth == 0)
+	{
+		v = generator()%NB_VARS;
+		if (generator()%2)
+			return {bdd::literal(manager, v), literal_table(v)};
+		return {bdd::literal(manager, v, false), ~literal_table(v)};
+	}
+
+	f = random_formula(manager, generator, depth-1);
+	g = random_formula(manager, generator, depth-1);
+
+	switch (generator()%5)
+	{
+		case 0:
+			return {f.diagram & g.diagram, f.table & g.table};
+		case 1:
+			return {f.diagram | g.diagram, f.table | g.table};
+		case 2:
+			return {f.diagram ^ g.diagram, f.table ^ g.table};
+		case 3:
+			return {f.diagram - g.diagram, f.table & ~g.table};
+		default:
+			return {~f.diagram, ~f.table};
+	}
+}
+
+// Existential quantification of the variables of mask on a truth table
+static truth_table exists_table(truth_table t, unsigned int mask)
+{
+	truth_table to_return = 0;
+
+	for (unsigned int i = 0; i < NB_ASSIGNMENTS; ++i)
+	{
+		for (unsigned int j = 0; j < NB_ASSIGNMENTS; ++j)
+		{
+			if ((j & ~mask) == (i & ~mask) && ((t >> j) & 1))
+			{
+				to_return |= truth_table(1) << i;
+				break;
+			}
+		}
+	}
+
+	return to_return;
+}
+
+static void check_identities(bdd_manager &manager, std::mt19937 &generator)
+{
+	bdd zero = bdd::constant(manager, false), one = bdd::constant(manager, true);
+
+	for (unsigned int k = 0; k < 300; ++k)
+	{
+		formula f = random_formula(manager, generator, 1+k%4);
+		formula g = random_formula(manager, generator, 1+k%3);
+
+		CHECK(table_of(manager, f.diagram) == f.table);
+		CHECK(table_of(manager, g.diagram) == g.table);
+
+		// The diagrams are canonical
+		CHECK((f.diagram == g.diagram) == (f.table == g.table));
+		CHECK(f.diagram.is_zero() == (f.table == 0));
+		CHECK(f.diagram.is_one() == (f.table == ~truth_table(0)));
+
+		CHECK((f.diagram & ~f.diagram) == zero);
+		CHECK((f.diagram | ~f.diagram) == one);
+		CHECK(~~f.diagram == f.diagram);
+		CHECK((f.diagram ^ f.diagram) == zero);
+		CHECK((f.diagram & g.diagram) == (g.diagram & f.diagram));
+		CHECK(~(f.diagram & g.diagram) == (~f.diagram | ~g.diagram));
+		CHECK(~(f.diagram | g.diagram) == (~f.diagram & ~g.diagram));
+		CHECK((f.diagram ^ g.diagram) == ((f.diagram - g.diagram) | (g.diagram - f.diagram)));
+
+		if (!f.diagram.is_zero())
+		{
+			unsigned int assignment = 0;
+			std::vector<bool> picked = f.diagram.pick_one();
+
+			for (unsigned int v = 0; v < NB_VARS; ++v)
+				assignment |= (unsigned int)picked[v] << v;
+			CHECK((f.table >> assignment) & 1);
+		}
+	}
+}
+
+static void check_quantification(bdd_manager &manager, std::mt19937 &generator)
+{
+	unsigned int mask;
+	std::vector<unsigned int> vars;
+
+	for (unsigned int k = 0; k < 200; ++k)
+	{
+		formula f = random_formula(manager, generator, 3);
+		formula g = random_formula(manager, generator, 2);
+
+		mask = generator()%NB_ASSIGNMENTS;
+		vars.clear();
+		for (unsigned int v = 0; v < NB_VARS; ++v)
+		{
+			if ((mask >> v) & 1)
+				vars.push_back(v);
+		}
+
+		bdd cube = bdd::cube(manager, vars);
+
+		CHECK(table_of(manager, f.diagram.exists(cube)) == exists_table(f.table, mask));
+		CHECK(f.diagram.and_exists(g.diagram, cube) == (f.diagram & g.diagram).exists(cube));
+		CHECK(table_of(manager, f.diagram.and_exists(g.diagram, cube))
+		      == exists_table(f.table & g.table, mask));
+	}
+}
+
+/**
+ * The variables are interleaved as in a transition relation, x_i = 2i and y_i = 2i+1: the
+ * functions over the x variables are renamed on the y variables, and back.
+*/
+static void check_renaming(bdd_manager &manager, std::mt19937 &generator)
+{
+	unsigned int x_to_y, y_to_x, renamed;
+	std::vector<unsigned int> mapping(NB_VARS), x_vars, y_vars;
+	truth_table t;
+
+	for (unsigned int v = 0; v < NB_VARS; ++v)
+		mapping[v] = v%2 == 0 ? v+1 : v;
+	x_to_y = manager.add_renaming(mapping);
+
+	for (unsigned int v = 0; v < NB_VARS; ++v)
+	{
+		mapping[v] = v%2 == 1 ? v-1 : v;
+		(v%2 == 0 ? x_vars : y_vars).push_back(v);
+	}
+	y_to_x = manager.add_renaming(mapping);
+
+	bdd x_cube = bdd::cube(manager, x_vars);
+	bdd y_cube = bdd::cube(manager, y_vars);
+
+	for (unsigned int k = 0; k < 200; ++k)
+	{
+		formula f = random_formula(manager, generator, 3);
+
+		// Only keeping the x variables
+		f.diagram = f.diagram.exists(y_cube);
+		f.table = exists_table(f.table, 0x2a);
+
+		t = 0;
+		for (unsigned int i = 0; i < NB_ASSIGNMENTS; ++i)
+		{
+			renamed = 0;
+			for (unsigned int v = 1; v < NB_VARS; v += 2)
+				renamed |= ((i >> v) & 1) << (v-1);
+
+			if ((f.table >> renamed) & 1)
+				t |= truth_table(1) << i;
+		}
+
+		bdd g = f.diagram.rename(x_to_y);
+
+		CHECK(table_of(manager, g) == t);
+		CHECK(g.exists(x_cube) == g);
+		CHECK(g.rename(y_to_x) == f.diagram);
+	}
+}
+
+int main(void)
+{
+	std::mt19937 generator(42);
+
+	// A small threshold, so that the garbage collection runs during the checks
+	bdd_manager manager(NB_VARS, 8, 64);
+
+	check_identities(manager, generator);
+	check_quantification(manager, generator);
+	check_renaming(manager, generator);
+
+	CHECK(manager.gc_runs() > 0);
+
+	return nb_failures();
+}
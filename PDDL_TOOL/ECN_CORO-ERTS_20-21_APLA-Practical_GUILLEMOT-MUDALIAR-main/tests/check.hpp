@@ -0,0 +1,31 @@
+#ifndef CHECK_HPP
+#define CHECK_HPP
+
+#include <cstdio>
+
+/**
+ * Checks of the test programs. A failed check is reported with its location and the test goes
+ * on, the program failing at the end if any check failed (see nb_failures()).
+*/
+static unsigned int failures = 0;
+
+#define CHECK(cond) \
+	do \
+	{ \
+		if (!(cond)) \
+		{ \
+			failures++; \
+			std::fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+		} \
+	} while (0)
+
+// @return The exit status of the test program
+static inline int nb_failures(void)
+{
+	if (failures > 0)
+		std::fprintf(stderr, "%u check(s) failed\n", failures);
+
+	return failures > 0;
+}
+
+#endif // CHECK_HPP
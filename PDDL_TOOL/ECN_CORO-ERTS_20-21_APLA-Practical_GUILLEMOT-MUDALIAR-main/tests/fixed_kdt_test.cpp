@@ -0,0 +1,142 @@
+#include "../data_structures/fixed_kdt.hpp"
+#include "check.hpp"
+
+#include <array>
+#include <random>
+#include <set>
+#include <vector>
+
+/**
+ * The copies of a fixed_kdt share their nodes: the trees are modified independently from the
+ * copies and checked against a reference std::set each, so that a node modified in place while
+ * still shared, or released while still referenced, shows up in another version of the tree.
+*/
+#define DOMAIN_SIZE 4
+
+template<unsigned int K> struct version
+{
+	fixed_kdt<K, int> tree;
+	std::set<std::array<int, K>> reference;
+};
+
+template<unsigned int K> bool same_values(const fixed_kdt<K, int> &tree, const std::set<std::array<int, K>> &reference)
+{
+	std::set<std::array<int, K>> values;
+	unsigned int nb_values = 0;
+
+	tree.for_each([&values, &nb_values](const std::array<int, K> &a) { values.insert(a); nb_values++; });
+
+	if (tree.size() != reference.size() || nb_values != reference.size() || values != reference)
+		return false;
+
+	// The ranks follow the order of for_each()
+	nb_values = 0;
+	tree.for_each([&tree, &nb_values](const std::array<int, K> &a) { nb_values += (tree.at(nb_values) == a); });
+
+	return nb_values == reference.size();
+}
+
+template<unsigned int K> std::array<int, K> random_value(std::mt19937 &generator)
+{
+	std::array<int, K> to_return;
+
+	for (unsigned int i = 0; i < K; ++i)
+		to_return[i] = generator()%DOMAIN_SIZE;
+
+	return to_return;
+}
+
+/**
+ * Erasing a node without left child moves its right subtree to the left. The chains of
+ * increasing values only have right children, the erasures are done on a copy sharing them.
+*/
+static void check_erase_right_subtree(void)
+{
+	fixed_kdt<1, int> tree;
+	std::set<std::array<int, 1>> values = {{1}, {2}, {3}, {4}};
+
+	for (const std::array<int, 1> &v : values)
+		tree.insert(v);
+
+	fixed_kdt<1, int> copy(tree);
+
+	// At the root, then below it
+	CHECK(copy.erase(std::array<int, 1>{1}) == 0);
+	CHECK(same_values<1>(copy, {{2}, {3}, {4}}));
+	CHECK(same_values<1>(tree, values));
+
+	CHECK(tree.erase(std::array<int, 1>{2}) == 0);
+	CHECK(same_values<1>(tree, {{1}, {3}, {4}}));
+	CHECK(same_values<1>(copy, {{2}, {3}, {4}}));
+
+	CHECK(copy.insert(std::array<int, 1>{0}) == 0);
+	CHECK(copy.erase(std::array<int, 1>{3}) == 0);
+	CHECK(same_values<1>(copy, {{0}, {2}, {4}}));
+	CHECK(same_values<1>(tree, {{1}, {3}, {4}}));
+
+	// Two dimensions: the moved subtree keeps its splitting dimension
+	fixed_kdt<2, int> plane;
+	std::set<std::array<int, 2>> points = {{0, 0}, {1, 3}, {2, 1}, {2, 2}, {3, 0}};
+
+	for (const std::array<int, 2> &p : points)
+		plane.insert(p);
+
+	fixed_kdt<2, int> plane_copy(plane);
+
+	CHECK(plane_copy.erase(std::array<int, 2>{0, 0}) == 0);
+	CHECK(same_values<2>(plane_copy, {{1, 3}, {2, 1}, {2, 2}, {3, 0}}));
+	CHECK(same_values<2>(plane, points));
+	CHECK(plane_copy.contains(std::array<int, 2>{2, 1}) && !plane_copy.contains(std::array<int, 2>{0, 0}));
+	CHECK(plane.contains(std::array<int, 2>{0, 0}));
+}
+
+/**
+ * A pool of versions: each step copies a random version, modifies the copy with a few random
+ * insertions and erasures, and sometimes modifies the original as well or drops a version.
+*/
+template<unsigned int K> void check_versions(std::mt19937 &generator)
+{
+	std::vector<version<K>> versions(1);
+	std::array<int, K> value;
+	unsigned int chosen;
+
+	for (unsigned int step = 0; step < 800; ++step)
+	{
+		chosen = generator()%versions.size();
+		versions.push_back(versions[chosen]);
+
+		for (unsigned int op = 0; op < 4; ++op)
+		{
+			version<K> &v = (op%2 == 1 && generator()%2 ? versions[chosen] : versions.back());
+
+			value = random_value<K>(generator);
+			if (generator()%5 < 3)
+				CHECK(v.tree.insert(value) == !v.reference.insert(value).second);
+			else
+				CHECK(v.tree.erase(value) == !v.reference.erase(value));
+		}
+
+		if (versions.size() > 12)
+			versions.erase(versions.begin()+generator()%versions.size());
+
+		// A frozen version is thawed by its next modification
+		if (generator()%10 == 0)
+			versions[generator()%versions.size()].tree.freeze();
+
+		for (const version<K> &v : versions)
+			CHECK(same_values<K>(v.tree, v.reference));
+	}
+}
+
+int main(void)
+{
+	std::mt19937 generator(3);
+
+	check_erase_right_subtree();
+	check_versions<1>(generator);
+	check_versions<2>(generator);
+	check_versions<3>(generator);
+	check_versions<4>(generator);
+
+	return nb_failures();
+}
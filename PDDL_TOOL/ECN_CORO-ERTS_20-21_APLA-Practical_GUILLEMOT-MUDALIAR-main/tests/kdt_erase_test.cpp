@@ -0,0 +1,144 @@
+#include "../data_structures/kdt.hpp"
+#include "../data_structures/tuple.hpp"
+#include "check.hpp"
+
+#include <algorithm>
+#include <array>
+#include <set>
+#include <vector>
+
+/**
+ * Erasures in the KD-tree of dimension chosen at run time. A node is erased by replacing its
+ * value with the greatest value of a subtree on its splitting dimension, so the values stay
+ * on the side of each node given by its splitting dimension, the parent links and the sizes
+ * of the subtrees stay right, and every value left is still found by contains().
+*/
+typedef std::array<int, 2> point;
+
+static tuple<int> to_tuple(const point &p)
+{
+	return tuple<int>({p[0], p[1]});
+}
+
+static bool same_values(kdt<tuple, int> &tree, const std::set<point> &reference)
+{
+	std::set<point> values;
+	unsigned int nb_values = 0, rank = 0;
+
+	if (tree.size() != reference.size())
+		return false;
+
+	for (const point &p : reference)
+	{
+		if (!tree.contains(to_tuple(p)))
+			return false;
+	}
+
+	tree.for_each([&values, &nb_values](const tuple<int> &t) { values.insert({t[0], t[1]}); nb_values++; });
+
+	if (nb_values != reference.size() || values != reference)
+		return false;
+
+	// The parent links, through the iterator, and the sizes of the subtrees, through at()
+	for (kdt<tuple, int>::iterator it = tree.begin(); it != tree.end(); ++it)
+	{
+		if (rank >= tree.size() || !(tree.at(rank) == *it))
+			return false;
+		rank++;
+	}
+
+	return rank == reference.size();
+}
+
+/**
+ * The root (5, 5) has a lone left child (3, 8), which splits on the second dimension and has
+ * a left child (4, 2). Promoting (3, 8) in place of the root would leave (4, 2) on the left of
+ * a node splitting on the first dimension with a lower value, where contains() misses it.
+*/
+static void check_lone_child(void)
+{
+	kdt<tuple, int> tree(2);
+	std::set<point> reference = {{5, 5}, {3, 8}, {4, 2}};
+
+	for (const point &p : {point{5, 5}, point{3, 8}, point{4, 2}})
+		tree.insert(to_tuple(p));
+
+	CHECK(tree.erase(to_tuple({5, 5})) == 0);
+	reference.erase({5, 5});
+	CHECK(same_values(tree, reference));
+
+	// A lone right child is moved to the left
+	kdt<tuple, int> right(2);
+
+	for (const point &p : {point{1, 1}, point{3, 0}, point{2, 5}, point{4, 4}})
+		right.insert(to_tuple(p));
+
+	CHECK(right.erase(to_tuple({1, 1})) == 0);
+	CHECK(same_values(right, {{3, 0}, {2, 5}, {4, 4}}));
+}
+
+// Erasing a node with two children, whose replacement is deep in its left subtree
+static void check_two_children(void)
+{
+	kdt<tuple, int> tree(2);
+	std::set<point> reference = {{5, 5}, {2, 7}, {8, 1}, {1, 9}, {4, 3}, {3, 6}, {7, 2}, {9, 9}};
+
+	for (const point &p : {point{5, 5}, point{2, 7}, point{8, 1}, point{1, 9}, point{4, 3},
+			       point{3, 6}, point{7, 2}, point{9, 9}})
+		tree.insert(to_tuple(p));
+
+	CHECK(same_values(tree, reference));
+
+	CHECK(tree.erase(to_tuple({5, 5})) == 0);
+	reference.erase({5, 5});
+	CHECK(same_values(tree, reference));
+
+	CHECK(tree.erase(to_tuple({2, 7})) == 0);
+	reference.erase({2, 7});
+	CHECK(same_values(tree, reference));
+
+	CHECK(tree.erase(to_tuple({2, 7})) == 1);
+	CHECK(same_values(tree, reference));
+}
+
+/**
+ * Every insertion order of a few points with ties on both dimensions, and for each of them
+ * every erasure order.
+*/
+static void check_all_orders(void)
+{
+	std::vector<point> points = {{0, 1}, {1, 1}, {1, 2}, {1, 3}, {2, 2}};
+	std::vector<unsigned int> order;
+
+	do
+	{
+		order = {0, 1, 2, 3, 4};
+
+		do
+		{
+			kdt<tuple, int> tree(2);
+			std::set<point> reference(points.begin(), points.end());
+
+			for (const point &p : points)
+				tree.insert(to_tuple(p));
+
+			for (unsigned int i : order)
+			{
+				CHECK(tree.erase(to_tuple(points[i])) == 0);
+				reference.erase(points[i]);
+				CHECK(same_values(tree, reference));
+			}
+		}
+		while (std::next_permutation(order.begin(), order.end()));
+	}
+	while (std::next_permutation(points.begin(), points.end()));
+}
+
+int main(void)
+{
+	check_lone_child();
+	check_two_children();
+	check_all_orders();
+
+	return nb_failures();
+}
@@ -0,0 +1,193 @@
+#include "../data_structures/fixed_kdt.hpp"
+#include "../data_structures/frozen_kdt.hpp"
+#include "../data_structures/kdt.hpp"
+#include "../data_structures/kdt_range.hpp"
+#include "../data_structures/tuple.hpp"
+#include "check.hpp"
+
+#include <algorithm>
+#include <array>
+#include <random>
+#include <set>
+#include <vector>
+
+/**
+ * The partial-match and range queries of kdt, fixed_kdt and frozen_kdt are checked against a
+ * scan of a std::set holding the same values, while values are inserted and erased at random.
+ * The components are taken in a small domain, so that the erasures often hit a value of the
+ * tree and the bound components match many values.
+*/
+#define DOMAIN_SIZE 5
+
+/**
+ * Random range over K components, each one free, bound to a value, or bounded by an interval
+ * with possibly open sides. The bounds are stored in bounds, which must outlive the range.
+*/
+template<unsigned int K> kdt_range<int> random_range(std::mt19937 &generator, std::array<int, 2*K> &bounds)
+{
+	kdt_range<int> to_return(K);
+
+	for (unsigned int i = 0; i < K; ++i)
+	{
+		bounds[2*i] = generator()%DOMAIN_SIZE;
+		bounds[2*i+1] = bounds[2*i]+generator()%3;
+
+		switch (generator()%4)
+		{
+			case 0:
+				break;
+			case 1:
+				to_return.bind(i, bounds[2*i]);
+				break;
+			case 2:
+				to_return.bound(i, &bounds[2*i], &bounds[2*i+1]);
+				break;
+			default:
+				to_return.bound(i, generator()%2 ? &bounds[2*i] : nullptr,
+						generator()%2 ? &bounds[2*i+1] : nullptr);
+				break;
+		}
+	}
+
+	return to_return;
+}
+
+template<unsigned int K> std::vector<std::array<int, K>> expected(const std::set<std::array<int, K>> &reference,
+								  const kdt_range<int> &range)
+{
+	std::vector<std::array<int, K>> to_return;
+
+	for (const std::array<int, K> &value : reference)
+	{
+		if (range.contains(value))
+			to_return.push_back(value);
+	}
+
+	return to_return;
+}
+
+template<unsigned int K> std::array<int, K> random_value(std::mt19937 &generator)
+{
+	std::array<int, K> to_return;
+
+	for (unsigned int i = 0; i < K; ++i)
+		to_return[i] = generator()%DOMAIN_SIZE;
+
+	return to_return;
+}
+
+// Sorts the values found by a query, a value found twice is kept twice
+template<unsigned int K> std::vector<std::array<int, K>> sorted(std::vector<std::array<int, K>> values)
+{
+	std::sort(values.begin(), values.end());
+	return values;
+}
+
+template<unsigned int K> void check_kdt(std::mt19937 &generator)
+{
+	kdt<tuple, int> tree(K);
+	std::set<std::array<int, K>> reference;
+	std::array<int, K> value;
+	std::array<int, 2*K> bounds;
+
+	for (unsigned int op = 0; op < 3000; ++op)
+	{
+		value = random_value<K>(generator);
+
+		if (generator()%5 < 3)
+			CHECK(tree.insert(tuple<int>(value)) == !reference.insert(value).second);
+		else
+			CHECK(tree.erase(tuple<int>(value)) == !reference.erase(value));
+
+		CHECK(tree.size() == reference.size());
+
+		for (unsigned int q = 0; q < 3; ++q)
+		{
+			kdt_range<int> range = random_range<K>(generator, bounds);
+			std::vector<std::array<int, K>> found;
+
+			tree.match(range, [&found](const tuple<int> &t)
+				{
+					std::array<int, K> a;
+					for (unsigned int i = 0; i < K; ++i)
+						a[i] = t[i];
+					found.push_back(a);
+				});
+
+			CHECK(sorted<K>(found) == expected<K>(reference, range));
+		}
+	}
+}
+
+/**
+ * The values are inserted and erased in two fixed_kdt: one is never frozen, the other one is
+ * frozen regularly, so that it is queried as a frozen_kdt and then thawed by the next
+ * modification. A frozen_kdt is also built from the reference values.
+*/
+template<unsigned int K> void check_fixed_kdt(std::mt19937 &generator)
+{
+	fixed_kdt<K, int> tree, frozen;
+	std::set<std::array<int, K>> reference;
+	std::array<int, K> value;
+	std::array<int, 2*K> bounds;
+	bool inserted, erased;
+
+	for (unsigned int op = 0; op < 3000; ++op)
+	{
+		value = random_value<K>(generator);
+
+		if (generator()%5 < 3)
+		{
+			inserted = reference.insert(value).second;
+			CHECK(tree.insert(value) == !inserted);
+			CHECK(frozen.insert(value) == !inserted);
+		}
+		else
+		{
+			erased = reference.erase(value);
+			CHECK(tree.erase(value) == !erased);
+			CHECK(frozen.erase(value) == !erased);
+		}
+
+		if (op%20 == 0)
+			frozen.freeze();
+
+		CHECK(tree.size() == reference.size());
+		CHECK(frozen.size() == reference.size());
+
+		frozen_kdt<K, int> bulk(std::vector<std::array<int, K>>(reference.begin(), reference.end()));
+
+		for (unsigned int q = 0; q < 3; ++q)
+		{
+			kdt_range<int> range = random_range<K>(generator, bounds);
+			std::vector<std::array<int, K>> found[3];
+			std::vector<std::array<int, K>> wanted = expected<K>(reference, range);
+
+			tree.match(range, [&found](const std::array<int, K> &a) { found[0].push_back(a); });
+			frozen.match(range, [&found](const std::array<int, K> &a) { found[1].push_back(a); });
+			bulk.match(range, [&found](const std::array<int, K> &a) { found[2].push_back(a); });
+
+			CHECK(sorted<K>(found[0]) == wanted);
+			CHECK(sorted<K>(found[1]) == wanted);
+			CHECK(sorted<K>(found[2]) == wanted);
+		}
+	}
+}
+
+int main(void)
+{
+	std::mt19937 generator(1);
+
+	check_kdt<1>(generator);
+	check_kdt<3>(generator);
+
+	// Longer than the values stored inline in a tuple
+	check_kdt<5>(generator);
+
+	check_fixed_kdt<1>(generator);
+	check_fixed_kdt<2>(generator);
+	check_fixed_kdt<3>(generator);
+	check_fixed_kdt<4>(generator);
+
+	return nb_failures();
+}
@@ -0,0 +1,298 @@
+#include "../planning_problem/domain.hpp"
+#include "../planning_problem/ground_task.hpp"
+#include "../planning_problem/problem.hpp"
+#include "../planning_problem/sas_encoding.hpp"
+#include "check.hpp"
+
+#include <cstdint>
+#include <deque>
+#include <set>
+#include <string>
+#include <vector>
+
+/**
+ * Every state reachable from the initial state of a task is enumerated with the bitset encoding
+ * of ground_task, and checked against the finite-domain encoding:
+ *	- decoding the encoded state gives back its facts,
+ *	- the facts hold in both encodings alike, and the goal test agrees,
+ *	- each action is applicable in both encodings alike, and applying it to the encoded state
+ *	  gives the encoding of the successor computed by ground_task.
+*/
+typedef triplet<symbol, bool, std::vector<symbol>> literal;
+
+static std::string name(const char *prefix, unsigned int i)
+{
+	return prefix+std::to_string(i);
+}
+
+static void check_task(const problem &prob)
+{
+	ground_task task(prob);
+	sas_encoding encoding(prob, task);
+	std::vector<unsigned char> source(task.state_bytes()), target(task.state_bytes());
+	std::vector<std::uint64_t> words(encoding.nb_words()), successor(encoding.nb_words());
+	std::set<std::vector<unsigned int>> visited;
+	std::deque<std::vector<unsigned int>> open;
+	std::vector<unsigned int> facts;
+	bool applicable;
+
+	CHECK(encoding.nb_bits() <= 64*encoding.nb_words());
+	CHECK(encoding.nb_bits() < task.nb_facts());
+
+	visited.insert(task.init());
+	open.push_back(task.init());
+
+	while (!open.empty())
+	{
+		facts = open.front();
+		open.pop_front();
+
+		task.encode(facts, source.data());
+		encoding.encode(facts, words.data());
+
+		CHECK(encoding.decode(words.data()) == facts);
+		CHECK(encoding.is_goal(words.data()) == task.is_goal(source.data()));
+		CHECK(encoding.nb_unsatisfied_goals(words.data()) == task.nb_unsatisfied_goals(source.data()));
+
+		for (unsigned int f = 0; f < task.nb_facts(); ++f)
+			CHECK(encoding.holds(f, words.data()) == task.holds(f, source.data()));
+
+		for (unsigned int a = 0; a < task.nb_actions(); ++a)
+		{
+			applicable = task.applicable(a, source.data());
+
+			CHECK(encoding.applicable(a, words.data()) == applicable);
+			CHECK(task.apply(a, source.data(), target.data()) == applicable);
+			CHECK(encoding.apply(a, words.data(), successor.data()) == applicable);
+
+			if (!applicable)
+				continue;
+
+			std::vector<unsigned int> next = task.decode(target.data());
+
+			CHECK(encoding.decode(successor.data()) == next);
+
+			// In place, as done by the search engines
+			std::vector<std::uint64_t> in_place(words);
+			encoding.apply(a, in_place.data(), in_place.data());
+			CHECK(in_place == successor);
+
+			if (visited.insert(next).second)
+				open.push_back(next);
+		}
+	}
+
+	CHECK(visited.size() > 1);
+}
+
+// Blocksworld, a tower of nb_blocks blocks to reverse
+static void check_blocksworld(unsigned int nb_blocks)
+{
+	domain dom("blocksworld");
+
+	dom.add_predicate("on", 2);
+	dom.add_predicate("ontable", 1);
+	dom.add_predicate("clear", 1);
+	dom.add_predicate("handempty", 0);
+	dom.add_predicate("holding", 1);
+
+	dom.add_action("pick-up");
+	dom.add_action_param("pick-up", "x");
+	dom.add_action_precond("pick-up", "clear", false, {"x"});
+	dom.add_action_precond("pick-up", "ontable", false, {"x"});
+	dom.add_action_precond("pick-up", "handempty", false, {});
+	dom.add_action_effect("pick-up", "ontable", true, {"x"});
+	dom.add_action_effect("pick-up", "clear", true, {"x"});
+	dom.add_action_effect("pick-up", "handempty", true, {});
+	dom.add_action_effect("pick-up", "holding", false, {"x"});
+
+	dom.add_action("put-down");
+	dom.add_action_param("put-down", "x");
+	dom.add_action_precond("put-down", "holding", false, {"x"});
+	dom.add_action_effect("put-down", "holding", true, {"x"});
+	dom.add_action_effect("put-down", "clear", false, {"x"});
+	dom.add_action_effect("put-down", "handempty", false, {});
+	dom.add_action_effect("put-down", "ontable", false, {"x"});
+
+	dom.add_action("stack");
+	dom.add_action_param("stack", "x");
+	dom.add_action_param("stack", "y");
+	dom.add_action_precond("stack", "holding", false, {"x"});
+	dom.add_action_precond("stack", "clear", false, {"y"});
+	dom.add_action_effect("stack", "holding", true, {"x"});
+	dom.add_action_effect("stack", "clear", true, {"y"});
+	dom.add_action_effect("stack", "clear", false, {"x"});
+	dom.add_action_effect("stack", "handempty", false, {});
+	dom.add_action_effect("stack", "on", false, {"x", "y"});
+
+	dom.add_action("unstack");
+	dom.add_action_param("unstack", "x");
+	dom.add_action_param("unstack", "y");
+	dom.add_action_precond("unstack", "on", false, {"x", "y"});
+	dom.add_action_precond("unstack", "clear", false, {"x"});
+	dom.add_action_precond("unstack", "handempty", false, {});
+	dom.add_action_effect("unstack", "holding", false, {"x"});
+	dom.add_action_effect("unstack", "clear", false, {"y"});
+	dom.add_action_effect("unstack", "clear", true, {"x"});
+	dom.add_action_effect("unstack", "handempty", true, {});
+	dom.add_action_effect("unstack", "on", true, {"x", "y"});
+
+	problem prob(&dom);
+
+	for (unsigned int i = 0; i < nb_blocks; ++i)
+		prob.add_object(name("b", i));
+
+	prob.ground_init("handempty", tuple<symbol>());
+	prob.ground_init("clear", {name("b", 0)});
+	prob.ground_init("ontable", {name("b", nb_blocks-1)});
+
+	for (unsigned int i = 0; i+1 < nb_blocks; ++i)
+	{
+		prob.ground_init("on", {name("b", i), name("b", i+1)});
+		prob.ground_final("on", {name("b", i+1), name("b", i)});
+	}
+
+	check_task(prob);
+}
+
+/**
+ * Robots carrying balls between the rooms of a corridor, one ball at a time. A robot may also
+ * switch the light of its room, a conditional effect on each side.
+*/
+static void check_robots(unsigned int nb_robots, unsigned int nb_balls, unsigned int nb_rooms)
+{
+	domain dom("robots");
+
+	dom.add_predicate("at-robot", 2);
+	dom.add_predicate("at-ball", 2);
+	dom.add_predicate("carry", 2);
+	dom.add_predicate("free", 1);
+	dom.add_predicate("connected", 2);
+	dom.add_predicate("lit", 1);
+
+	dom.add_action("move");
+	dom.add_action_param("move", "r");
+	dom.add_action_param("move", "x");
+	dom.add_action_param("move", "y");
+	dom.add_action_precond("move", "at-robot", false, {"r", "x"});
+	dom.add_action_precond("move", "connected", false, {"x", "y"});
+	dom.add_action_effect("move", "at-robot", true, {"r", "x"});
+	dom.add_action_effect("move", "at-robot", false, {"r", "y"});
+
+	dom.add_action("pick");
+	dom.add_action_param("pick", "r");
+	dom.add_action_param("pick", "b");
+	dom.add_action_param("pick", "x");
+	dom.add_action_precond("pick", "at-robot", false, {"r", "x"});
+	dom.add_action_precond("pick", "at-ball", false, {"b", "x"});
+	dom.add_action_precond("pick", "free", false, {"r"});
+	dom.add_action_effect("pick", "at-ball", true, {"b", "x"});
+	dom.add_action_effect("pick", "free", true, {"r"});
+	dom.add_action_effect("pick", "carry", false, {"r", "b"});
+
+	dom.add_action("drop");
+	dom.add_action_param("drop", "r");
+	dom.add_action_param("drop", "b");
+	dom.add_action_param("drop", "x");
+	dom.add_action_precond("drop", "at-robot", false, {"r", "x"});
+	dom.add_action_precond("drop", "carry", false, {"r", "b"});
+	dom.add_action_effect("drop", "carry", true, {"r", "b"});
+	dom.add_action_effect("drop", "free", false, {"r"});
+	dom.add_action_effect("drop", "at-ball", false, {"b", "x"});
+
+	dom.add_action("switch");
+	dom.add_action_param("switch", "r");
+	dom.add_action_param("switch", "x");
+	dom.add_action_precond("switch", "at-robot", false, {"r", "x"});
+	dom.add_action_cond_effect("switch", {literal("lit", false, {"x"})}, {literal("lit", true, {"x"})});
+	dom.add_action_cond_effect("switch", {literal("lit", true, {"x"})}, {literal("lit", false, {"x"})});
+
+	problem prob(&dom);
+
+	for (unsigned int i = 0; i < nb_robots; ++i)
+		prob.add_object(name("r", i));
+	for (unsigned int i = 0; i < nb_balls; ++i)
+		prob.add_object(name("ball", i));
+	for (unsigned int i = 0; i < nb_rooms; ++i)
+		prob.add_object(name("rm", i));
+
+	for (unsigned int i = 0; i+1 < nb_rooms; ++i)
+	{
+		prob.ground_init("connected", {name("rm", i), name("rm", i+1)});
+		prob.ground_init("connected", {name("rm", i+1), name("rm", i)});
+	}
+
+	for (unsigned int i = 0; i < nb_robots; ++i)
+	{
+		prob.ground_init("at-robot", {name("r", i), name("rm", 0)});
+		prob.ground_init("free", {name("r", i)});
+	}
+
+	for (unsigned int i = 0; i < nb_balls; ++i)
+	{
+		prob.ground_init("at-ball", {name("ball", i), name("rm", 0)});
+		prob.ground_final("at-ball", {name("ball", i), name("rm", nb_rooms-1)});
+	}
+
+	prob.ground_final("lit", {name("rm", nb_rooms-1)});
+
+	check_task(prob);
+}
+
+// The rooms of main.cpp, whose doors are opened by the agent
+static void check_rooms(void)
+{
+	domain dom("rooms");
+
+	dom.add_predicate("isIn", 1);
+	dom.add_predicate("connected", 2);
+	dom.add_predicate("adjacent", 2);
+
+	dom.add_action("move");
+	dom.add_action_param("move", "x");
+	dom.add_action_param("move", "y");
+	dom.add_action_precond("move", "isIn", false, {"x"});
+	dom.add_action_precond("move", "connected", false, {"x", "y"});
+	dom.add_action_effect("move", "isIn", false, {"y"});
+	dom.add_action_effect("move", "isIn", true, {"x"});
+
+	dom.add_action("open");
+	dom.set_action_cost("open", 3);
+	dom.add_action_param("open", "x");
+	dom.add_action_param("open", "y");
+	dom.add_action_precond("open", "isIn", false, {"x"});
+	dom.add_action_precond("open", "adjacent", false, {"x", "y"});
+	dom.add_action_precond("open", "connected", true, {"x", "y"});
+	dom.add_action_effect("open", "connected", false, {"x", "y"});
+	dom.add_action_effect("open", "connected", false, {"y", "x"});
+
+	problem prob(&dom);
+	const std::vector<std::vector<symbol>> connected = {{"rm0", "rm1"}, {"rm1", "rm0"}, {"rm1", "rm3"},
+							    {"rm2", "rm3"}, {"rm3", "rm1"}, {"rm3", "rm2"}};
+	const std::vector<std::vector<symbol>> adjacent = {{"rm0", "rm1"}, {"rm0", "rm2"}, {"rm1", "rm0"},
+							   {"rm1", "rm3"}, {"rm2", "rm0"}, {"rm2", "rm3"},
+							   {"rm3", "rm1"}, {"rm3", "rm2"}};
+
+	for (unsigned int i = 0; i < 4; ++i)
+		prob.add_object(name("rm", i));
+
+	prob.ground_init("isIn", {"rm0"});
+	for (const std::vector<symbol> &c : connected)
+		prob.ground_init("connected", tuple<symbol>(c));
+	for (const std::vector<symbol> &a : adjacent)
+		prob.ground_init("adjacent", tuple<symbol>(a));
+	prob.ground_final("isIn", {"rm2"});
+
+	check_task(prob);
+}
+
+int main(void)
+{
+	check_blocksworld(3);
+	check_blocksworld(5);
+	check_robots(1, 2, 3);
+	check_robots(2, 2, 3);
+	check_rooms();
+
+	return nb_failures();
+}
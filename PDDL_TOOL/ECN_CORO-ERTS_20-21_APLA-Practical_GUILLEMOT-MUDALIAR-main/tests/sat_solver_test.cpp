@@ -0,0 +1,218 @@
+#include "../data_structures/sat_solver.hpp"
+#include "check.hpp"
+
+#include <random>
+#include <vector>
+
+typedef std::vector<std::vector<unsigned int>> cnf;
+
+static bool satisfies(const cnf &clauses, const std::vector<bool> &assignment)
+{
+	bool satisfied;
+
+	for (const std::vector<unsigned int> &clause : clauses)
+	{
+		satisfied = false;
+		for (unsigned int lit : clause)
+		{
+			if (assignment[lit/2] == (lit%2 == 0))
+			{
+				satisfied = true;
+				break;
+			}
+		}
+
+		if (!satisfied)
+			return false;
+	}
+
+	return true;
+}
+
+// Satisfiability of the clauses and the assumptions by enumerating the assignments
+static bool brute_force(const cnf &clauses, const std::vector<unsigned int> &assumptions, unsigned int nb_vars)
+{
+	cnf all(clauses);
+	std::vector<bool> assignment(nb_vars);
+
+	for (unsigned int lit : assumptions)
+		all.push_back({lit});
+
+	for (unsigned int i = 0; i < (1u << nb_vars); ++i)
+	{
+		for (unsigned int v = 0; v < nb_vars; ++v)
+			assignment[v] = (i >> v) & 1;
+
+		if (satisfies(all, assignment))
+			return true;
+	}
+
+	return false;
+}
+
+static std::vector<bool> model(const sat_solver &solver)
+{
+	std::vector<bool> to_return(solver.nb_vars());
+
+	for (unsigned int v = 0; v < solver.nb_vars(); ++v)
+		to_return[v] = solver.model_value(v);
+
+	return to_return;
+}
+
+static std::vector<unsigned int> random_clause(std::mt19937 &generator, unsigned int nb_vars, unsigned int size)
+{
+	std::vector<unsigned int> to_return;
+
+	while (to_return.size() < size)
+		to_return.push_back(sat_solver::literal(generator()%nb_vars, generator()%2));
+
+	return to_return;
+}
+
+/**
+ * Pigeonhole principle: p pigeons in h holes, each pigeon in a hole and no two pigeons in the
+ * same hole, unsatisfiable if and only if p > h.
+*/
+static void check_pigeonhole(void)
+{
+	for (unsigned int holes = 1; holes <= 6; ++holes)
+	{
+		for (unsigned int pigeons = holes; pigeons <= holes+1; ++pigeons)
+		{
+			sat_solver solver;
+			cnf clauses;
+			std::vector<unsigned int> clause;
+
+			for (unsigned int v = 0; v < pigeons*holes; ++v)
+				solver.new_var();
+
+			for (unsigned int p = 0; p < pigeons; ++p)
+			{
+				clause.clear();
+				for (unsigned int h = 0; h < holes; ++h)
+					clause.push_back(sat_solver::literal(p*holes+h));
+				clauses.push_back(clause);
+			}
+
+			for (unsigned int h = 0; h < holes; ++h)
+			{
+				for (unsigned int p1 = 0; p1 < pigeons; ++p1)
+				{
+					for (unsigned int p2 = p1+1; p2 < pigeons; ++p2)
+						clauses.push_back({sat_solver::literal(p1*holes+h, false),
+								   sat_solver::literal(p2*holes+h, false)});
+				}
+			}
+
+			for (const std::vector<unsigned int> &c : clauses)
+				solver.add_clause(c);
+
+			if (pigeons > holes)
+				CHECK(!solver.solve());
+			else
+			{
+				CHECK(solver.solve());
+				CHECK(satisfies(clauses, model(solver)));
+			}
+		}
+	}
+}
+
+// Random 3-SAT around the satisfiability threshold, checked against brute force
+static void check_random(std::mt19937 &generator)
+{
+	const unsigned int nb_vars = 12, nb_clauses = 51;
+	unsigned int nb_sat = 0;
+
+	for (unsigned int k = 0; k < 300; ++k)
+	{
+		sat_solver solver;
+		cnf clauses;
+		bool sat;
+
+		for (unsigned int v = 0; v < nb_vars; ++v)
+			solver.new_var();
+
+		for (unsigned int c = 0; c < nb_clauses; ++c)
+		{
+			clauses.push_back(random_clause(generator, nb_vars, 3));
+			solver.add_clause(clauses.back());
+		}
+
+		sat = solver.solve();
+		CHECK(sat == brute_force(clauses, {}, nb_vars));
+
+		if (sat)
+		{
+			CHECK(satisfies(clauses, model(solver)));
+			nb_sat++;
+		}
+	}
+
+	// Both outcomes are covered
+	CHECK(nb_sat > 0 && nb_sat < 300);
+}
+
+/**
+ * Incremental solving: the clauses are added a few at a time, with calls to solve() under
+ * random assumptions in between, the learned clauses being kept from one call to the next.
+*/
+static void check_incremental(std::mt19937 &generator)
+{
+	const unsigned int nb_vars = 10;
+
+	for (unsigned int k = 0; k < 100; ++k)
+	{
+		sat_solver solver;
+		cnf clauses;
+		std::vector<unsigned int> assumptions;
+		bool sat;
+
+		for (unsigned int v = 0; v < nb_vars; ++v)
+			solver.new_var();
+
+		for (unsigned int step = 0; step < 15; ++step)
+		{
+			for (unsigned int c = 0; c < 3; ++c)
+			{
+				clauses.push_back(random_clause(generator, nb_vars, 3));
+				solver.add_clause(clauses.back());
+			}
+
+			for (unsigned int call = 0; call < 3; ++call)
+			{
+				assumptions = random_clause(generator, nb_vars, generator()%4);
+
+				sat = solver.solve(assumptions);
+				CHECK(sat == brute_force(clauses, assumptions, nb_vars));
+
+				if (sat)
+				{
+					std::vector<bool> m = model(solver);
+					cnf units;
+
+					for (unsigned int lit : assumptions)
+						units.push_back({lit});
+
+					CHECK(satisfies(clauses, m));
+					CHECK(satisfies(units, m));
+				}
+			}
+
+			// Without assumptions, the clauses alone
+			CHECK(solver.solve() == brute_force(clauses, {}, nb_vars));
+		}
+	}
+}
+
+int main(void)
+{
+	std::mt19937 generator(7);
+
+	check_pigeonhole();
+	check_random(generator);
+	check_incremental(generator);
+
+	return nb_failures();
+}
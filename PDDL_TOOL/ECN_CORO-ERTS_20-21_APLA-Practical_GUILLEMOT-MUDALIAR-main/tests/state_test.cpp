@@ -0,0 +1,124 @@
+#include "../planning_problem/state.hpp"
+#include "check.hpp"
+
+#include <random>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * The copies of a state share the nodes of their KD-trees: a state is copied, both copies are
+ * modified, and each one is checked against its own reference set of grounded predicates.
+ * The trees have every arity, from the 0-arity predicates to a tree of dimension chosen at
+ * run time, and are iterated frozen or not.
+*/
+typedef std::set<std::pair<unsigned int, std::vector<symbol>>> atom_set;
+
+static const std::vector<unsigned int> dimensions = {1, 1, 2, 3, 4, 5};
+static const std::vector<symbol> objects = {"a", "b", "c"};
+
+static std::pair<unsigned int, std::vector<symbol>> random_atom(std::mt19937 &generator)
+{
+	unsigned int index = generator()%dimensions.size();
+	std::vector<symbol> params(index == 0 ? 0 : dimensions[index]);
+
+	for (symbol &p : params)
+		p = objects[generator()%objects.size()];
+
+	return {index, params};
+}
+
+// The iterators also give the predicates in the order of atoms()
+static bool same_atoms(const state &s, const atom_set &reference)
+{
+	atom_set atoms;
+	std::vector<std::pair<unsigned int, tuple<symbol>>> in_order = s.atoms();
+	unsigned int nb_atoms = 0;
+
+	for (const std::pair<unsigned int, params_view> &a : s)
+	{
+		std::vector<symbol> params;
+
+		for (unsigned int i = 0; i < a.second.size(); ++i)
+			params.push_back(a.second[i]);
+
+		if (nb_atoms >= in_order.size() || in_order[nb_atoms].first != a.first
+		    || !(in_order[nb_atoms].second == tuple<symbol>(a.second)) || !s.contains(a.first, a.second))
+			return false;
+
+		atoms.insert({a.first, params});
+		nb_atoms++;
+	}
+
+	if (s.size() != reference.size() || nb_atoms != reference.size() || atoms != reference)
+		return false;
+
+	for (const std::pair<unsigned int, std::vector<symbol>> &a : reference)
+	{
+		if (!s.contains(a.first, tuple<symbol>(a.second)))
+			return false;
+	}
+
+	return true;
+}
+
+static void modify(std::mt19937 &generator, state &s, atom_set &reference)
+{
+	std::pair<unsigned int, std::vector<symbol>> a = random_atom(generator);
+
+	if (generator()%5 < 3)
+	{
+		s.add(a.first, tuple<symbol>(a.second));
+		reference.insert(a);
+	}
+	else if (reference.erase(a))
+		s.erase(a.first, tuple<symbol>(a.second));
+}
+
+int main(void)
+{
+	std::mt19937 generator(5);
+	std::vector<state> states(1, state(dimensions));
+	std::vector<atom_set> references(1);
+	unsigned int chosen;
+
+	for (unsigned int step = 0; step < 500; ++step)
+	{
+		chosen = generator()%states.size();
+		states.push_back(states[chosen]);
+		references.push_back(references[chosen]);
+
+		// Both the copy and the original are modified
+		for (unsigned int op = 0; op < 3; ++op)
+		{
+			modify(generator, states.back(), references.back());
+			modify(generator, states[chosen], references[chosen]);
+		}
+
+		// A frozen state is iterated by rank until its next modification
+		if (generator()%10 == 0)
+			states[generator()%states.size()].freeze();
+
+		if (states.size() > 8)
+		{
+			chosen = generator()%states.size();
+			states.erase(states.begin()+chosen);
+			references.erase(references.begin()+chosen);
+		}
+
+		for (unsigned int i = 0; i < states.size(); ++i)
+		{
+			CHECK(same_atoms(states[i], references[i]));
+
+			for (unsigned int j = 0; j < i; ++j)
+			{
+				CHECK((states[i] == states[j]) == (references[i] == references[j]));
+				if (references[i] == references[j])
+					CHECK(states[i].hash() == states[j].hash());
+			}
+		}
+	}
+
+	return nb_failures();
+}